@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <vector>
+#include "benchmark/benchmark.h"
+#ifdef KONIG_BENCH_BTREE
+#include "absl/container/btree_set.h"
+#endif
+#include "util.hpp"
+#include "AdjacencyTree.hpp"
+#include "AdjacencyBTree.hpp"
+#include "AdjacencyManager.hpp"
+#include "UndirectedGraph.hpp"
+
+/*
+ * Benchmarks of the core structures and of the generators. The sizes go from 2^10 to KONIG_BENCH_MAX_SIZE (2^20 by
+ * default; configure with -DKONIG_BENCH_MAX_SIZE=100000000 for the full range). The structure benchmarks also run on
+ * std::set and, if Abseil is found, on absl::btree_set, as baselines.
+ *
+ * All the benchmarks report items_per_second, where an item is an adjacency (or an edge, for the generators).
+ */
+
+#ifndef KONIG_BENCH_MAX_SIZE
+#define KONIG_BENCH_MAX_SIZE (1 << 20)
+#endif
+
+using namespace konig;
+
+namespace {
+
+    const uint64_t SEED = 42;
+
+    /**
+     * random_adjacencies (function)
+     *
+     * This returns `size` random adjacencies among size / 8 vertices (i.e. with average degree 8), which may repeat.
+     */
+    std::vector<adjacency_t> random_adjacencies(const size_t size, const uint64_t seed = SEED) {
+        random::engine_t engine(seed);
+        const uint64_t vertices_no = std::max<uint64_t>(size / 8, 2);
+
+        std::vector<adjacency_t> adjacencies(size);
+        for (auto& adjacency : adjacencies) {
+            adjacency.first = static_cast<vid_t>(random::bounded(engine, vertices_no));
+            adjacency.second = static_cast<vid_t>(random::bounded(engine, vertices_no));
+        }
+        return adjacencies;
+    }
+
+    std::vector<adjacency_t> sorted_adjacencies(const size_t size) {
+        auto adjacencies = random_adjacencies(size);
+        std::sort(adjacencies.begin(), adjacencies.end());
+        return adjacencies;
+    }
+
+    // The baselines are driven through the interface they share with AdjacencyTree and AdjacencyBTree: insert, find
+    // and erase.
+
+    typedef std::set<adjacency_t> StdSet;
+#ifdef KONIG_BENCH_BTREE
+    typedef absl::btree_set<adjacency_t> BTreeSet;
+#endif
+
+    template<typename layout_t>
+    bool contains(BasicAdjacencyTree<layout_t>& tree, const adjacency_t adjacency) {
+        return tree.has(adjacency);
+    }
+
+    template<typename set_t>
+    bool contains(const set_t& set, const adjacency_t adjacency) {
+        return set.find(adjacency) != set.end();
+    }
+
+    template<typename set_t>
+    void fill(set_t& set, const std::vector<adjacency_t>& adjacencies) {
+        for (const auto& adjacency : adjacencies)
+            set.insert(adjacency);
+    }
+
+    void set_items(benchmark::State& state, const size_t items_per_iteration) {
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * items_per_iteration));
+    }
+
+    //////////////////////////
+    // Structures           //
+    //////////////////////////
+
+    template<typename set_t>
+    void BM_RandomInsert(benchmark::State& state) {
+        const auto adjacencies = random_adjacencies(state.range(0));
+        for (auto _ : state) {
+            set_t set;
+            fill(set, adjacencies);
+            benchmark::DoNotOptimize(set.size());
+        }
+        set_items(state, adjacencies.size());
+    }
+
+    template<typename set_t>
+    void BM_SortedInsert(benchmark::State& state) {
+        const auto adjacencies = sorted_adjacencies(state.range(0));
+        for (auto _ : state) {
+            set_t set;
+            fill(set, adjacencies);
+            benchmark::DoNotOptimize(set.size());
+        }
+        set_items(state, adjacencies.size());
+    }
+
+    template<typename tree_t>
+    void BM_BatchInsert(benchmark::State& state) {
+        const auto adjacencies = random_adjacencies(state.range(0));
+        for (auto _ : state) {
+            tree_t tree;
+            tree.insert(adjacencies.begin(), adjacencies.end());
+            benchmark::DoNotOptimize(tree.size());
+        }
+        set_items(state, adjacencies.size());
+    }
+
+    template<typename set_t>
+    void BM_Erase(benchmark::State& state) {
+        const auto adjacencies = random_adjacencies(state.range(0));
+        auto order = adjacencies;
+        random::engine_t engine(SEED + 1);
+        std::shuffle(order.begin(), order.end(), engine);
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            set_t set;
+            fill(set, adjacencies);
+            state.ResumeTiming();
+
+            for (const auto& adjacency : order) {
+                const auto it = set.find(adjacency);
+                if (it != set.end())
+                    set.erase(it);
+            }
+            benchmark::DoNotOptimize(set.size());
+        }
+        set_items(state, adjacencies.size());
+    }
+
+    template<typename set_t>
+    void BM_Find(benchmark::State& state) {
+        const auto adjacencies = random_adjacencies(state.range(0));
+        const auto queries = random_adjacencies(state.range(0), SEED + 1);
+        set_t set;
+        fill(set, adjacencies);
+
+        for (auto _ : state) {
+            size_t found = 0;
+            for (const auto& adjacency : queries)
+                found += contains(set, adjacency);
+            benchmark::DoNotOptimize(found);
+        }
+        set_items(state, queries.size());
+    }
+
+    template<typename set_t>
+    void BM_Iterate(benchmark::State& state) {
+        const auto adjacencies = random_adjacencies(state.range(0));
+        set_t set;
+        fill(set, adjacencies);
+
+        for (auto _ : state) {
+            uint64_t checksum = 0;
+            for (const auto& adjacency : set)
+                checksum += adjacency.second;
+            benchmark::DoNotOptimize(checksum);
+        }
+        set_items(state, set.size());
+    }
+
+    template<typename tree_t>
+    void BM_FrozenFind(benchmark::State& state) {
+        const auto adjacencies = random_adjacencies(state.range(0));
+        const auto queries = random_adjacencies(state.range(0), SEED + 1);
+        tree_t tree(adjacencies.begin(), adjacencies.end());
+        tree.freeze();
+
+        for (auto _ : state) {
+            size_t found = 0;
+            for (const auto& adjacency : queries)
+                found += const_cast<const tree_t&>(tree).has(adjacency);
+            benchmark::DoNotOptimize(found);
+        }
+        set_items(state, queries.size());
+    }
+
+    template<typename tree_t>
+    void BM_RankSelect(benchmark::State& state) {
+        const auto adjacencies = random_adjacencies(state.range(0));
+        tree_t tree(adjacencies.begin(), adjacencies.end());
+
+        random::engine_t engine(SEED + 1);
+        std::vector<size_t> ranks(tree.size());
+        for (auto& rank : ranks)
+            rank = 1 + random::bounded(engine, tree.size());
+
+        for (auto _ : state) {
+            size_t checksum = 0;
+            for (const auto rank : ranks)
+                checksum += tree.rank(tree.select(rank));
+            benchmark::DoNotOptimize(checksum);
+        }
+        set_items(state, ranks.size());
+    }
+
+    template<typename manager_t>
+    void BM_NeighbourScan(benchmark::State& state) {
+        const auto adjacencies = random_adjacencies(state.range(0));
+        const size_t vertices_no = std::max<size_t>(adjacencies.size() / 8, 2);
+        manager_t manager(vertices_no);
+        manager.insert(adjacencies.begin(), adjacencies.end());
+
+        for (auto _ : state) {
+            uint64_t checksum = 0;
+            for (vid_t vertex = 0; vertex < vertices_no; vertex++)
+                for (auto it = manager.begin(vertex); it != manager.end(vertex); ++it)
+                    checksum += it->second;
+            benchmark::DoNotOptimize(checksum);
+        }
+        set_items(state, manager.size());
+    }
+
+    //////////////////////////
+    // Generators           //
+    //////////////////////////
+
+    void BM_Clique(benchmark::State& state) {
+        // a clique with about range(0) edges
+        const size_t vertices_no = static_cast<size_t>(std::sqrt(2.0 * state.range(0))) + 1;
+        size_t edges_no = 0;
+        for (auto _ : state) {
+            UndirectedGraph<> graph(vertices_no);
+            graph.build_clique();
+            edges_no = graph.edges();
+        }
+        set_items(state, edges_no);
+    }
+
+    void BM_Tree(benchmark::State& state) {
+        const size_t vertices_no = state.range(0) + 1;
+        random::engine_t engine(SEED);
+        for (auto _ : state) {
+            UndirectedGraph<> graph(vertices_no);
+            graph.build_tree(engine);
+            benchmark::DoNotOptimize(graph.edges());
+        }
+        set_items(state, vertices_no - 1);
+    }
+
+    void BM_GnmSparse(benchmark::State& state) {
+        // G(n, m) with average degree 8
+        const size_t edges_no = state.range(0);
+        random::engine_t engine(SEED);
+        for (auto _ : state) {
+            UndirectedGraph<> graph(std::max<size_t>(edges_no / 4, 2));
+            graph.add_edges(edges_no, engine);
+            benchmark::DoNotOptimize(graph.edges());
+        }
+        set_items(state, edges_no);
+    }
+
+    void BM_GnmDense(benchmark::State& state) {
+        // G(n, m) filling half of the possible edges
+        const size_t edges_no = state.range(0);
+        const size_t vertices_no = static_cast<size_t>(std::sqrt(4.0 * edges_no)) + 2;
+        random::engine_t engine(SEED);
+        for (auto _ : state) {
+            UndirectedGraph<> graph(vertices_no);
+            graph.add_edges(edges_no, engine);
+            benchmark::DoNotOptimize(graph.edges());
+        }
+        set_items(state, edges_no);
+    }
+
+    void BM_PowerLaw(benchmark::State& state) {
+        // Chung-Lu graph with power-law exponent 2.5 and average degree 8
+        const size_t edges_no = state.range(0);
+        random::engine_t engine(SEED);
+        for (auto _ : state) {
+            UndirectedGraph<> graph(std::max<size_t>(edges_no / 4, 2));
+            graph.build_power_law(2.5, 8, engine);
+            benchmark::DoNotOptimize(graph.edges());
+        }
+        set_items(state, edges_no);
+    }
+}
+
+#define KONIG_BENCH_SIZES RangeMultiplier(8)->Range(1 << 10, KONIG_BENCH_MAX_SIZE)->Unit(benchmark::kMillisecond)
+
+#define KONIG_BENCH_TREES(name) \
+    BENCHMARK_TEMPLATE(name, AdjacencyTree)->KONIG_BENCH_SIZES; \
+    BENCHMARK_TEMPLATE(name, CompactAdjacencyTree)->KONIG_BENCH_SIZES; \
+    BENCHMARK_TEMPLATE(name, AdjacencyBTree)->KONIG_BENCH_SIZES
+
+#ifdef KONIG_BENCH_BTREE
+#define KONIG_BENCH_SET(name) \
+    KONIG_BENCH_TREES(name); \
+    BENCHMARK_TEMPLATE(name, StdSet)->KONIG_BENCH_SIZES; \
+    BENCHMARK_TEMPLATE(name, BTreeSet)->KONIG_BENCH_SIZES
+#else
+#define KONIG_BENCH_SET(name) \
+    KONIG_BENCH_TREES(name); \
+    BENCHMARK_TEMPLATE(name, StdSet)->KONIG_BENCH_SIZES
+#endif
+
+KONIG_BENCH_SET(BM_RandomInsert);
+KONIG_BENCH_SET(BM_SortedInsert);
+KONIG_BENCH_SET(BM_Erase);
+KONIG_BENCH_SET(BM_Find);
+KONIG_BENCH_SET(BM_Iterate);
+KONIG_BENCH_TREES(BM_BatchInsert);
+KONIG_BENCH_TREES(BM_FrozenFind);
+KONIG_BENCH_TREES(BM_RankSelect);
+BENCHMARK_TEMPLATE(BM_NeighbourScan, AdjacencyManager)->KONIG_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_NeighbourScan, CompactAdjacencyManager)->KONIG_BENCH_SIZES;
+BENCHMARK_TEMPLATE(BM_NeighbourScan, BTreeAdjacencyManager)->KONIG_BENCH_SIZES;
+
+BENCHMARK(BM_Clique)->KONIG_BENCH_SIZES;
+BENCHMARK(BM_Tree)->KONIG_BENCH_SIZES;
+BENCHMARK(BM_GnmSparse)->KONIG_BENCH_SIZES;
+BENCHMARK(BM_GnmDense)->KONIG_BENCH_SIZES;
+BENCHMARK(BM_PowerLaw)->KONIG_BENCH_SIZES;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,862 @@
+#ifndef KONIG_ADJACENCYBTREE_HPP
+#define KONIG_ADJACENCYBTREE_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <cassert>
+#include "util.hpp"
+#include "Exception.hpp"
+#include "NodePool.hpp"
+#include "AdjacencyTree.hpp"
+
+namespace konig {
+
+    /**
+     * AdjacencyBTree (type)
+     *
+     * This is a counted B+-tree of adjacencies, exposing the same interface as AdjacencyTree (insertion, deletion,
+     * lookup, rank/select and random access iteration), so that it can be used as the backend of an AdjacencyManager.
+     *
+     * Adjacencies are packed in leaves of LEAF_CAPACITY elements, linked in a list, and each inner node stores, for each
+     * of its children, the size of its subtree (for rank/select) and a lower bound of its keys (for routing). Compared
+     * to the splay tree, which spends a 40-byte vertex on every 8-byte adjacency and restructures itself on every
+     * access, this takes about 8-16 bytes per adjacency and queries never write to memory: it is the better choice for
+     * workloads that generate a graph and then mostly read it.
+     *
+     * Nodes are split when they overflow, but are not merged when they underflow: a node is only released once it
+     * becomes empty. freeze(), assign() and big batch insertions rebuild the tree with full leaves.
+     *
+     * Unlike AdjacencyTree, elements move between nodes when the tree changes, so iterators remember the adjacency they
+     * point to: they are relocated (in O(log n)) the first time they are moved after a modification. Just like for
+     * AdjacencyTree, an iterator stays valid until the adjacency it points to is erased.
+     */
+    class AdjacencyBTree {
+    public:
+        static const size_t LEAF_CAPACITY = 60;
+        static const size_t INNER_CAPACITY = 32;
+
+        //////////////////////////
+        // Subtypes             //
+        //////////////////////////
+
+    private:
+        struct Node {
+            const bool is_leaf;
+            uint32_t count = 0;
+
+            explicit Node(const bool is_leaf) : is_leaf(is_leaf) { }
+        };
+
+        struct Leaf : Node {
+            Leaf* prev = NULL;
+            Leaf* next = NULL;
+            adjacency_t items[LEAF_CAPACITY];
+
+            Leaf() : Node(true) { }
+        };
+
+        struct Inner : Node {
+            Node* children[INNER_CAPACITY];
+            size_t sizes[INNER_CAPACITY];
+            adjacency_t lows[INNER_CAPACITY];
+
+            Inner() : Node(false) { }
+        };
+
+        struct Position {
+            const Leaf* leaf;
+            size_t index;
+        };
+
+    public:
+        /**
+         * iterator (type)
+         *
+         * This is a random access iterator over the adjacencies, in increasing order. Unit steps follow the list of
+         * leaves; longer jumps go through rank/select. Dereferencing it gives the adjacency it remembers, so it is
+         * always O(1).
+         */
+        class iterator : public std::iterator<std::random_access_iterator_tag, adjacency_t, std::ptrdiff_t,
+                                              const adjacency_t*, const adjacency_t&> {
+            friend class AdjacencyBTree;
+
+            // Members
+        private:
+            const AdjacencyBTree* tree;
+            adjacency_t key;
+            mutable const Leaf* leaf;   // NULL for the past-the-end iterator
+            mutable size_t index;
+            mutable uint64_t version;
+
+            iterator(const AdjacencyBTree* tree, const Position position)
+                    : tree(tree), leaf(position.leaf), index(position.index), version(tree->version) {
+                if (leaf)
+                    key = leaf->items[index];
+            }
+
+            /**
+             * refresh (method)
+             *
+             * This relocates the iterator if the tree has been modified since it was last positioned.
+             */
+            void refresh() const noexcept {
+                if (leaf && version != tree->version) {
+                    const auto position = tree->locate(key);
+                    leaf = position.leaf;
+                    index = position.index;
+                    version = tree->version;
+                }
+            }
+
+            void set(const Position position) noexcept {
+                leaf = position.leaf;
+                index = position.index;
+                version = tree->version;
+                if (leaf)
+                    key = leaf->items[index];
+            }
+
+            std::ptrdiff_t position_rank() const noexcept {
+                return leaf ? tree->count_less(key) + 1 : tree->size() + 1;
+            }
+
+            // Methods
+        public:
+            iterator() : tree(NULL), leaf(NULL), index(0), version(0) { }
+            iterator(const iterator& other) = default;
+            iterator& operator=(const iterator& other) = default;
+
+            std::ptrdiff_t operator-(const iterator& other) const noexcept {
+#ifdef KONIG_DEBUG
+                assert(tree == other.tree);
+#endif
+                return position_rank() - other.position_rank();
+            }
+
+            bool is_past_the_end() const noexcept {
+                return leaf == NULL;
+            }
+
+            const adjacency_t& operator*() const noexcept {
+                return key;
+            }
+
+            const adjacency_t* operator->() const noexcept {
+                return &key;
+            }
+
+            const iterator& operator++() noexcept {
+                refresh();
+                if (!leaf)
+                    return *this;
+
+                if (++index == leaf->count) {
+                    leaf = leaf->next;
+                    index = 0;
+                }
+                if (leaf)
+                    key = leaf->items[index];
+                return *this;
+            }
+
+            iterator operator++(int) noexcept {
+                iterator copy(*this);
+                ++(*this);
+                return copy;
+            }
+
+            const iterator& operator--() noexcept {
+                if (!leaf) {
+                    if (tree->tail)
+                        set({tree->tail, tree->tail->count - 1u});
+                    return *this;
+                }
+
+                refresh();
+                if (index == 0) {
+                    leaf = leaf->prev;
+                    index = leaf ? leaf->count - 1 : 0;
+                } else {
+                    --index;
+                }
+                if (leaf)
+                    key = leaf->items[index];
+                return *this;
+            }
+
+            iterator operator--(int) noexcept {
+                iterator copy(*this);
+                --(*this);
+                return copy;
+            }
+
+            bool operator==(const iterator& other) const noexcept {
+                if (!leaf || !other.leaf)
+                    return leaf == other.leaf;
+                return key == other.key;
+            }
+
+            bool operator!=(const iterator& other) const noexcept {
+                return !(*this == other);
+            }
+
+            iterator operator+(const std::ptrdiff_t increment) const noexcept {
+                refresh();
+                iterator copy(*this);
+                copy += increment;
+                return copy;
+            }
+
+            iterator& operator+=(const std::ptrdiff_t increment) noexcept {
+                if (increment == 1) {
+                    ++(*this);
+                } else if (increment == -1) {
+                    --(*this);
+                } else if (increment) {
+                    set(tree->_select(position_rank() + increment));
+                }
+                return *this;
+            }
+
+            iterator operator-(const std::ptrdiff_t decrement) const noexcept {
+                iterator copy(*this);
+                copy -= decrement;
+                return copy;
+            }
+
+            iterator& operator-=(const std::ptrdiff_t decrement) noexcept {
+                *this += -decrement;
+                return *this;
+            }
+        };
+
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+
+    private:
+        Node* tree_root = NULL;
+        Leaf* head = NULL;
+        Leaf* tail = NULL;
+        size_t elements = 0;
+        uint64_t version = 0;
+        bool frozen = false;
+        NodePool<Leaf> leaves;
+        NodePool<Inner> inners;
+
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+
+    private:
+        iterator make_iterator(const Position position) const noexcept {
+            return iterator(this, position);
+        }
+
+        /**
+         * child_index (method)
+         *
+         * This returns the index of the child of `inner` where `adjacency` belongs, i.e. the last one whose lower bound
+         * is <= `adjacency` (or the first one, if there is none).
+         */
+        static size_t child_index(const Inner* inner, const adjacency_t adjacency) noexcept {
+            return std::upper_bound(inner->lows + 1, inner->lows + inner->count, adjacency) - inner->lows - 1;
+        }
+
+        static size_t subtree_size(const Node* node) noexcept {
+            if (node->is_leaf)
+                return node->count;
+
+            const Inner* inner = static_cast<const Inner*>(node);
+            size_t size = 0;
+            for (size_t i = 0; i < inner->count; i++)
+                size += inner->sizes[i];
+            return size;
+        }
+
+        static adjacency_t lower_key(const Node* node) noexcept {
+            return node->is_leaf ? static_cast<const Leaf*>(node)->items[0] : static_cast<const Inner*>(node)->lows[0];
+        }
+
+        /**
+         * locate (method)
+         *
+         * This returns the position of the first adjacency >= `adjacency` (with a NULL leaf if there is none).
+         */
+        Position locate(const adjacency_t adjacency) const noexcept {
+            if (!tree_root)
+                return {NULL, 0};
+
+            const Node* node = tree_root;
+            while (!node->is_leaf) {
+                const Inner* inner = static_cast<const Inner*>(node);
+                node = inner->children[child_index(inner, adjacency)];
+            }
+
+            const Leaf* leaf = static_cast<const Leaf*>(node);
+            const size_t index = std::lower_bound(leaf->items, leaf->items + leaf->count, adjacency) - leaf->items;
+            if (index == leaf->count)
+                return {leaf->next, 0};
+            return {leaf, index};
+        }
+
+        /**
+         * count_less (method)
+         *
+         * This returns the number of adjacencies < `adjacency`.
+         */
+        size_t count_less(const adjacency_t adjacency) const noexcept {
+            if (!tree_root)
+                return 0;
+
+            size_t result = 0;
+            const Node* node = tree_root;
+            while (!node->is_leaf) {
+                const Inner* inner = static_cast<const Inner*>(node);
+                const size_t child = child_index(inner, adjacency);
+                for (size_t i = 0; i < child; i++)
+                    result += inner->sizes[i];
+                node = inner->children[child];
+            }
+
+            const Leaf* leaf = static_cast<const Leaf*>(node);
+            return result + (std::lower_bound(leaf->items, leaf->items + leaf->count, adjacency) - leaf->items);
+        }
+
+        /**
+         * _select (method)
+         *
+         * This returns the position of the adjacency whose rank is `rank` (with a NULL leaf if there is none).
+         */
+        Position _select(const std::ptrdiff_t rank) const noexcept {
+            if (rank <= 0 || rank > static_cast<std::ptrdiff_t>(size()))
+                return {NULL, 0};
+
+            size_t remaining = rank - 1;
+            const Node* node = tree_root;
+            while (!node->is_leaf) {
+                const Inner* inner = static_cast<const Inner*>(node);
+                size_t child = 0;
+                while (remaining >= inner->sizes[child])
+                    remaining -= inner->sizes[child++];
+                node = inner->children[child];
+            }
+            return {static_cast<const Leaf*>(node), remaining};
+        }
+
+        /**
+         * split_leaf (method)
+         *
+         * This moves the upper half of the full `leaf` to a new leaf, linked right after it, and returns the new leaf.
+         */
+        Leaf* split_leaf(Leaf* const leaf) {
+            Leaf* sibling = leaves.create();
+            const size_t kept = leaf->count / 2;
+
+            std::copy(leaf->items + kept, leaf->items + leaf->count, sibling->items);
+            sibling->count = leaf->count - kept;
+            leaf->count = kept;
+
+            sibling->prev = leaf;
+            sibling->next = leaf->next;
+            if (leaf->next)
+                leaf->next->prev = sibling;
+            else
+                tail = sibling;
+            leaf->next = sibling;
+
+            return sibling;
+        }
+
+        /**
+         * split_inner (method)
+         *
+         * This moves the upper half of the children of the full `inner` to a new inner node, and returns it.
+         */
+        Inner* split_inner(Inner* const inner) {
+            Inner* sibling = inners.create();
+            const size_t kept = inner->count / 2;
+            const size_t moved = inner->count - kept;
+
+            std::copy(inner->children + kept, inner->children + inner->count, sibling->children);
+            std::copy(inner->sizes + kept, inner->sizes + inner->count, sibling->sizes);
+            std::copy(inner->lows + kept, inner->lows + inner->count, sibling->lows);
+            sibling->count = moved;
+            inner->count = kept;
+
+            return sibling;
+        }
+
+        /**
+         * insert_child (method)
+         *
+         * This inserts `child` as the `index`-th child of `inner`, splitting `inner` if it is full. It returns the new
+         * sibling of `inner`, or NULL if it has not been split.
+         */
+        Inner* insert_child(Inner* inner, size_t index, Node* const child) {
+            Inner* sibling = NULL;
+            if (inner->count == INNER_CAPACITY) {
+                sibling = split_inner(inner);
+                if (index > inner->count) {
+                    index -= inner->count;
+                    inner = sibling;
+                }
+            }
+
+            std::copy_backward(inner->children + index, inner->children + inner->count,
+                               inner->children + inner->count + 1);
+            std::copy_backward(inner->sizes + index, inner->sizes + inner->count, inner->sizes + inner->count + 1);
+            std::copy_backward(inner->lows + index, inner->lows + inner->count, inner->lows + inner->count + 1);
+            inner->children[index] = child;
+            inner->sizes[index] = subtree_size(child);
+            inner->lows[index] = lower_key(child);
+            ++inner->count;
+
+            return sibling;
+        }
+
+        /**
+         * insert_into (method)
+         *
+         * This inserts `adjacency` in the subtree of `node`, unless it is already there, and returns whether it has been
+         * inserted. If `node` had to be split, its new right sibling is stored in `split`.
+         */
+        bool insert_into(Node* const node, const adjacency_t adjacency, Node*& split) {
+            split = NULL;
+
+            if (node->is_leaf) {
+                Leaf* leaf = static_cast<Leaf*>(node);
+                size_t index = std::lower_bound(leaf->items, leaf->items + leaf->count, adjacency) - leaf->items;
+                if (index < leaf->count && leaf->items[index] == adjacency)
+                    return false;
+
+                if (leaf->count == LEAF_CAPACITY) {
+                    Leaf* sibling = split_leaf(leaf);
+                    split = sibling;
+                    if (index > leaf->count) {
+                        index -= leaf->count;
+                        leaf = sibling;
+                    }
+                }
+
+                std::copy_backward(leaf->items + index, leaf->items + leaf->count, leaf->items + leaf->count + 1);
+                leaf->items[index] = adjacency;
+                ++leaf->count;
+                return true;
+            }
+
+            Inner* inner = static_cast<Inner*>(node);
+            const size_t index = child_index(inner, adjacency);
+
+            Node* child_split;
+            if (!insert_into(inner->children[index], adjacency, child_split))
+                return false;
+
+            if (adjacency < inner->lows[index])
+                inner->lows[index] = adjacency;
+            ++inner->sizes[index];
+
+            if (child_split) {
+                inner->sizes[index] -= subtree_size(child_split);
+                split = insert_child(inner, index + 1, child_split);
+            }
+            return true;
+        }
+
+        /**
+         * destroy (method)
+         *
+         * This gives back the memory of an empty node, unlinking it from the list of leaves.
+         */
+        void destroy(Node* const node) noexcept {
+            if (!node->is_leaf) {
+                inners.destroy(static_cast<Inner*>(node));
+                return;
+            }
+
+            Leaf* leaf = static_cast<Leaf*>(node);
+            if (leaf->prev)
+                leaf->prev->next = leaf->next;
+            else
+                head = leaf->next;
+            if (leaf->next)
+                leaf->next->prev = leaf->prev;
+            else
+                tail = leaf->prev;
+            leaves.destroy(leaf);
+        }
+
+        /**
+         * erase_from (method)
+         *
+         * This removes `adjacency` (which must be there) from the subtree of `node`, and returns whether `node` has
+         * become empty. Empty children are released here; `node` itself is released by the caller.
+         */
+        bool erase_from(Node* const node, const adjacency_t adjacency) noexcept {
+            if (node->is_leaf) {
+                Leaf* leaf = static_cast<Leaf*>(node);
+                const size_t index = std::lower_bound(leaf->items, leaf->items + leaf->count, adjacency) - leaf->items;
+#ifdef KONIG_DEBUG
+                assert(index < leaf->count && leaf->items[index] == adjacency);
+#endif
+                std::copy(leaf->items + index + 1, leaf->items + leaf->count, leaf->items + index);
+                return --leaf->count == 0;
+            }
+
+            Inner* inner = static_cast<Inner*>(node);
+            const size_t index = child_index(inner, adjacency);
+
+            if (!erase_from(inner->children[index], adjacency)) {
+                --inner->sizes[index];
+                return false;
+            }
+
+            destroy(inner->children[index]);
+            std::copy(inner->children + index + 1, inner->children + inner->count, inner->children + index);
+            std::copy(inner->sizes + index + 1, inner->sizes + inner->count, inner->sizes + index);
+            std::copy(inner->lows + index + 1, inner->lows + inner->count, inner->lows + index);
+            return --inner->count == 0;
+        }
+
+        /**
+         * build (method)
+         *
+         * This replaces the content of the tree with the sorted and duplicate-free `batch`, packed in full leaves, in
+         * linear time.
+         */
+        void build(const std::vector<adjacency_t>& batch) {
+            ++version;
+            tree_root = NULL;
+            head = tail = NULL;
+            elements = batch.size();
+            leaves.clear();
+            inners.clear();
+
+            std::vector<Node*> level;
+            for (size_t first = 0; first < batch.size(); first += LEAF_CAPACITY) {
+                Leaf* leaf = leaves.create();
+                leaf->count = std::min(uint64_t(LEAF_CAPACITY), uint64_t(batch.size() - first));
+                std::copy(batch.begin() + first, batch.begin() + first + leaf->count, leaf->items);
+
+                leaf->prev = tail;
+                if (tail)
+                    tail->next = leaf;
+                else
+                    head = leaf;
+                tail = leaf;
+                level.push_back(leaf);
+            }
+
+            while (level.size() > 1) {
+                std::vector<Node*> parents;
+                for (size_t first = 0; first < level.size(); first += INNER_CAPACITY) {
+                    Inner* inner = inners.create();
+                    const size_t last = std::min(uint64_t(first + INNER_CAPACITY), uint64_t(level.size()));
+                    for (size_t i = first; i < last; i++)
+                        insert_child(inner, inner->count, level[i]);
+                    parents.push_back(inner);
+                }
+                level.swap(parents);
+            }
+
+            if (!level.empty())
+                tree_root = level.front();
+        }
+
+        void ensure_mutable() const {
+            if (frozen)
+                throw StructureViolation(context_info("the AdjacencyBTree is frozen"));
+        }
+
+        bool _insert(const adjacency_t adjacency) {
+            if (!tree_root) {
+                Leaf* leaf = leaves.create();
+                leaf->items[0] = adjacency;
+                leaf->count = 1;
+                tree_root = head = tail = leaf;
+                ++elements;
+                ++version;
+                return true;
+            }
+
+            Node* split;
+            if (!insert_into(tree_root, adjacency, split))
+                return false;
+
+            if (split) {
+                Inner* new_root = inners.create();
+                insert_child(new_root, 0, tree_root);
+                insert_child(new_root, 1, split);
+                tree_root = new_root;
+            }
+            ++elements;
+            ++version;
+            return true;
+        }
+
+    public:
+        AdjacencyBTree() = default;
+        AdjacencyBTree(const AdjacencyBTree&) = delete;
+        AdjacencyBTree& operator=(const AdjacencyBTree&) = delete;
+
+        /**
+         * AdjacencyBTree (constructor)
+         *
+         * This builds a tree out of the adjacencies in [first, last) in linear time (plus the time needed to sort them,
+         * if they are not sorted already). Duplicates are removed.
+         */
+        template<typename InputIt>
+        AdjacencyBTree(InputIt first, InputIt last) {
+            assign(first, last);
+        }
+
+        /**
+         * assign (method)
+         *
+         * This replaces the content of the tree with the adjacencies in [first, last), in linear time (plus the time
+         * needed to sort them, if they are not sorted already). Duplicates are removed. All the iterators are
+         * invalidated.
+         */
+        template<typename InputIt>
+        void assign(InputIt first, InputIt last) {
+            ensure_mutable();
+            build(detail::sorted_batch(first, last));
+        }
+
+        /**
+         * reserve (method)
+         *
+         * This preallocates the leaves for `adjacencies` more adjacencies, inserted one at a time (which leaves the
+         * leaves half full, on average).
+         */
+        void reserve(const size_t adjacencies) {
+            leaves.reserve(2 * adjacencies / LEAF_CAPACITY + 1);
+        }
+
+        /**
+         * clear (method)
+         *
+         * This removes all the adjacencies from the structure, releasing their memory in bulk. All the iterators are
+         * invalidated.
+         */
+        void clear() {
+            ensure_mutable();
+            build(std::vector<adjacency_t>());
+        }
+
+        /**
+         * freeze (method)
+         *
+         * This repacks the tree in full leaves, in linear time, and marks it as read-only: any attempt to modify it
+         * throws StructureViolation, until thaw() is called. Iterators are relocated by key, so they stay valid.
+         */
+        void freeze() {
+            if (!frozen) {
+                build(std::vector<adjacency_t>(begin(), end()));
+                frozen = true;
+            }
+        }
+
+        /**
+         * thaw (method)
+         *
+         * This makes a frozen tree modifiable again.
+         */
+        void thaw() noexcept {
+            frozen = false;
+        }
+
+        bool is_frozen() const noexcept {
+            return frozen;
+        }
+
+        iterator begin() const noexcept {
+            return make_iterator({head, 0});
+        }
+
+        iterator end() const noexcept {
+            return make_iterator({NULL, 0});
+        }
+
+        size_t size() const noexcept {
+            return elements;
+        }
+
+        /**
+         * lower_bound (method)
+         *
+         * This returns an iterator to the first adjacency that evaluates as >= `adjacency`.
+         */
+        iterator lower_bound(const adjacency_t adjacency) const noexcept {
+            return make_iterator(locate(adjacency));
+        }
+
+        /**
+         * upper_bound (method)
+         *
+         * This returns an iterator to the first adjacency that evaluates as > `adjacency`.
+         */
+        iterator upper_bound(const adjacency_t adjacency) const noexcept {
+            iterator it = lower_bound(adjacency);
+            if (!it.is_past_the_end() && *it == adjacency)
+                ++it;
+            return it;
+        }
+
+        /**
+         * find (method)
+         *
+         * This returns end() if the adjacency does not exist, or an iterator to the adjacency otherwise.
+         */
+        iterator find(const adjacency_t adjacency) const noexcept {
+            const iterator it = lower_bound(adjacency);
+            return (!it.is_past_the_end() && *it == adjacency) ? it : end();
+        }
+
+        bool has(const adjacency_t adjacency) const noexcept {
+            return !find(adjacency).is_past_the_end();
+        }
+
+        /**
+         * insert (overloaded method)
+         *
+         * This inserts the given adjacency in the tree. Just like std::set::insert, it returns an iterator to the
+         * adjacency, together with a bool telling whether the adjacency has been inserted (true) or was already in the
+         * tree (false).
+         */
+        std::pair<iterator, bool> insert(const adjacency_t adjacency) {
+            ensure_mutable();
+            const bool inserted = _insert(adjacency);
+            return {find(adjacency), inserted};
+        }
+
+        /**
+         * insert (overloaded method)
+         *
+         * This inserts all the adjacencies in [first, last), ignoring those already in the tree. Small batches are
+         * inserted one at a time, while big ones are merged with the current content of the tree, which is then rebuilt
+         * in O(size() + batch size).
+         */
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            ensure_mutable();
+            const auto batch = detail::sorted_batch(first, last);
+
+            size_t log_size = 1;
+            while ((size_t(1) << log_size) <= size())
+                ++log_size;
+
+            if (batch.size() * log_size < size()) {
+                for (const auto& adjacency : batch)
+                    _insert(adjacency);
+            } else {
+                std::vector<adjacency_t> merged;
+                merged.reserve(size() + batch.size());
+                std::set_union(begin(), end(), batch.begin(), batch.end(), std::back_inserter(merged));
+                build(merged);
+            }
+        }
+
+        /**
+         * erase (overloaded method)
+         *
+         * This deletes the adjacency pointed by `it`.
+         */
+        void erase(const iterator it) {
+            ensure_mutable();
+            if (it.is_past_the_end() || !has(*it))
+                return;
+
+            if (erase_from(tree_root, *it)) {
+                destroy(tree_root);
+                tree_root = NULL;
+            }
+            while (tree_root && !tree_root->is_leaf && tree_root->count == 1) {
+                Node* child = static_cast<Inner*>(tree_root)->children[0];
+                destroy(tree_root);
+                tree_root = child;
+            }
+            --elements;
+            ++version;
+        }
+
+        /**
+         * erase (overloaded method)
+         *
+         * This deletes all the adjacencies in [first, last). Just like batch insertions, small ranges are deleted one
+         * adjacency at a time, while big ones are cut out by rebuilding the tree with the remaining adjacencies, in
+         * O(size()).
+         */
+        void erase(const iterator first, const iterator last) {
+            ensure_mutable();
+            const std::vector<adjacency_t> doomed(first, last);
+            if (doomed.empty())
+                return;
+
+            size_t log_size = 1;
+            while ((size_t(1) << log_size) <= size())
+                ++log_size;
+
+            if (doomed.size() * log_size < size()) {
+                for (const auto& adjacency : doomed)
+                    erase(find(adjacency));
+            } else {
+                std::vector<adjacency_t> kept(begin(), first);
+                kept.insert(kept.end(), last, end());
+                build(kept);
+            }
+        }
+
+        /**
+         * split_at (method)
+         *
+         * This moves the adjacencies from `it` onwards to `other`, whose previous content is dropped.
+         */
+        void split_at(const iterator it, AdjacencyBTree& other) {
+            if (&other == this)
+                throw InvalidArgument(context_info("a tree cannot be split into itself"));
+            ensure_mutable();
+            other.assign(it, end());
+            erase(it, end());
+        }
+
+        /**
+         * merge (method)
+         *
+         * This moves all the adjacencies of `other` into this tree, as a batch insertion, leaving `other` empty.
+         */
+        void merge(AdjacencyBTree& other) {
+            if (&other == this)
+                return;
+            ensure_mutable();
+            other.ensure_mutable();
+            insert(other.begin(), other.end());
+            other.clear();
+        }
+
+        /**
+         * rank (method)
+         *
+         * This returns the rank (starting from 1) of the adjacency represented by the supplied iterator.
+         */
+        size_t rank(const iterator it) const noexcept {
+            return it.position_rank();
+        }
+
+        /**
+         * select (method)
+         *
+         * This returns the adjacency given its rank, or end() if there is none.
+         */
+        iterator select(const size_t rank) const noexcept {
+            return make_iterator(_select(rank));
+        }
+    };
+
+}
+
+#endif //KONIG_ADJACENCYBTREE_HPP
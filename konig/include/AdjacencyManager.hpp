@@ -1,45 +1,90 @@
 #ifndef KONIG_ADJACENCYMANAGER_HPP
 #define KONIG_ADJACENCYMANAGER_HPP
 
-#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <vector>
 #include "AdjacencyTree.hpp"
+#include "AdjacencyBTree.hpp"
+#include "CompressedSparseRow.hpp"
+#include "VertexIndex.hpp"
 
 namespace konig {
 
     /**
-     * AdjacencyManager (type)
+     * BasicAdjacencyManager (type)
+     *
+     * This is a handy wrapper for AdjacencyTree, which also keeps track of the range of adjacencies (and the degree)
+     * of every vertex, so that the neighbourhood of a vertex can be enumerated with begin(vertex)/end(vertex).
+     *
+     * The per-vertex ranges are stored in a `vertex_index_t` (see VertexIndex.hpp): DenseVertexIndex, a plain vector
+     * indexed by vid_t for the vertices in [0, vertices_no), or HashedVertexIndex, for vertices sparse in the vid_t
+     * range.
      *
-     * This is a handy wrapper for AdjacencyTree.
-     * //TODO
+     * The adjacencies are stored in a `tree_t`: AdjacencyTree (the splay tree), or AdjacencyBTree, which is more
+     * compact and faster to read. Any structure with the same interface (sorted, with rank/select and iterators which
+     * stay valid until their adjacency is erased) can be used.
      */
-    class AdjacencyManager {
+    template<template<typename> class vertex_index_t, typename tree_t = AdjacencyTree>
+    class BasicAdjacencyManager {
 
         //////////////////////////
         // Subtypes             //
         //////////////////////////
     public:
-        typedef AdjacencyTree::iterator iterator;
+        typedef tree_t tree_type;
+        typedef typename tree_t::iterator iterator;
 
         //////////////////////////
         // Members              //
         //////////////////////////
     private:
-        AdjacencyTree adjacency_tree;
+        tree_t adjacency_tree;
 
-        std::unordered_map<vid_t, AdjacencyTree::iterator> vertex_range_first;
-        std::unordered_map<vid_t, AdjacencyTree::iterator> vertex_range_last;
+        vertex_index_t<iterator> vertex_ranges;
 
 
         //////////////////////////
         // Methods              //
         //////////////////////////
     public:
+        BasicAdjacencyManager() = default;
+
+        /**
+         * BasicAdjacencyManager (constructor)
+         *
+         * This preallocates the vertex index for the vertices in [0, vertices_no). With a DenseVertexIndex, these are
+         * the vertices indexed densely: any other vertex is still accepted, but costs a hash lookup.
+         */
+        explicit BasicAdjacencyManager(const size_t vertices_no) {
+            vertex_ranges.reserve(vertices_no);
+        }
+
+        /**
+         * reserve (method)
+         *
+         * This preallocates the vertex index for the vertices in [0, vertices_no), as the constructor does: with a
+         * DenseVertexIndex, the vertices already stored in this range are moved to the dense part. Iterators stay valid.
+         */
+        void reserve(const size_t vertices_no) {
+            vertex_ranges.reserve(vertices_no);
+        }
+
+        /**
+         * dense_vertices (method)
+         *
+         * This returns the number of vertices indexed densely (see vertex_index_t::dense_vertices).
+         */
+        size_t dense_vertices() const noexcept {
+            return vertex_ranges.dense_vertices();
+        }
+
         /**
          * begin (overloaded method)
          *
          * This returns an iterator to the first adjacency stored in the underlying tree.
          */
-        iterator begin() {
+        iterator begin() const {
             return adjacency_tree.begin();
         }
 
@@ -48,11 +93,9 @@ namespace konig {
          *
          * This returns an iterator to the first adjacency having `vertex` as its first endpoint.
          */
-        iterator begin(const vid_t vertex) noexcept {
-            if (vertex_range_first.count(vertex))
-                return vertex_range_first.find(vertex)->second;
-            else
-                return end();
+        iterator begin(const vid_t vertex) const noexcept {
+            const auto range = vertex_ranges.find(vertex);
+            return range ? range->first : end();
         }
 
         /**
@@ -60,43 +103,111 @@ namespace konig {
          *
          * This returns an iterator corresponding to the past-the-end element of the underlying tree.
          */
-        iterator end() noexcept {
+        iterator end() const noexcept {
             return adjacency_tree.end();
         }
 
         /**
          * end (overloaded method)
          *
-         * This returns an iterator corresponding to the past-the-end element of the underlying tree.
+         * This returns an iterator past the last adjacency having `vertex` as its first endpoint.
+         */
+        iterator end(const vid_t vertex) const noexcept {
+            const auto range = vertex_ranges.find(vertex);
+            return range ? range->last + 1 : end();
+        }
+
+        /**
+         * degree (method)
+         *
+         * This returns the number of adjacencies having `vertex` as their first endpoint, in constant time.
          */
-        iterator end(const vid_t vertex) noexcept {
-            if (vertex_range_last.count(vertex))
-                return vertex_range_last.find(vertex)->second + 1;
-            else
-                return end();
+        size_t degree(const vid_t vertex) const noexcept {
+            const auto range = vertex_ranges.find(vertex);
+            return range ? range->degree : 0;
         }
 
         /**
-         * insert (method)
+         * insert (overloaded method)
          *
-         * This inserts a new adjacency. If the adjacency is already there, it does nothing.
+         * This inserts a new adjacency. If the adjacency is already there, it does nothing. Just like
+         * AdjacencyTree::insert, it returns an iterator to the adjacency and whether it has been inserted.
          */
-        iterator insert(const adjacency_t adjacency) {
+        std::pair<iterator, bool> insert(const adjacency_t adjacency) {
             const auto& u = adjacency.first;
 
-            const auto it = adjacency_tree.insert(adjacency);
+            const auto result = adjacency_tree.insert(adjacency);
+            if (!result.second)
+                return result;
 
-            if (!vertex_range_first.count(u))
-                vertex_range_first.emplace(u, end());
-            if (!vertex_range_last.count(u))
-                vertex_range_last.emplace(u, end());
+            const auto& it = result.first;
+            auto& range = vertex_ranges.get(u);
 
-            if (vertex_range_first.find(u)->second.is_past_the_end() || *(vertex_range_first.find(u)->second) > adjacency)
-                vertex_range_first.find(u)->second = it;
-            if (vertex_range_last.find(u)->second.is_past_the_end() || *(vertex_range_last.find(u)->second) < adjacency)
-                vertex_range_last.find(u)->second = it;
+            if (!range.degree) {
+                range.first = range.last = it;
+            } else {
+                if (*(range.first) > adjacency)
+                    range.first = it;
+                if (*(range.last) < adjacency)
+                    range.last = it;
+            }
+            ++range.degree;
 
-            return it;
+            return result;
+        }
+
+        /**
+         * insert (overloaded method)
+         *
+         * This inserts all the adjacencies in [first, last), ignoring those already there. See AdjacencyTree::insert
+         * for the complexity; on top of that, the first/last adjacency of each vertex appearing in the batch is looked
+         * up once.
+         */
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            std::vector<adjacency_t> batch(first, last);
+            if (!std::is_sorted(batch.begin(), batch.end()))
+                std::sort(batch.begin(), batch.end());
+
+            adjacency_tree.insert(batch.begin(), batch.end());
+
+            for (auto it = batch.begin(); it != batch.end(); ) {
+                const vid_t u = it->first;
+
+                auto& range = vertex_ranges.get(u);
+                range.first = adjacency_tree.lower_bound({u, 0});
+                range.last = adjacency_tree.upper_bound({u, std::numeric_limits<vid_t>::max()});
+                --range.last;
+                range.degree = (range.last - range.first) + 1;
+
+                while (it != batch.end() && it->first == u)
+                    ++it;
+            }
+        }
+
+        /**
+         * assign (method)
+         *
+         * This replaces the content of the structure with the adjacencies in [first, last), building the tree in linear
+         * time (see AdjacencyTree::assign) and then the per-vertex ranges with a linear scan. Duplicates are removed.
+         * All the iterators are invalidated.
+         */
+        template<typename InputIt>
+        void assign(InputIt first, InputIt last) {
+            if (is_frozen())
+                throw StructureViolation(context_info("the AdjacencyManager is frozen"));
+
+            adjacency_tree.assign(first, last);
+            vertex_ranges.clear();
+            for (auto it = adjacency_tree.begin(); it != adjacency_tree.end(); ) {
+                auto& range = vertex_ranges.get(it->first);
+                range.first = range.last = it;
+                range.degree = 1;
+                for (++it; it != adjacency_tree.end() && it->first == range.first->first; ++it) {
+                    range.last = it;
+                    ++range.degree;
+                }
+            }
         }
 
         /**
@@ -119,30 +230,165 @@ namespace konig {
 #ifdef KONIG_DEBUG
             assert(!it.is_past_the_end());
 #endif
-            const auto& u = it->first;
+            if (is_frozen())
+                throw StructureViolation(context_info("the AdjacencyManager is frozen"));
+
+            const auto u = it->first;
+            auto range = vertex_ranges.find(u);
 
 #ifdef KONIG_DEBUG
-            assert(vertex_range_first.count(u));
-            assert(vertex_range_last.count(u));
-            assert(!vertex_range_first.find(u)->second.is_past_the_end());
-            assert(!vertex_range_last.find(u)->second.is_past_the_end());
+            assert(range);
+            assert(!range->first.is_past_the_end());
+            assert(!range->last.is_past_the_end());
 #endif
-            if (vertex_range_first.find(u)->second == vertex_range_last.find(u)->second) {  // Special case: only one adjacency having u as .first
+            if (range->degree == 1) {  // Special case: only one adjacency having u as .first
 #ifdef KONIG_DEBUG
-                assert(vertex_range_first.find(u)->second == it);
+                assert(range->first == it);
 #endif
-                vertex_range_first.erase(u);
-                vertex_range_last.erase(u);
+                vertex_ranges.erase(u);
             } else {
-                if (it == vertex_range_first.find(u)->second)
-                    ++vertex_range_first.find(u)->second;
-                else if (it == vertex_range_last.find(u)->second)
-                    --vertex_range_last.find(u)->second;
+                if (it == range->first)
+                    ++range->first;
+                else if (it == range->last)
+                    --range->last;
+                --range->degree;
             }
 
             adjacency_tree.erase(it);
         }
 
+        /**
+         * remove_vertex (method)
+         *
+         * This deletes all the adjacencies having `vertex` as .first, with a single range erase of the underlying tree
+         * (see AdjacencyTree::erase), and returns how many they were. The ranges of the other vertices are untouched,
+         * since none of their adjacencies moves.
+         */
+        size_t remove_vertex(const vid_t vertex) {
+            if (is_frozen())
+                throw StructureViolation(context_info("the AdjacencyManager is frozen"));
+
+            const auto range = vertex_ranges.find(vertex);
+            if (!range)
+                return 0;
+
+            const size_t degree = range->degree;
+            adjacency_tree.erase(range->first, std::next(range->last));
+            vertex_ranges.erase(vertex);
+            return degree;
+        }
+
+        /**
+         * freeze (method)
+         *
+         * This freezes the underlying tree (see AdjacencyTree::freeze): the structure becomes read-only, and can be
+         * shared by concurrent readers. The per-vertex ranges are rebuilt with a linear scan, so that no iterator they
+         * hold needs to be relocated by a reader (see AdjacencyBTree).
+         */
+        void freeze() {
+            if (is_frozen())
+                return;
+
+            adjacency_tree.freeze();
+            for (auto it = adjacency_tree.begin(); it != adjacency_tree.end(); ) {
+                auto& range = vertex_ranges.get(it->first);
+                range.first = range.last = it;
+                for (++it; it != adjacency_tree.end() && it->first == range.first->first; ++it)
+                    range.last = it;
+            }
+        }
+
+        /**
+         * thaw (method)
+         *
+         * This makes a frozen structure modifiable again.
+         */
+        void thaw() noexcept {
+            adjacency_tree.thaw();
+        }
+
+        /**
+         * is_frozen (method)
+         *
+         * This checks whether the structure is frozen.
+         */
+        bool is_frozen() const noexcept {
+            return adjacency_tree.is_frozen();
+        }
+
+        /**
+         * find (overloaded method)
+         *
+         * This returns an iterator to `adjacency`, or end() if the adjacency does not exist.
+         */
+        iterator find(const adjacency_t adjacency) noexcept {
+            return adjacency_tree.find(adjacency);
+        }
+
+        /**
+         * find (overloaded method)
+         *
+         * This is the same as find(adjacency), without splaying the underlying tree.
+         */
+        iterator find(const adjacency_t adjacency) const noexcept {
+            return adjacency_tree.find(adjacency);
+        }
+
+        /**
+         * has (overloaded method)
+         *
+         * This checks whether the structure contains `adjacency`.
+         */
+        bool has(const adjacency_t adjacency) noexcept {
+            return adjacency_tree.has(adjacency);
+        }
+
+        /**
+         * has (overloaded method)
+         *
+         * This is the same as has(adjacency), without splaying the underlying tree.
+         */
+        bool has(const adjacency_t adjacency) const noexcept {
+            return adjacency_tree.has(adjacency);
+        }
+
+        /**
+         * rank (method)
+         *
+         * This returns the rank (starting from 1) of the adjacency pointed by `it` among all the adjacencies.
+         */
+        size_t rank(const iterator it) noexcept {
+            return adjacency_tree.rank(it);
+        }
+
+        /**
+         * select (overloaded method)
+         *
+         * This returns an iterator to the adjacency whose rank (starting from 1) is `rank`, or end() if there is none.
+         */
+        iterator select(const size_t rank) noexcept {
+            return adjacency_tree.select(rank);
+        }
+
+        /**
+         * select (overloaded method)
+         *
+         * This is the same as select(rank), without splaying the underlying tree.
+         */
+        iterator select(const size_t rank) const noexcept {
+            return adjacency_tree.select(rank);
+        }
+
+        /**
+         * to_csr (method)
+         *
+         * This returns a compact CompressedSparseRow snapshot of the structure, built with a single in-order visit of
+         * the underlying tree. The snapshot has at least `vertices_no` vertices.
+         */
+        CompressedSparseRow to_csr(const size_t vertices_no = 0) const {
+            return CompressedSparseRow(begin(), end(), vertices_no);
+        }
+
         /**
          * size (method)
          *
@@ -151,7 +397,44 @@ namespace konig {
         size_t size() const {
             return adjacency_tree.size();
         }
+
+#ifdef KONIG_STATISTICS
+        /**
+         * statistics (method)
+         *
+         * This returns the counters collected by the underlying tree (see TreeStatistics).
+         */
+        const TreeStatistics& statistics() const noexcept {
+            return adjacency_tree.statistics();
+        }
+
+        void reset_statistics() noexcept {
+            adjacency_tree.reset_statistics();
+        }
+#endif
     };
+
+    /**
+     * AdjacencyManager (type)
+     *
+     * This is the BasicAdjacencyManager used throughout Konig, indexing the vertices densely.
+     */
+    typedef BasicAdjacencyManager<DenseVertexIndex> AdjacencyManager;
+
+    /**
+     * BTreeAdjacencyManager (type)
+     *
+     * This is a BasicAdjacencyManager indexing the vertices densely, backed by an AdjacencyBTree.
+     */
+    typedef BasicAdjacencyManager<DenseVertexIndex, AdjacencyBTree> BTreeAdjacencyManager;
+
+    /**
+     * CompactAdjacencyManager (type)
+     *
+     * This is a BasicAdjacencyManager indexing the vertices densely, backed by a CompactAdjacencyTree: it takes about
+     * 40% less memory than AdjacencyManager, and holds up to 2^32 - 1 adjacencies.
+     */
+    typedef BasicAdjacencyManager<DenseVertexIndex, CompactAdjacencyTree> CompactAdjacencyManager;
 }
 
 #endif //KONIG_ADJACENCYMANAGER_HPP
@@ -0,0 +1,256 @@
+#ifndef KONIG_ADJACENCYRANKS_HPP
+#define KONIG_ADJACENCYRANKS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include "AdjacencyTree.hpp"
+
+namespace konig {
+
+    namespace detail {
+
+        /**
+         * isqrt (function)
+         *
+         * This returns floor(sqrt(`value`)), exactly for every 64-bit value: the floating point estimate is off by at
+         * most one, and it is fixed with integer arithmetic.
+         */
+        inline uint64_t isqrt(const uint64_t value) noexcept {
+            const uint64_t max_root = 0xFFFFFFFFu;
+            uint64_t root = std::min<uint64_t>(max_root, static_cast<uint64_t>(std::sqrt(double(value))));
+            while (root * root > value)
+                root--;
+            while (root < max_root && (root + 1) * (root + 1) <= value)
+                root++;
+            return root;
+        }
+
+    }
+
+    /**
+     * DirectedRanks (type)
+     *
+     * This numbers the adjacencies of a directed graph on `vertices_no` vertices without self loops, i.e. all the
+     * pairs (u, v) with u != v, from 0 to vertices_no * (vertices_no - 1) - 1. The numbering follows the
+     * lexicographical order of the adjacencies, so a sorted run of ranks decodes to a sorted run of adjacencies.
+     */
+    class DirectedRanks {
+    private:
+        uint64_t vertices_no;
+
+    public:
+        explicit DirectedRanks(const uint64_t vertices_no) : vertices_no(vertices_no) { }
+
+        /**
+         * size (method)
+         *
+         * This returns the number of valid adjacencies.
+         */
+        uint64_t size() const noexcept {
+            return vertices_no ? vertices_no * (vertices_no - 1) : 0;
+        }
+
+        /**
+         * is_valid (method)
+         *
+         * This checks whether `adjacency` is numbered, i.e. whether it is not a self loop.
+         */
+        bool is_valid(const adjacency_t adjacency) const noexcept {
+            return adjacency.first != adjacency.second && adjacency.first < vertices_no && adjacency.second < vertices_no;
+        }
+
+        /**
+         * rank (method)
+         *
+         * This returns the number of `adjacency`.
+         *
+         * @pre is_valid(adjacency)
+         */
+        uint64_t rank(const adjacency_t adjacency) const noexcept {
+            return uint64_t(adjacency.first) * (vertices_no - 1) + adjacency.second - (adjacency.second > adjacency.first);
+        }
+
+        /**
+         * adjacency (method)
+         *
+         * This returns the adjacency numbered `rank`.
+         *
+         * @pre `rank` < size()
+         */
+        adjacency_t adjacency(const uint64_t rank) const noexcept {
+            const vid_t tail = static_cast<vid_t>(rank / (vertices_no - 1));
+            vid_t head = static_cast<vid_t>(rank - uint64_t(tail) * (vertices_no - 1));
+
+            if (head >= tail)
+                head++;
+            return {tail, head};
+        }
+
+        /**
+         * Decoder (type)
+         *
+         * This is the same as adjacency(), for runs of increasing ranks: it remembers the row of the last decoded
+         * adjacency (the ranks sharing its tail), so that ranks in that row or in the next one are decoded without any
+         * division. Any other rank falls back to adjacency().
+         */
+        class Decoder {
+        private:
+            const DirectedRanks& ranks;
+            uint64_t tail = 0;
+            uint64_t row_begin = 0, row_end = 0;
+
+        public:
+            explicit Decoder(const DirectedRanks& ranks) : ranks(ranks) { }
+
+            adjacency_t operator()(const uint64_t rank) noexcept {
+                const uint64_t row_size = ranks.vertices_no - 1;
+                if (rank < row_begin || rank >= row_end) {
+                    if (rank >= row_end && rank - row_end < row_size && row_end) {
+                        ++tail;
+                        row_begin = row_end;
+                    } else {
+                        tail = rank / row_size;
+                        row_begin = tail * row_size;
+                    }
+                    row_end = row_begin + row_size;
+                }
+
+                const uint64_t head = rank - row_begin;
+                return {static_cast<vid_t>(tail), static_cast<vid_t>(head + (head >= tail))};
+            }
+        };
+
+        /**
+         * decode (method)
+         *
+         * This writes to `out` the adjacencies numbered by the ranks in [first, last), and returns the end of the
+         * output. It is fastest when the ranks are sorted (see Decoder).
+         */
+        template<typename InputIt, typename OutputIt>
+        OutputIt decode(InputIt first, const InputIt last, OutputIt out) const {
+            Decoder decoder(*this);
+            for (; first != last; ++first)
+                *(out++) = decoder(*first);
+            return out;
+        }
+    };
+
+    /**
+     * UndirectedRanks (type)
+     *
+     * This numbers the pairs (u, v) with vertices_no > u > v, i.e. the canonical adjacencies of the edges of an
+     * undirected graph (or the adjacencies of a DAG oriented by the vertex numbering), from 0 to
+     * vertices_no * (vertices_no - 1) / 2 - 1. The adjacency (u, v) is numbered u * (u - 1) / 2 + v, which follows the
+     * lexicographical order of the adjacencies.
+     */
+    class UndirectedRanks {
+    private:
+        uint64_t vertices_no;
+
+    public:
+        explicit UndirectedRanks(const uint64_t vertices_no) : vertices_no(vertices_no) { }
+
+        /**
+         * size (method)
+         *
+         * This returns the number of valid adjacencies.
+         */
+        uint64_t size() const noexcept {
+            return vertices_no ? vertices_no * (vertices_no - 1) / 2 : 0;
+        }
+
+        /**
+         * is_valid (method)
+         *
+         * This checks whether `adjacency` is numbered, i.e. whether its first endpoint is bigger than the second.
+         */
+        bool is_valid(const adjacency_t adjacency) const noexcept {
+            return adjacency.first > adjacency.second && adjacency.first < vertices_no;
+        }
+
+        /**
+         * rank (method)
+         *
+         * This returns the number of `adjacency`.
+         *
+         * @pre is_valid(adjacency)
+         */
+        uint64_t rank(const adjacency_t adjacency) const noexcept {
+            return uint64_t(adjacency.first) * (adjacency.first - 1) / 2 + adjacency.second;
+        }
+
+        /**
+         * tail_of (method)
+         *
+         * This returns the first endpoint of the adjacency numbered `rank`, i.e. the biggest u such that
+         * u * (u - 1) / 2 is not bigger than `rank`. With s = isqrt(2 * rank), u is either s or s + 1: the result is
+         * exact for all the ranks of graphs with up to 2^32 vertices, with no intermediate overflow.
+         *
+         * @pre `rank` < size()
+         */
+        static uint64_t tail_of(const uint64_t rank) noexcept {
+            const uint64_t twice = 2 * rank;
+            const uint64_t root = detail::isqrt(twice);
+            return root + (root * (root + 1) <= twice);
+        }
+
+        /**
+         * adjacency (method)
+         *
+         * This returns the adjacency numbered `rank`.
+         *
+         * @pre `rank` < size()
+         */
+        adjacency_t adjacency(const uint64_t rank) const noexcept {
+            const uint64_t tail = tail_of(rank);
+            return {static_cast<vid_t>(tail), static_cast<vid_t>(rank - tail * (tail - 1) / 2)};
+        }
+
+        /**
+         * Decoder (type)
+         *
+         * This is the same as adjacency(), for runs of increasing ranks: it remembers the row of the last decoded
+         * adjacency (the ranks sharing its tail), so that ranks in that row or in the next one are decoded with an
+         * addition and a comparison. Any other rank falls back to tail_of().
+         */
+        class Decoder {
+        private:
+            uint64_t tail = 0;
+            uint64_t row_begin = 0, row_end = 0;
+
+        public:
+            explicit Decoder(const UndirectedRanks&) { }
+
+            adjacency_t operator()(const uint64_t rank) noexcept {
+                if (rank < row_begin || rank >= row_end) {
+                    if (rank >= row_end && rank - row_end <= tail) {
+                        row_begin = row_end;
+                        ++tail;
+                    } else {
+                        tail = tail_of(rank);
+                        row_begin = tail * (tail - 1) / 2;
+                    }
+                    row_end = row_begin + tail;
+                }
+                return {static_cast<vid_t>(tail), static_cast<vid_t>(rank - row_begin)};
+            }
+        };
+
+        /**
+         * decode (method)
+         *
+         * This writes to `out` the adjacencies numbered by the ranks in [first, last), and returns the end of the
+         * output. It is fastest when the ranks are sorted (see Decoder).
+         */
+        template<typename InputIt, typename OutputIt>
+        OutputIt decode(InputIt first, const InputIt last, OutputIt out) const {
+            Decoder decoder(*this);
+            for (; first != last; ++first)
+                *(out++) = decoder(*first);
+            return out;
+        }
+    };
+
+}
+
+#endif //KONIG_ADJACENCYRANKS_HPP
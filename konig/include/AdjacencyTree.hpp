@@ -1,12 +1,15 @@
 #ifndef KONIG_ADJACENCYTREE_HPP
 #define KONIG_ADJACENCYTREE_HPP
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <vector>
 #include <cassert>
 #include "util.hpp"
 #include "Exception.hpp"
+#include "NodePool.hpp"
+#include "Statistics.hpp"
 
 namespace konig {
     /**
@@ -18,8 +21,87 @@ namespace konig {
      */
     typedef std::pair<vid_t, vid_t> adjacency_t;
 
+    namespace detail {
+
+        /**
+         * sorted_batch (function)
+         *
+         * This copies the range [first, last) into a vector, sorting it (unless it already is) and removing duplicates.
+         */
+        template<typename InputIt>
+        std::vector<adjacency_t> sorted_batch(InputIt first, InputIt last) {
+            std::vector<adjacency_t> batch(first, last);
+
+            if (!std::is_sorted(batch.begin(), batch.end()))
+                std::sort(batch.begin(), batch.end());
+            batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+
+            return batch;
+        }
+    }
+
     /**
-     * AdjacencyTree (type)
+     * PointerNodeLayout (type)
+     *
+     * This is the default layout of the splay vertices of an AdjacencyTree: the vertices are linked by plain pointers
+     * and carved out of a NodePool. Vertices take 40 bytes each.
+     *
+     * A node layout defines the vertex type (with the `parent`, `left_child`, `right_child`, `subtree_size` and
+     * `adjacency` fields), the handle `vertex_t` used to link vertices (whose value-initialization is the null
+     * vertex), the pool which allocates them, and how to get a vertex out of its handle.
+     */
+    struct PointerNodeLayout {
+        struct AdjSplayVertex;
+        typedef AdjSplayVertex* vertex_t;
+        typedef NodePool<AdjSplayVertex> pool_t;
+
+        struct AdjSplayVertex {
+            vertex_t parent = NULL;
+            vertex_t left_child = NULL;
+            vertex_t right_child = NULL;
+            size_t subtree_size = 1;
+            adjacency_t adjacency;
+
+            explicit AdjSplayVertex(const adjacency_t adjacency) : adjacency(adjacency) { }
+        };
+
+        static AdjSplayVertex& at(const pool_t&, const vertex_t vertex) noexcept {
+            return *vertex;
+        }
+    };
+
+    /**
+     * CompactNodeLayout (type)
+     *
+     * This is the compact layout of the splay vertices of an AdjacencyTree: the vertices are linked by 32-bit indices
+     * into an IndexedNodePool, and the subtree sizes are 32-bit as well, so that a vertex takes 24 bytes (instead of
+     * 40), and twice as many fit in each cache line. Resolving a link costs a couple of bit operations more than
+     * following a pointer. A tree using this layout holds at most 2^32 - 1 adjacencies.
+     */
+    struct CompactNodeLayout {
+        typedef uint32_t vertex_t;
+
+        struct AdjSplayVertex {
+            vertex_t parent = 0;
+            vertex_t left_child = 0;
+            vertex_t right_child = 0;
+            uint32_t subtree_size = 1;
+            adjacency_t adjacency;
+
+            explicit AdjSplayVertex(const adjacency_t adjacency) : adjacency(adjacency) { }
+        };
+
+        typedef IndexedNodePool<AdjSplayVertex> pool_t;
+
+        static AdjSplayVertex& at(const pool_t& pool, const vertex_t vertex) noexcept {
+            return pool[vertex];
+        }
+    };
+
+    static_assert(sizeof(CompactNodeLayout::AdjSplayVertex) == 24, "compact splay vertices should take 24 bytes");
+
+    /**
+     * BasicAdjacencyTree (type)
      *
      * This is the heart of Konig. It provides a way to manage graph *adjacencies* (as opposed to edges),
      * allowing low-level operations such as:
@@ -30,123 +112,86 @@ namespace konig {
      *
      * It internally uses an augmented Splay Tree data structure, to efficiently support all the above mentioned
      * operations. The vertices are sorted in increasing lexicographical order with respect to the adjacencies (seen
-     * as pairs of vid_t types).
+     * as pairs of vid_t types). In order to support fast rank/select queries, each splay vertex also stores the size
+     * of the subtree rooted in it, which gives logarithmic-time random access to the structure.
+     *
+     * The splay vertices are not allocated one by one, but carved out of a pool: bulk insertions perform only a
+     * handful of allocations, erased vertices are recycled, and destroying the tree releases whole blocks at once. How
+     * the vertices are linked and allocated is decided by `layout_t` (see PointerNodeLayout and CompactNodeLayout).
+     *
+     * Every lookup splays the vertex it finds, so even queries restructure the tree. Once a tree is not going to be
+     * modified anymore, it can be frozen (see freeze()): it is then rebalanced, queries stop splaying, and any number
+     * of threads may query and iterate it concurrently. The const overloads of the query methods never splay either.
      *
      * Please notice that AdjacencyTree doesn't have any knowledge of high-level concepts such as adjacency weight,
      * or graph vertices. You can think of an AdjacencyTree simply as a ``container of pairs of vid_t types''.
      */
-    class AdjacencyTree {
+    template<typename layout_t>
+    class BasicAdjacencyTree {
 
         //////////////////////////
         // Subtypes             //
         //////////////////////////
 
     public:
+        typedef typename layout_t::AdjSplayVertex AdjSplayVertex;
 
-        /**
-         * AdjSplayVertex (type)
-         *
-         * This type represents the Splay Tree vertex model. In order to support fast rank/select queries,
-         * we augment the basic model with some information about the size of the subtree rooted in the current
-         * splay vertex. This allows us to have logarithmic-time random access to the structure.
-         */
-        class AdjSplayVertex {
-            friend class AdjacencyTree;
-
-            // Members
-        private:
-            // Node pointers
-            AdjSplayVertex* parent = NULL;
-            AdjSplayVertex* left_child = NULL;
-            AdjSplayVertex* right_child = NULL;
-
-            // BBST Augmentation
-            size_t subtree_size = 1;
-            size_t left_subtree_size = 0;
-
-        public:
-            adjacency_t adjacency;
-
-            // Methods
-        private:
-            /**
-             * update (method)
-             *
-             * This method is called whenever the children of the current vertex change, for example after a splay
-             * operation. It then updates the values of the augmented fields (such as subtree_size or left_subtree_size)
-             * so that the tree remains in a consistent state.
-             */
-            void update() noexcept {
-                subtree_size = 1;
-                left_subtree_size = 0;
-
-                if (left_child) {
-                    left_subtree_size = left_child->subtree_size;
-                    subtree_size += left_child->subtree_size;
-                }
-                if (right_child) {
-                    subtree_size += right_child->subtree_size;
-                }
-            }
-
-        public:
-            AdjSplayVertex(adjacency_t adjacency) : adjacency(adjacency) { }
-
-        };
+    private:
+        typedef typename layout_t::vertex_t vertex_t;
 
+    public:
         /**
          * iterator (type)
          *
          * This defines an std::iterator compliant random access iterator over the splay tree structure. It internally
-         * stores a pointer to the AdjSplayVertex storing the adjacency of interest.
+         * stores the handle of the AdjSplayVertex storing the adjacency of interest.
          *
          * As any random access iterator, this supports operator++/--, as well as efficient operator+/operator-.
+         * Unit steps follow the parent/child links of the tree without splaying it, so that a full in-order scan costs
+         * amortized O(1) per step; longer jumps go through the rank/select machinery instead.
          *
          * Since we need to call AdjacencyTree::advance in order to efficiently advance the iterator (see, for
-         * instance, operator+) we need to store a reference to the AdjacencyTree instance that forged the iterator.
+         * instance, operator+) we need to store a pointer to the AdjacencyTree instance that forged the iterator.
          */
         class iterator : public std::iterator<std::random_access_iterator_tag, adjacency_t> {
-            friend class AdjacencyTree;
+            friend class BasicAdjacencyTree;
 
             // Members
         private:
-            AdjacencyTree& adj_tree;
-            AdjSplayVertex* splay_vertex;
+            BasicAdjacencyTree* adj_tree;
+            vertex_t splay_vertex;
 
-            iterator(AdjacencyTree& adj_tree, AdjSplayVertex* splay_vertex)
+            iterator(BasicAdjacencyTree* adj_tree, vertex_t splay_vertex)
                     : adj_tree(adj_tree), splay_vertex(splay_vertex) { }
 
             // Methods
         public:
-            iterator(const iterator& other) : adj_tree(other.adj_tree), splay_vertex(other.splay_vertex) { }
-
-            iterator& operator=(const iterator& other) {
-                adj_tree = other.adj_tree;
-                splay_vertex = other.splay_vertex;
-
-                return *this;
-            }
+            iterator() : adj_tree(NULL), splay_vertex() { }
+            iterator(const iterator& other) = default;
+            iterator& operator=(const iterator& other) = default;
 
             std::ptrdiff_t operator-(const iterator& other) const {
 #ifdef KONIG_DEBUG
-                assert(&adj_tree == &other.adj_tree);
+                assert(adj_tree == other.adj_tree);
 #endif
-                std::ptrdiff_t this_rank = (splay_vertex) ? adj_tree._rank(splay_vertex) - 1 : adj_tree.size();
-                std::ptrdiff_t other_rank = (other.splay_vertex) ? adj_tree._rank(other.splay_vertex) - 1 : adj_tree.size();
+                KONIG_COUNT(TreeStatistics::Scope scope(adj_tree->tree_statistics, TreeStatistics::ITERATE,
+                                                        !adj_tree->frozen));
+                std::ptrdiff_t this_rank = (splay_vertex) ? adj_tree->_rank(splay_vertex) - 1 : adj_tree->size();
+                std::ptrdiff_t other_rank = (other.splay_vertex) ? adj_tree->_rank(other.splay_vertex) - 1 : adj_tree->size();
 
                 return this_rank - other_rank;
             }
 
             bool is_past_the_end() const {
-                return splay_vertex == NULL;
+                return splay_vertex == vertex_t();
             }
 
             adjacency_t& operator*() const noexcept {
-                return splay_vertex->adjacency;
+                return adj_tree->node(splay_vertex).adjacency;
             }
 
             adjacency_t* operator->() const noexcept {
-                return &(splay_vertex->adjacency);
+                return &(adj_tree->node(splay_vertex).adjacency);
             }
 
             const iterator& operator++() noexcept {
@@ -186,14 +231,22 @@ namespace konig {
             }
 
             iterator& operator+=(const std::ptrdiff_t increment) noexcept {
-                if (is_past_the_end()) {
-                    splay_vertex = adj_tree.tree_maximum();
+                if (increment == 1) {
+                    if (!is_past_the_end())
+                        splay_vertex = adj_tree->successor(splay_vertex);
+                } else if (increment == -1) {
+                    if (is_past_the_end())
+                        splay_vertex = adj_tree->tree_maximum();
+                    else
+                        splay_vertex = adj_tree->predecessor(splay_vertex);
+                } else if (is_past_the_end()) {
+                    splay_vertex = adj_tree->tree_maximum();
                     if (!is_past_the_end())
                         *this += increment + 1;
                 } else {
-                    splay_vertex = adj_tree.advance(splay_vertex, increment);
+                    splay_vertex = adj_tree->advance(splay_vertex, increment);
                 }
-                    return *this;
+                return *this;
             }
 
             iterator operator-(const std::ptrdiff_t decrement) const noexcept {
@@ -214,8 +267,12 @@ namespace konig {
         //////////////////////////
 
     private:
-        AdjSplayVertex* tree_root = NULL;
-        size_t tree_size = 0;
+        vertex_t tree_root = vertex_t();
+        typename layout_t::pool_t node_pool;
+        bool frozen = false;
+#ifdef KONIG_STATISTICS
+        TreeStatistics tree_statistics;
+#endif
 
 
 
@@ -227,11 +284,53 @@ namespace konig {
         /**
          * make_iterator (method)
          *
-         * This creates an iterator, given a pointer to an AdjSplayVertex.
+         * This creates an iterator, given the handle of an AdjSplayVertex.
+         */
+        iterator make_iterator(const vertex_t vertex) const noexcept {
+            auto self = const_cast<BasicAdjacencyTree*>(this);
+            return iterator(self, vertex);
+        }
+
+        /**
+         * node (method)
+         *
+         * This returns the splay vertex with the given handle.
+         *
+         * @pre `vertex` in *not* null
+         */
+        AdjSplayVertex& node(const vertex_t vertex) const noexcept {
+            return layout_t::at(node_pool, vertex);
+        }
+
+        vertex_t& parent_of(const vertex_t vertex) const noexcept {
+            return node(vertex).parent;
+        }
+
+        vertex_t& left_of(const vertex_t vertex) const noexcept {
+            return node(vertex).left_child;
+        }
+
+        vertex_t& right_of(const vertex_t vertex) const noexcept {
+            return node(vertex).right_child;
+        }
+
+        /**
+         * size_of (method)
+         *
+         * This returns the size of the subtree rooted in `vertex`, which is 0 if `vertex` is null.
          */
-        iterator make_iterator(AdjSplayVertex* const ptr) const noexcept {
-            auto self = const_cast<AdjacencyTree*>(this);
-            return iterator(*self, ptr);
+        size_t size_of(const vertex_t vertex) const noexcept {
+            return vertex ? node(vertex).subtree_size : 0;
+        }
+
+        /**
+         * update (method)
+         *
+         * This method is called whenever the children of `vertex` change, for example after a rotation. It then updates
+         * its subtree size so that the tree remains in a consistent state.
+         */
+        void update(const vertex_t vertex) noexcept {
+            node(vertex).subtree_size = 1 + size_of(left_of(vertex)) + size_of(right_of(vertex));
         }
 
         /**
@@ -239,11 +338,11 @@ namespace konig {
          *
          * This checks whether `vertex` is the current root of the splay tree.
          *
-         * @pre `vertex` in not NULL
+         * @pre `vertex` in not null
          */
-        bool is_root(AdjSplayVertex* const vertex) const noexcept {
+        bool is_root(const vertex_t vertex) const noexcept {
             assert(vertex);
-            return !vertex->parent;
+            return !parent_of(vertex);
         }
 
         /**
@@ -251,7 +350,7 @@ namespace konig {
          *
          * This returns the root of the tree.
          */
-        AdjSplayVertex* root() const noexcept {
+        vertex_t root() const noexcept {
 #ifdef KONIG_DEBUG
             if (tree_root)
                 assert(is_root(tree_root));
@@ -264,15 +363,15 @@ namespace konig {
          *
          * This checks whether `vertex` is a left child.
          *
-         * @pre `vertex` in *not* NULL
+         * @pre `vertex` in *not* null
          */
-        bool is_left_child(AdjSplayVertex* const vertex) const noexcept {
+        bool is_left_child(const vertex_t vertex) const noexcept {
 #ifdef KONIG_DEBUG
             assert(vertex);
 #endif
             if (is_root(vertex))
                 return false;
-            return vertex->parent->left_child == vertex;
+            return left_of(parent_of(vertex)) == vertex;
         }
 
         /**
@@ -280,15 +379,15 @@ namespace konig {
          *
          * This hecks whether `vertex` is a right child.
          *
-         * @pre `vertex` in *not* NULL
+         * @pre `vertex` in *not* null
          */
-        bool is_right_child(AdjSplayVertex* const vertex) const noexcept {
+        bool is_right_child(const vertex_t vertex) const noexcept {
 #ifdef KONIG_DEBUG
             assert(vertex);
 #endif
             if (is_root(vertex))
                 return false;
-            return vertex->parent->right_child == vertex;
+            return right_of(parent_of(vertex)) == vertex;
         }
 
         /**
@@ -296,15 +395,15 @@ namespace konig {
          *
          * This returns a pointer to the minimum-key vertex in the subtree rooted in `vertex`.
          *
-         * @pre `vertex` in *not* NULL
+         * @pre `vertex` in *not* null
          */
-        AdjSplayVertex* subtree_minimum(AdjSplayVertex* const vertex) const noexcept {
+        vertex_t subtree_minimum(const vertex_t vertex) const noexcept {
 #ifdef KONIG_DEBUG
             assert(vertex);
 #endif
             auto ans = vertex;
-            while (ans->left_child)
-                ans = ans->left_child;
+            while (left_of(ans))
+                ans = left_of(ans);
             return ans;
         }
 
@@ -313,49 +412,89 @@ namespace konig {
          *
          * This returns a pointer to the maximum-key vertex in the subtree rooted in `vertex`.
          *
-         * @pre `vertex` in *not* NULL
+         * @pre `vertex` in *not* null
          */
-        AdjSplayVertex* subtree_maximum(AdjSplayVertex* const vertex) const noexcept {
+        vertex_t subtree_maximum(const vertex_t vertex) const noexcept {
 #ifdef KONIG_DEBUG
             assert(vertex);
 #endif
             auto ans = vertex;
-            while (ans->right_child)
-                ans = ans->right_child;
+            while (right_of(ans))
+                ans = right_of(ans);
             return ans;
         }
 
+        /**
+         * successor (method)
+         *
+         * This returns a pointer to the vertex following `vertex` in the in-order visit of the tree, or NULL if
+         * `vertex` is the maximum. It only follows the tree links, without splaying.
+         *
+         * @pre `vertex` in *not* null
+         */
+        vertex_t successor(vertex_t vertex) const noexcept {
+#ifdef KONIG_DEBUG
+            assert(vertex);
+#endif
+            if (right_of(vertex))
+                return subtree_minimum(right_of(vertex));
+
+            while (is_right_child(vertex))
+                vertex = parent_of(vertex);
+            return parent_of(vertex);
+        }
+
+        /**
+         * predecessor (method)
+         *
+         * This returns a pointer to the vertex preceding `vertex` in the in-order visit of the tree, or NULL if
+         * `vertex` is the minimum. It only follows the tree links, without splaying.
+         *
+         * @pre `vertex` in *not* null
+         */
+        vertex_t predecessor(vertex_t vertex) const noexcept {
+#ifdef KONIG_DEBUG
+            assert(vertex);
+#endif
+            if (left_of(vertex))
+                return subtree_maximum(left_of(vertex));
+
+            while (is_left_child(vertex))
+                vertex = parent_of(vertex);
+            return parent_of(vertex);
+        }
+
         /**
          * rotate_right (method)
          *
          * This performs a right (clockwise) tree rotation around `vertex`.
 
-         * @pre `vertex` in *not* NULL
+         * @pre `vertex` in *not* null
          */
-        void rotate_right(AdjSplayVertex* const vertex) noexcept {
+        void rotate_right(const vertex_t vertex) noexcept {
 #ifdef KONIG_DEBUG
             assert(vertex);
 #endif
-            AdjSplayVertex* left_child = vertex->left_child;
+            vertex_t left_child = left_of(vertex);
 
             if (left_child) {
-                vertex->left_child = left_child->right_child;
-                if (left_child->right_child)
-                    left_child->right_child->parent = vertex;
-                left_child->parent = vertex->parent;
-                left_child->right_child = vertex;
+                left_of(vertex) = right_of(left_child);
+                if (right_of(left_child))
+                    parent_of(right_of(left_child)) = vertex;
+                parent_of(left_child) = parent_of(vertex);
+                right_of(left_child) = vertex;
             }
-            if (vertex->parent) {
+            if (parent_of(vertex)) {
                 if (is_left_child(vertex))
-                    vertex->parent->left_child = left_child;
+                    left_of(parent_of(vertex)) = left_child;
                 else
-                    vertex->parent->right_child = left_child;
+                    right_of(parent_of(vertex)) = left_child;
             }
-            vertex->parent = left_child;
+            parent_of(vertex) = left_child;
 
-            vertex->update();
+            update(vertex);
             if (left_child)
-                left_child->update();
+                update(left_child);
 
             if (is_root(left_child))
                 tree_root = left_child;
@@ -366,70 +505,83 @@ namespace konig {
          *
          * This performs a left (counterclockwise) tree rotation around `vertex`.
          *
-         * @pre `vertex` in *not* NULL
+         * @pre `vertex` in *not* null
          */
-        void rotate_left(AdjSplayVertex* const vertex) noexcept {
+        void rotate_left(const vertex_t vertex) noexcept {
 #ifdef KONIG_DEBUG
             assert(vertex);
 #endif
-            AdjSplayVertex* right_child = vertex->right_child;
+            vertex_t right_child = right_of(vertex);
 
             if (right_child) {
-                vertex->right_child = right_child->left_child;
-                if (right_child->left_child)
-                    right_child->left_child->parent = vertex;
-                right_child->parent = vertex->parent;
-                right_child->left_child = vertex;
+                right_of(vertex) = left_of(right_child);
+                if (left_of(right_child))
+                    parent_of(left_of(right_child)) = vertex;
+                parent_of(right_child) = parent_of(vertex);
+                left_of(right_child) = vertex;
             }
-            if (vertex->parent) {
+            if (parent_of(vertex)) {
                 if (is_left_child(vertex))
-                    vertex->parent->left_child = right_child;
+                    left_of(parent_of(vertex)) = right_child;
                 else
-                    vertex->parent->right_child = right_child;
+                    right_of(parent_of(vertex)) = right_child;
             }
-            vertex->parent = right_child;
+            parent_of(vertex) = right_child;
 
-            vertex->update();
+            update(vertex);
             if (right_child)
-                right_child->update();
+                update(right_child);
 
             if (is_root(right_child))
                 tree_root = right_child;
         }
 
+        /**
+         * depth (method)
+         *
+         * This returns the distance of `vertex` from the root.
+         */
+        uint64_t depth(vertex_t vertex) const noexcept {
+            uint64_t result = 0;
+            for (; parent_of(vertex); vertex = parent_of(vertex))
+                ++result;
+            return result;
+        }
+
         /**
          * splay (method)
          *
          * This reroots the splay tree in `vertex`.
          *
-         * @pre `vertex` in *not* NULL
+         * @pre `vertex` in *not* null
          */
-        void splay(AdjSplayVertex* const vertex) noexcept {
+        void splay(const vertex_t vertex) noexcept {
 #ifdef KONIG_DEBUG
             assert(vertex);
 #endif
+            KONIG_COUNT(tree_statistics.on_splay(depth(vertex)));
             while (!is_root(vertex)) {
-                if (is_root(vertex->parent)) { // Zig step
+                if (is_root(parent_of(vertex))) { // Zig step
                     if (is_left_child(vertex))
-                        rotate_right(vertex->parent);
+                        rotate_right(parent_of(vertex));
                     else
-                        rotate_left(vertex->parent);
+                        rotate_left(parent_of(vertex));
                 }
-                else if (is_left_child(vertex) && is_left_child(vertex->parent)) { // Zig-zig step (left)
-                    rotate_right(vertex->parent->parent);
-                    rotate_right(vertex->parent);
+                else if (is_left_child(vertex) && is_left_child(parent_of(vertex))) { // Zig-zig step (left)
+                    rotate_right(parent_of(parent_of(vertex)));
+                    rotate_right(parent_of(vertex));
                 }
-                else if (is_right_child(vertex) && is_right_child(vertex->parent)) { // Zig-zig step (right)
-                    rotate_left(vertex->parent->parent);
-                    rotate_left(vertex->parent);
+                else if (is_right_child(vertex) && is_right_child(parent_of(vertex))) { // Zig-zig step (right)
+                    rotate_left(parent_of(parent_of(vertex)));
+                    rotate_left(parent_of(vertex));
                 }
-                else if (is_left_child(vertex) && is_right_child(vertex->parent)) { // Zig-zag step (left-right)
-                    rotate_right(vertex->parent);
-                    rotate_left(vertex->parent);
+                else if (is_left_child(vertex) && is_right_child(parent_of(vertex))) { // Zig-zag step (left-right)
+                    rotate_right(parent_of(vertex));
+                    rotate_left(parent_of(vertex));
                 }
                 else { // Zig-zag step (right-left)
-                    rotate_left(vertex->parent);
-                    rotate_right(vertex->parent);
+                    rotate_left(parent_of(vertex));
+                    rotate_right(parent_of(vertex));
                 }
             }
             tree_root = vertex;
@@ -443,16 +595,16 @@ namespace konig {
          *
          *  @pre: `u` and `v` must be roots.
          */
-        void join(AdjSplayVertex* const u, AdjSplayVertex* const v) noexcept {
+        void join(const vertex_t u, const vertex_t v) noexcept {
 #ifdef KONIG_DEBUG
             assert(is_root(u) && is_root(v));
 #endif
             auto max_u = subtree_maximum(u);
 
             splay(max_u);
-            max_u->right_child = v;
-            v->parent = max_u;
-            max_u->update();
+            right_of(max_u) = v;
+            parent_of(v) = max_u;
+            update(max_u);
 
             tree_root = max_u;
         }
@@ -461,14 +613,17 @@ namespace konig {
          * split (method)
          *
          * This splits the tree at `vertex`, and creates two trees, one containing all vertices up to `vertex`
-         * (inclusive), and the other containing vertices from `successor(vertex)` onwards.
+         * (inclusive), and the other containing vertices from `successor(vertex)` onwards. It returns the root of the
+         * latter (possibly null).
          */
-        void split(AdjSplayVertex* const vertex) noexcept {
+        vertex_t split(const vertex_t vertex) noexcept {
             splay(vertex);
-            if (vertex->right_child)
-                vertex->right_child->parent = NULL;
-            vertex->right_child = NULL;
-            vertex->update();
+            const vertex_t right = right_of(vertex);
+            if (right)
+                parent_of(right) = vertex_t();
+            right_of(vertex) = vertex_t();
+            update(vertex);
+            return right;
         }
 
         /**
@@ -476,11 +631,11 @@ namespace konig {
          *
          * This returns a pointer to the minimum (leftmost) adjacency stored in the splay tree.
          */
-        AdjSplayVertex* tree_minimum() const noexcept {
+        vertex_t tree_minimum() const noexcept {
             if (root())
                 return subtree_minimum(root());
             else
-                return NULL;
+                return vertex_t();
         }
 
         /**
@@ -488,11 +643,11 @@ namespace konig {
          *
          * This returns a pointer to the maximum (rightmost) adjacency stored in the splay tree.
          */
-        AdjSplayVertex* tree_maximum() const noexcept {
+        vertex_t tree_maximum() const noexcept {
             if (root())
                 return subtree_maximum(root());
             else
-                return NULL;
+                return vertex_t();
         }
 
         /**
@@ -500,37 +655,60 @@ namespace konig {
          *
          * This returns the rank of `vertex`.
          *
-         * As it is an internal function, working with raw pointers instead of iterators, it begins with an underscore.
+         * As it is an internal function, working with vertex handles instead of iterators, it begins with an underscore.
          *
-         * @pre `vertex` in *not* NULL
+         * @pre `vertex` in *not* null
          */
-        size_t _rank(AdjSplayVertex* vertex) noexcept {
+        size_t _rank(vertex_t vertex) noexcept {
 #ifdef KONIG_DEBUG
             assert(vertex);
 #endif
+            if (frozen)
+                return _locate_rank(vertex);
+
             splay(vertex);
-            return 1 + vertex->left_subtree_size;
+            return 1 + size_of(left_of(vertex));
         }
 
         /**
-         * select (method)
+         * _locate_rank (method)
+         *
+         * This returns the rank of `vertex` without splaying it, by walking up to the root.
+         *
+         * As it is an internal function, working with vertex handles instead of iterators, it begins with an underscore.
+         *
+         * @pre `vertex` in *not* null
+         */
+        size_t _locate_rank(vertex_t vertex) const noexcept {
+#ifdef KONIG_DEBUG
+            assert(vertex);
+#endif
+            size_t rank = 1 + size_of(left_of(vertex));
+            for (; !is_root(vertex); vertex = parent_of(vertex))
+                if (is_right_child(vertex))
+                    rank += 1 + size_of(left_of(parent_of(vertex)));
+            return rank;
+        }
+
+        /**
+         * _select (method)
          *
          * This returns the vertex whose rank is equal to `rank`.
          *
-         * As it is an internal function, working with raw pointers instead of iterators, it begins with an underscore.
+         * As it is an internal function, working with vertex handles instead of iterators, it begins with an underscore.
          */
-        AdjSplayVertex* _select(std::ptrdiff_t rank) noexcept {
+        vertex_t _select(std::ptrdiff_t rank) const noexcept {
             if (rank <= 0 || rank > static_cast<std::ptrdiff_t>(size()))
-                return NULL;
+                return vertex_t();
 
             auto vertex = root();
             while (vertex && rank) {
-                std::ptrdiff_t lss = vertex->left_subtree_size;
+                std::ptrdiff_t lss = size_of(left_of(vertex));
                 if (lss >= rank) {
-                    vertex = vertex->left_child;
+                    vertex = left_of(vertex);
                 } else if (lss < rank - 1) {
-                    rank -= 1 + vertex->left_subtree_size;
-                    vertex = vertex->right_child;
+                    rank -= 1 + size_of(left_of(vertex));
+                    vertex = right_of(vertex);
                 } else {
                     rank = 0;
                 }
@@ -543,65 +721,92 @@ namespace konig {
          *
          * This returns the pointer to the vertex whose rank is `rank(vertex) + delta`.
          *
-         * @pre `vertex` in *not* NULL
+         * @pre `vertex` in *not* null
          */
-        AdjSplayVertex* advance(AdjSplayVertex* vertex, std::ptrdiff_t delta) noexcept {
+        vertex_t advance(vertex_t vertex, std::ptrdiff_t delta) noexcept {
 #ifdef KONIG_DEBUG
             assert(vertex);
 #endif
+            KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::ITERATE, !frozen));
             return _select(_rank(vertex) + delta);
         }
 
         /**
-         * _lower_bound (method)
+         * _locate_lower_bound (method)
          *
-         * This returns the leftmost node that evaluates as >= adjacency.
+         * This returns the leftmost node that evaluates as >= adjacency, without splaying it.
          *
-         * As it is an internal function, working with raw pointers instead of iterators, it begins with an underscore.
+         * As it is an internal function, working with vertex handles instead of iterators, it begins with an underscore.
          */
-        AdjSplayVertex* _lower_bound(adjacency_t adjacency) noexcept {
-            AdjSplayVertex* vertex = root();
-            AdjSplayVertex* cut_point = NULL;
+        vertex_t _locate_lower_bound(adjacency_t adjacency) const noexcept {
+            vertex_t vertex = root();
+            vertex_t cut_point = vertex_t();
 
             while (vertex) {
-                if (vertex->adjacency >= adjacency) {
+                if (node(vertex).adjacency >= adjacency) {
                     cut_point = vertex;
 
-                    if (vertex->adjacency == adjacency) // There are no duplicates in this structure
+                    if (node(vertex).adjacency == adjacency) // There are no duplicates in this structure
                         break;
                     else
-                        vertex = vertex->left_child;
+                        vertex = left_of(vertex);
                 } else {
-                    vertex = vertex->right_child;
+                    vertex = right_of(vertex);
                 }
             }
 
-            if (cut_point)
-                splay(cut_point);
             return cut_point;
         }
 
         /**
-         * _upper_bound (method)
+         * _locate_upper_bound (method)
          *
-         * This returns the leftmost node that evaluates as > adjacency.
+         * This returns the leftmost node that evaluates as > adjacency, without splaying it.
          *
-         * As it is an internal function, working with raw pointers instead of iterators, it begins with an underscore.
+         * As it is an internal function, working with vertex handles instead of iterators, it begins with an underscore.
          */
-        AdjSplayVertex* _upper_bound(adjacency_t adjacency) noexcept {
-            AdjSplayVertex* vertex = root();
-            AdjSplayVertex* cut_point = NULL;
+        vertex_t _locate_upper_bound(adjacency_t adjacency) const noexcept {
+            vertex_t vertex = root();
+            vertex_t cut_point = vertex_t();
 
             while (vertex) {
-                if (vertex->adjacency > adjacency) {
+                if (node(vertex).adjacency > adjacency) {
                     cut_point = vertex;
-                    vertex = vertex->left_child;
+                    vertex = left_of(vertex);
                 } else {
-                    vertex = vertex->right_child;
+                    vertex = right_of(vertex);
                 }
             }
 
-            if (cut_point)
+            return cut_point;
+        }
+
+        /**
+         * _lower_bound (method)
+         *
+         * This returns the leftmost node that evaluates as >= adjacency, and splays it (unless the tree is frozen).
+         *
+         * As it is an internal function, working with vertex handles instead of iterators, it begins with an underscore.
+         */
+        vertex_t _lower_bound(adjacency_t adjacency) noexcept {
+            vertex_t cut_point = _locate_lower_bound(adjacency);
+
+            if (cut_point && !frozen)
+                splay(cut_point);
+            return cut_point;
+        }
+
+        /**
+         * _upper_bound (method)
+         *
+         * This returns the leftmost node that evaluates as > adjacency, and splays it (unless the tree is frozen).
+         *
+         * As it is an internal function, working with vertex handles instead of iterators, it begins with an underscore.
+         */
+        vertex_t _upper_bound(adjacency_t adjacency) noexcept {
+            vertex_t cut_point = _locate_upper_bound(adjacency);
+
+            if (cut_point && !frozen)
                 splay(cut_point);
             return cut_point;
         }
@@ -611,48 +816,113 @@ namespace konig {
          *
          * This is the same as _lower_bound.
          *
-         * As it is an internal function, working with raw pointers instead of iterators, it begins with an underscore.
+         * As it is an internal function, working with vertex handles instead of iterators, it begins with an underscore.
          */
-        AdjSplayVertex* _find(adjacency_t adjacency) noexcept {
+        vertex_t _find(adjacency_t adjacency) noexcept {
             return _lower_bound(adjacency);
         }
 
         /**
          * _insert (method)
          *
-         * This creates a new vertex corresponding to the given adjacency, and inserts it in the tree. It then returns
-         * the pointer to the newly created vertex.
+         * This inserts the given adjacency in the tree, unless it is already there. It returns the pointer to the vertex
+         * holding the adjacency, and whether a new vertex has been created.
+         *
+         * The position of the new vertex is found with a single descent from the root: the vertex is attached as a leaf
+         * and then splayed, exactly as the vertex found would be if the adjacency already exists.
          *
-         * As it is an internal function, working with raw pointers instead of iterators, it begins with an underscore.
+         * As it is an internal function, working with vertex handles instead of iterators, it begins with an underscore.
          */
-        AdjSplayVertex* _insert(adjacency_t adjacency) noexcept {
-            if (has(adjacency)) {
-                return _find(adjacency);
-            }
+        std::pair<vertex_t, bool> _insert(adjacency_t adjacency) {
+            vertex_t vertex = root();
+            vertex_t parent = vertex_t();
 
-            AdjSplayVertex* new_vertex = new AdjSplayVertex(adjacency);
+            while (vertex) {
+                if (node(vertex).adjacency == adjacency) {
+                    splay(vertex);
+                    return {vertex, false};
+                }
 
-            if (root()) {
-                auto cut_point = _lower_bound(adjacency);
+                parent = vertex;
+                vertex = (adjacency < node(vertex).adjacency) ? left_of(vertex) : right_of(vertex);
+            }
 
-                if (cut_point) {
-                    auto prev = advance(cut_point, -1);
-                    if (prev) {
-                        split(prev);
-                        join(new_vertex, cut_point);
-                        join(prev, new_vertex);
-                    } else {
-                        join(new_vertex, cut_point);
-                    }
-                } else {
-                    join(root(), new_vertex);
-                }
+            vertex_t new_vertex = node_pool.create(adjacency);
+            KONIG_COUNT(tree_statistics.on_allocation());
 
-                assert(is_root(root()));
+            if (parent) {
+                parent_of(new_vertex) = parent;
+                if (adjacency < node(parent).adjacency)
+                    left_of(parent) = new_vertex;
+                else
+                    right_of(parent) = new_vertex;
             }
 
+            // There is no need to fix the subtree sizes along the search path here: every vertex on the path is rotated
+            // by the splay below, which recomputes its augmented fields from children that are already up to date.
+
             splay(new_vertex);
-            return new_vertex;
+            return {new_vertex, true};
+        }
+
+        /**
+         * build_balanced (method)
+         *
+         * This links the `count` vertices pointed by `vertices` (which must be sorted by adjacency) into a perfectly
+         * balanced tree hanging from `parent`, and returns its root. The augmented fields are filled bottom-up, so the
+         * whole construction takes linear time.
+         */
+        vertex_t build_balanced(const vertex_t* vertices, const size_t count,
+                                       const vertex_t parent) noexcept {
+            if (!count)
+                return vertex_t();
+
+            const size_t middle = count / 2;
+            vertex_t vertex = vertices[middle];
+
+            parent_of(vertex) = parent;
+            left_of(vertex) = build_balanced(vertices, middle, vertex);
+            right_of(vertex) = build_balanced(vertices + middle + 1, count - middle - 1, vertex);
+            update(vertex);
+
+            return vertex;
+        }
+
+        /**
+         * merge_sorted (method)
+         *
+         * This merges a sorted, duplicate-free batch of adjacencies into the tree, and then rebuilds it as a perfectly
+         * balanced tree in O(size() + batch.size()) time. Existing vertices are relinked rather than reallocated, so
+         * iterators to adjacencies already in the tree stay valid.
+         */
+        void merge_sorted(const std::vector<adjacency_t>& batch) {
+            std::vector<vertex_t> vertices;
+            vertices.reserve(size() + batch.size());
+            node_pool.reserve(batch.size());
+
+            auto batch_it = batch.begin();
+            for (auto vertex = tree_minimum(); vertex; vertex = successor(vertex)) {
+                for (; batch_it != batch.end() && *batch_it < node(vertex).adjacency; ++batch_it)
+                    vertices.push_back(node_pool.create(*batch_it));
+                if (batch_it != batch.end() && *batch_it == node(vertex).adjacency)
+                    ++batch_it;
+                vertices.push_back(vertex);
+            }
+            for (; batch_it != batch.end(); ++batch_it)
+                vertices.push_back(node_pool.create(*batch_it));
+            KONIG_COUNT(tree_statistics.on_allocation(vertices.size() - size()));
+
+            tree_root = build_balanced(vertices.data(), vertices.size(), vertex_t());
+        }
+
+        /**
+         * ensure_mutable (method)
+         *
+         * This throws if the tree is frozen. It is called by all the methods that modify the content of the tree.
+         */
+        void ensure_mutable() const {
+            if (frozen)
+                throw StructureViolation(context_info("the AdjacencyTree is frozen"));
         }
 
         /**
@@ -660,49 +930,181 @@ namespace konig {
          *
          * It deletes `vertex` from the tree.
          *
-         * As it is an internal function, working with raw pointers instead of iterators, it begins with an underscore.
+         * As it is an internal function, working with vertex handles instead of iterators, it begins with an underscore.
          */
-        void _erase(AdjSplayVertex* vertex) noexcept {
+        void _erase(vertex_t vertex) noexcept {
             if (!vertex)
                 return;
 
             splay(vertex);
-            if (!vertex->left_child) {
-                if (vertex->right_child)
-                    vertex->right_child->parent = NULL;
+            if (!left_of(vertex)) {
+                if (right_of(vertex))
+                    parent_of(right_of(vertex)) = vertex_t();
 
-                tree_root = vertex->right_child;
+                tree_root = right_of(vertex);
             }
-            else if (!vertex->right_child) {
-                if (vertex->left_child)
-                    vertex->left_child->parent = NULL;
+            else if (!right_of(vertex)) {
+                if (left_of(vertex))
+                    parent_of(left_of(vertex)) = vertex_t();
 
-                tree_root = vertex->left_child;
+                tree_root = left_of(vertex);
             }
             else {
-                vertex->left_child->parent = NULL;
-                vertex->right_child->parent = NULL;
+                parent_of(left_of(vertex)) = vertex_t();
+                parent_of(right_of(vertex)) = vertex_t();
 
-                join(vertex->left_child, vertex->right_child);
-                vertex->left_child = vertex->right_child = NULL;
+                join(left_of(vertex), right_of(vertex));
+                left_of(vertex) = right_of(vertex) = vertex_t();
             }
 
-            assert(is_root(root()));
-            delete vertex;
+            assert(!root() || is_root(root()));
+            node_pool.destroy(vertex);
+        }
+
+        /**
+         * destroy_subtree (method)
+         *
+         * This gives back to the pool all the vertices of the detached tree rooted in `vertex`, visiting it with an
+         * explicit stack (each vertex is released only after its children have been read).
+         */
+        void destroy_subtree(const vertex_t vertex) {
+            std::vector<vertex_t> stack;
+            if (vertex)
+                stack.push_back(vertex);
+            while (!stack.empty()) {
+                const vertex_t top = stack.back();
+                stack.pop_back();
+                if (left_of(top))
+                    stack.push_back(left_of(top));
+                if (right_of(top))
+                    stack.push_back(right_of(top));
+                node_pool.destroy(top);
+            }
         }
 
-        void recursive_delete(const AdjSplayVertex* vertex) noexcept {
-            if (vertex) {
-                recursive_delete(vertex->left_child);
-                recursive_delete(vertex->right_child);
-                delete vertex;
+        /**
+         * _erase_range (method)
+         *
+         * It deletes the vertices from `first` (inclusive) to `last` (exclusive, null meaning the end of the tree)
+         * with two splits and a join, and then releases them.
+         *
+         * As it is an internal function, working with vertex handles instead of iterators, it begins with an underscore.
+         */
+        void _erase_range(const vertex_t first, const vertex_t last) {
+            if (first == last)
+                return;
+
+            // The vertices around the range are found right after splaying their neighbour, which pays for the descent
+            splay(first);
+            const vertex_t before = left_of(first) ? subtree_maximum(left_of(first)) : vertex_t();
+            vertex_t until;
+            if (last) {
+                splay(last);
+                until = subtree_maximum(left_of(last));
+            } else {
+                until = tree_maximum();
             }
+
+            const vertex_t after = split(until);
+            vertex_t doomed = until;
+            if (before) {
+                doomed = split(before);
+                if (after)
+                    join(before, after);
+            } else {
+                tree_root = after;
+            }
+
+            destroy_subtree(doomed);
         }
 
 
     public:
-        ~AdjacencyTree() {
-            recursive_delete(root());
+        BasicAdjacencyTree() = default;
+        BasicAdjacencyTree(const BasicAdjacencyTree&) = delete;
+        BasicAdjacencyTree& operator=(const BasicAdjacencyTree&) = delete;
+
+        /**
+         * BasicAdjacencyTree (constructor)
+         *
+         * This builds a balanced tree out of the adjacencies in [first, last) in linear time (plus the time needed to
+         * sort them, if they are not sorted already). Duplicates are removed.
+         */
+        template<typename InputIt>
+        BasicAdjacencyTree(InputIt first, InputIt last) {
+            assign(first, last);
+        }
+
+        /**
+         * assign (method)
+         *
+         * This replaces the content of the tree with the adjacencies in [first, last), building a balanced tree in
+         * linear time (plus the time needed to sort them, if they are not sorted already). Duplicates are removed.
+         * All the iterators are invalidated.
+         */
+        template<typename InputIt>
+        void assign(InputIt first, InputIt last) {
+            ensure_mutable();
+            KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::BATCH_INSERT));
+            const auto batch = detail::sorted_batch(first, last);
+
+            clear();
+            merge_sorted(batch);
+        }
+
+        /**
+         * reserve (method)
+         *
+         * This preallocates room for `adjacencies` more adjacencies, so that the following insertions don't need to
+         * allocate memory.
+         */
+        void reserve(const size_t adjacencies) {
+            node_pool.reserve(adjacencies);
+        }
+
+        /**
+         * clear (method)
+         *
+         * This removes all the adjacencies from the structure, releasing their memory in bulk. All the iterators are
+         * invalidated.
+         */
+        void clear() {
+            ensure_mutable();
+            tree_root = vertex_t();
+            node_pool.clear();
+        }
+
+        /**
+         * freeze (method)
+         *
+         * This rebalances the tree in linear time and marks it as read-only: from now on, queries don't splay (and so
+         * take O(log n) worst-case time), the tree can be safely shared by concurrent readers, and any attempt to modify
+         * it throws StructureViolation, until thaw() is called.
+         */
+        void freeze() {
+            if (!frozen) {
+                KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::BATCH_INSERT));
+                merge_sorted(std::vector<adjacency_t>());
+                frozen = true;
+            }
+        }
+
+        /**
+         * thaw (method)
+         *
+         * This makes a frozen tree modifiable again.
+         */
+        void thaw() noexcept {
+            frozen = false;
+        }
+
+        /**
+         * is_frozen (method)
+         *
+         * This checks whether the tree is frozen.
+         */
+        bool is_frozen() const noexcept {
+            return frozen;
         }
 
         /**
@@ -710,7 +1112,7 @@ namespace konig {
          *
          * This returns an iterator to the first adjacency stored in the structure.
          */
-        iterator begin() {
+        iterator begin() const {
             return make_iterator(tree_minimum());
         }
 
@@ -719,8 +1121,8 @@ namespace konig {
          *
          * This returns an iterator corresponding to the past-the-end element of the structure.
          */
-        iterator end() {
-            return make_iterator(NULL);
+        iterator end() const {
+            return make_iterator(vertex_t());
         }
 
         /**
@@ -732,94 +1134,277 @@ namespace konig {
             if (!root())
                 return 0;
             else
-                return root()->subtree_size;
+                return size_of(root());
         }
 
         /**
-         * lower_bound (method)
+         * lower_bound (overloaded method)
          *
          * This returns an iterator to the first (leftmost) adjacency that evaluates as >= `adjacency`.
          *
          * @note: it is not required that `adjacency` belongs to the structure.
          */
         iterator lower_bound(const adjacency_t adjacency) noexcept {
+            KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::FIND, !frozen));
             return make_iterator(_lower_bound(adjacency));
         }
 
         /**
-         * find (method)
+         * lower_bound (overloaded method)
+         *
+         * This is the same as the non-const overload, but never splays.
+         */
+        iterator lower_bound(const adjacency_t adjacency) const noexcept {
+            return make_iterator(_locate_lower_bound(adjacency));
+        }
+
+        /**
+         * find (overloaded method)
          *
          * This returns end() if the adjacency does not exist, or an iterator to the adjacency otherwise.
          */
         iterator find(const adjacency_t adjacency) noexcept {
-            if (has(adjacency))
-                return make_iterator(_find(adjacency));
+            KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::FIND, !frozen));
+            auto key_lower_bound = _lower_bound(adjacency);
+
+            if (key_lower_bound && node(key_lower_bound).adjacency == adjacency)
+                return make_iterator(key_lower_bound);
             else
                 return end();
         }
 
         /**
-         * upper_bound (method)
+         * find (overloaded method)
+         *
+         * This is the same as the non-const overload, but never splays.
+         */
+        iterator find(const adjacency_t adjacency) const noexcept {
+            auto key_lower_bound = _locate_lower_bound(adjacency);
+
+            if (key_lower_bound && node(key_lower_bound).adjacency == adjacency)
+                return make_iterator(key_lower_bound);
+            else
+                return end();
+        }
+
+        /**
+         * upper_bound (overloaded method)
          *
          * This returns an iterator to the first (leftmost) adjacency that evaluates as > `adjacency`.
          *
          * @note: it is not required that `adjacency` belongs to the structure.
          */
         iterator upper_bound(const adjacency_t adjacency) noexcept {
+            KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::FIND, !frozen));
             return make_iterator(_upper_bound(adjacency));
         }
 
         /**
-         * insert (method)
+         * upper_bound (overloaded method)
          *
-         * This inserts the given adjacency in the tree and returns an iterator to the inserted adjacency.
+         * This is the same as the non-const overload, but never splays.
          */
-        iterator insert(const adjacency_t adjacency) noexcept {
-            return make_iterator(_insert(adjacency));
+        iterator upper_bound(const adjacency_t adjacency) const noexcept {
+            return make_iterator(_locate_upper_bound(adjacency));
         }
 
         /**
-         * erase (method)
+         * insert (overloaded method)
+         *
+         * This inserts the given adjacency in the tree. Just like std::set::insert, it returns an iterator to the
+         * adjacency, together with a bool telling whether the adjacency has been inserted (true) or was already in the
+         * tree (false).
          */
-        void erase(const iterator it) noexcept {
+        std::pair<iterator, bool> insert(const adjacency_t adjacency) {
+            ensure_mutable();
+            KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::INSERT));
+            const auto result = _insert(adjacency);
+            return {make_iterator(result.first), result.second};
+        }
+
+        /**
+         * insert (overloaded method)
+         *
+         * This inserts all the adjacencies in [first, last), ignoring those already in the tree. Small batches are
+         * inserted one at a time, while big ones are merged with the current content of the tree, which is then rebuilt
+         * balanced in O(size() + batch size). Iterators to the adjacencies already in the tree stay valid.
+         */
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            ensure_mutable();
+            KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::BATCH_INSERT));
+            const auto batch = detail::sorted_batch(first, last);
+
+            size_t log_size = 1;
+            while ((size_t(1) << log_size) <= size())
+                ++log_size;
+
+            if (batch.size() * log_size < size()) {
+                for (const auto& adjacency : batch)
+                    _insert(adjacency);
+            } else {
+                merge_sorted(batch);
+            }
+        }
+
+        /**
+         * erase (overloaded method)
+         *
+         * This deletes the adjacency pointed by `it`.
+         */
+        void erase(const iterator it) {
+            ensure_mutable();
+            KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::ERASE));
             return _erase(it.splay_vertex);
         }
 
         /**
-         * rank (method)
+         * erase (overloaded method)
+         *
+         * This deletes all the adjacencies in [first, last): the range is cut out with two splits and a join, in
+         * O(log n) amortized time, and then its k vertices are given back to the pool in O(k). Iterators to the other
+         * adjacencies stay valid.
+         */
+        void erase(const iterator first, const iterator last) {
+            ensure_mutable();
+            KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::ERASE));
+            _erase_range(first.splay_vertex, last.splay_vertex);
+        }
+
+        /**
+         * split_at (method)
+         *
+         * This moves the adjacencies from `it` onwards to `other`, whose previous content is dropped. Since every tree
+         * allocates its vertices from its own pool, the moved adjacencies are copied into a balanced tree in linear
+         * time, and then cut out of this tree as in erase(it, end()).
+         */
+        void split_at(const iterator it, BasicAdjacencyTree& other) {
+            if (&other == this)
+                throw InvalidArgument(context_info("a tree cannot be split into itself"));
+            ensure_mutable();
+            other.assign(it, end());
+            erase(it, end());
+        }
+
+        /**
+         * merge (method)
+         *
+         * This moves all the adjacencies of `other` into this tree, leaving `other` empty. When they all follow the
+         * adjacencies of this tree (as when merging back the two halves of split_at), they are copied into a balanced
+         * tree, which is joined to this one in O(log n) amortized time; otherwise, they are inserted as a batch.
+         */
+        void merge(BasicAdjacencyTree& other) {
+            if (&other == this)
+                return;
+            ensure_mutable();
+            other.ensure_mutable();
+            KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::BATCH_INSERT));
+
+            const vertex_t other_minimum = other.tree_minimum();
+            if (!other_minimum)
+                return;
+            if (root() && !(node(tree_maximum()).adjacency < other.node(other_minimum).adjacency)) {
+                insert(other.begin(), other.end());
+            } else {
+                std::vector<vertex_t> vertices;
+                vertices.reserve(other.size());
+                node_pool.reserve(other.size());
+                for (vertex_t vertex = other_minimum; vertex; vertex = other.successor(vertex))
+                    vertices.push_back(node_pool.create(other.node(vertex).adjacency));
+                KONIG_COUNT(tree_statistics.on_allocation(vertices.size()));
+
+                const vertex_t appended = build_balanced(vertices.data(), vertices.size(), vertex_t());
+                if (root())
+                    join(root(), appended);
+                else
+                    tree_root = appended;
+            }
+            other.clear();
+        }
+
+        /**
+         * rank (overloaded method)
          *
          * This returns the rank of the adjacency represented by the supplied iterator.
          *
          * @pre: the iterator *must* be valid, i.e. point to a valid instance of AdjSplayVertex.
          */
         size_t rank(const iterator it) noexcept {
+            KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::RANK, !frozen));
             return _rank(it.splay_vertex);
         }
 
         /**
-         * select (method)
+         * rank (overloaded method)
          *
-         * This returns the adjacency given its rank.
+         * This is the same as the non-const overload, but never splays.
+         */
+        size_t rank(const iterator it) const noexcept {
+            return _locate_rank(it.splay_vertex);
+        }
+
+        /**
+         * select (overloaded method)
          *
+         * This returns the adjacency given its rank, and splays it (unless the tree is frozen), which pays for the
+         * descent: long sequences of select queries stay O(log n) amortized each, however unbalanced the tree was.
          */
         iterator select(const size_t rank) noexcept {
-            return make_iterator(_select(rank));
+            KONIG_COUNT(TreeStatistics::Scope scope(tree_statistics, TreeStatistics::RANK, !frozen));
+            const vertex_t vertex = _select(rank);
+            if (vertex && !frozen)
+                splay(vertex);
+            return make_iterator(vertex);
         }
 
+        /**
+         * select (overloaded method)
+         *
+         * This is the same as the non-const overload, but never splays.
+         */
+        iterator select(const size_t rank) const noexcept {
+            return make_iterator(_select(rank));
+        }
 
         /**
-         * has (method)
+         * has (overloaded method)
          *
          * This checks whether the tree contains a vertex corresponding to `adjacency`.
          */
         bool has(adjacency_t adjacency) noexcept {
-            auto key_lower_bound = _lower_bound(adjacency);
+            return find(adjacency) != end();
+        }
+
+        /**
+         * has (overloaded method)
+         *
+         * This is the same as the non-const overload, but never splays.
+         */
+        bool has(adjacency_t adjacency) const noexcept {
+            return find(adjacency) != end();
+        }
 
-            return (key_lower_bound && key_lower_bound->adjacency == adjacency);
+#ifdef KONIG_STATISTICS
+        /**
+         * statistics (method)
+         *
+         * This returns the counters collected by the tree (see TreeStatistics). It is only available when
+         * KONIG_STATISTICS is defined.
+         */
+        const TreeStatistics& statistics() const noexcept {
+            return tree_statistics;
         }
 
+        void reset_statistics() noexcept {
+            tree_statistics.reset();
+        }
+#endif
+
     };
 
+    typedef BasicAdjacencyTree<PointerNodeLayout> AdjacencyTree;
+    typedef BasicAdjacencyTree<CompactNodeLayout> CompactAdjacencyTree;
+
 }
 
 #endif //KONIG_ADJACENCYTREE_HPP
\ No newline at end of file
@@ -0,0 +1,270 @@
+#ifndef KONIG_COMPRESSEDSPARSEROW_HPP
+#define KONIG_COMPRESSEDSPARSEROW_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "util.hpp"
+#include "Exception.hpp"
+#include "AdjacencyTree.hpp"
+
+namespace konig {
+
+    /**
+     * CompressedSparseRow (type)
+     *
+     * This is a read-only, compact snapshot of a set of adjacencies, in the classical compressed sparse row layout:
+     * the second endpoints of all the adjacencies are stored contiguously in `targets`, sorted by first endpoint (and
+     * then by second endpoint), and the neighbourhood of the vertex `v` is the slice [offsets[v], offsets[v + 1]) of
+     * `targets`.
+     *
+     * Compared to an AdjacencyTree it takes 4 bytes per adjacency (plus 8 bytes per vertex), and scanning it is a
+     * linear walk over contiguous memory. It is meant to be built once the generation is over (for instance with
+     * AdjacencyManager::to_csr) and then read by algorithms and writers.
+     */
+    class CompressedSparseRow {
+
+        //////////////////////////
+        // Subtypes             //
+        //////////////////////////
+    public:
+        /**
+         * neighbourhood (type)
+         *
+         * This is a contiguous range of vid_t, representing the second endpoints of the adjacencies of a vertex.
+         */
+        class neighbourhood {
+            const vid_t* first;
+            const vid_t* last;
+
+        public:
+            neighbourhood(const vid_t* first, const vid_t* last) : first(first), last(last) { }
+
+            const vid_t* begin() const noexcept {
+                return first;
+            }
+
+            const vid_t* end() const noexcept {
+                return last;
+            }
+
+            size_t size() const noexcept {
+                return last - first;
+            }
+
+            bool empty() const noexcept {
+                return first == last;
+            }
+        };
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    protected:
+        std::vector<size_t> offsets;
+        std::vector<vid_t> targets;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        template<typename InputIt>
+        void reserve_targets(InputIt first, InputIt last, std::random_access_iterator_tag) {
+            targets.reserve(last - first);
+        }
+
+        template<typename InputIt>
+        void reserve_targets(InputIt, InputIt, std::input_iterator_tag) { }
+
+    public:
+        /**
+         * CompressedSparseRow (constructor)
+         *
+         * This creates the snapshot of a graph with no vertices.
+         */
+        CompressedSparseRow() : offsets(1, 0) { }
+
+        /**
+         * CompressedSparseRow (constructor)
+         *
+         * This takes ownership of already built offsets/targets arrays.
+         *
+         * @pre `offsets` is non-empty and non-decreasing, starts with 0 and ends with targets.size()
+         */
+        CompressedSparseRow(std::vector<size_t> offsets, std::vector<vid_t> targets)
+                : offsets(std::move(offsets)), targets(std::move(targets)) {
+            if (this->offsets.empty() || this->offsets.front() != 0 || this->offsets.back() != this->targets.size())
+                throw InvalidArgument(context_info("inconsistent CSR offsets"));
+        }
+
+        /**
+         * CompressedSparseRow (constructor)
+         *
+         * This builds the snapshot of the adjacencies in [first, last), which *must* be sorted, in a single linear pass.
+         * The snapshot has max(vertices_no, 1 + biggest endpoint) vertices.
+         */
+        template<typename InputIt>
+        CompressedSparseRow(InputIt first, InputIt last, const size_t vertices_no = 0) {
+            size_t max_target = 0;
+
+            reserve_targets(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+            offsets.push_back(0);
+            for (; first != last; ++first) {
+                const adjacency_t adjacency = *first;
+
+                while (offsets.size() <= adjacency.first)
+                    offsets.push_back(targets.size());
+                targets.push_back(adjacency.second);
+                max_target = std::max(max_target, size_t(adjacency.second) + 1);
+            }
+
+            const size_t seen_vertices_no = targets.empty() ? 0 : offsets.size();
+            const size_t final_vertices_no = std::max(std::max(vertices_no, max_target), seen_vertices_no);
+            while (offsets.size() <= final_vertices_no)
+                offsets.push_back(targets.size());
+        }
+
+        /**
+         * vertices (method)
+         *
+         * This returns the number of vertices (the size of the offsets array minus one).
+         */
+        size_t vertices() const noexcept {
+            return offsets.size() - 1;
+        }
+
+        /**
+         * size (method)
+         *
+         * This returns the number of adjacencies.
+         */
+        size_t size() const noexcept {
+            return targets.size();
+        }
+
+        /**
+         * degree (method)
+         *
+         * This returns the number of adjacencies having `vertex` as their first endpoint.
+         *
+         * @pre `vertex` < vertices()
+         */
+        size_t degree(const vid_t vertex) const noexcept {
+            return offsets[vertex + 1] - offsets[vertex];
+        }
+
+        /**
+         * neighbours (method)
+         *
+         * This returns the second endpoints of the adjacencies having `vertex` as their first endpoint, sorted.
+         *
+         * @pre `vertex` < vertices()
+         */
+        neighbourhood neighbours(const vid_t vertex) const noexcept {
+            return neighbourhood(targets.data() + offsets[vertex], targets.data() + offsets[vertex + 1]);
+        }
+
+        /**
+         * position (method)
+         *
+         * This returns the position of `adjacency` in the targets array (which is also its rank, minus one, among all
+         * the adjacencies), or size() if the adjacency does not exist.
+         */
+        size_t position(const adjacency_t adjacency) const noexcept {
+            if (adjacency.first >= vertices())
+                return size();
+
+            const auto neighbourhood = neighbours(adjacency.first);
+            const auto it = std::lower_bound(neighbourhood.begin(), neighbourhood.end(), adjacency.second);
+
+            if (it == neighbourhood.end() || *it != adjacency.second)
+                return size();
+            return it - targets.data();
+        }
+
+        /**
+         * has (method)
+         *
+         * This checks whether `adjacency` belongs to the snapshot, with a binary search in the neighbourhood of its
+         * first endpoint.
+         */
+        bool has(const adjacency_t adjacency) const noexcept {
+            return position(adjacency) != size();
+        }
+
+        /**
+         * offsets_data (method)
+         *
+         * This returns the offsets array, made of vertices() + 1 entries.
+         */
+        const std::vector<size_t>& offsets_data() const noexcept {
+            return offsets;
+        }
+
+        /**
+         * targets_data (method)
+         *
+         * This returns the targets array, made of size() entries.
+         */
+        const std::vector<vid_t>& targets_data() const noexcept {
+            return targets;
+        }
+    };
+
+    /**
+     * WeightedCompressedSparseRow (type)
+     *
+     * This is a CompressedSparseRow which also stores a weight for each adjacency, in an array aligned with the targets
+     * array.
+     */
+    template<typename weight_t>
+    class WeightedCompressedSparseRow : public CompressedSparseRow {
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        std::vector<weight_t> weights;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    public:
+        WeightedCompressedSparseRow() = default;
+
+        /**
+         * WeightedCompressedSparseRow (constructor)
+         *
+         * This attaches `weights` (aligned with the targets array) to an existing snapshot.
+         */
+        WeightedCompressedSparseRow(CompressedSparseRow topology, std::vector<weight_t> weights)
+                : CompressedSparseRow(std::move(topology)), weights(std::move(weights)) {
+            if (this->weights.size() != size())
+                throw InvalidArgument(context_info("the weights are not aligned with the adjacencies"));
+        }
+
+        /**
+         * weight (method)
+         *
+         * This returns the weight of the adjacency stored at `position` in the targets array.
+         */
+        const weight_t& weight(const size_t position) const noexcept {
+            return weights[position];
+        }
+
+        /**
+         * weights_data (method)
+         *
+         * This returns the weights array, made of size() entries.
+         */
+        const std::vector<weight_t>& weights_data() const noexcept {
+            return weights;
+        }
+    };
+
+}
+
+#endif //KONIG_COMPRESSEDSPARSEROW_HPP
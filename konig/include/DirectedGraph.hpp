@@ -1,13 +1,295 @@
 #ifndef KONIG_DIRECTEDGRAPH_HPP
 #define KONIG_DIRECTEDGRAPH_HPP
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
 #include "Graph.hpp"
+#include "AdjacencyRanks.hpp"
 
 namespace konig {
 
-    template<typename vertex_t, typename weight_t>
-    class UndirectedGraph : public Graph {
+    /**
+     * DirectedGraph (type)
+     *
+     * This is a directed graph without self loops nor multiple edges (see Graph for the policies). Each edge is stored
+     * as the adjacency (tail, head), and the neighbourhood of a vertex is made of the heads of its edges.
+     */
+    template<typename labeler_t = IdentityLabeler, typename weighter_t = NoWeighter,
+            typename storage_t = AdjacencyManager>
+    class DirectedGraph : public Graph<DirectedGraph<labeler_t, weighter_t, storage_t>, labeler_t, weighter_t,
+            storage_t> {
+        typedef Graph<DirectedGraph, labeler_t, weighter_t, storage_t> base_t;
+        friend base_t;
 
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        using base_t::vertices_no;
+        using base_t::storage;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        static adjacency_t canonical(const vid_t tail, const vid_t head) noexcept {
+            return {tail, head};
+        }
+
+        DirectedRanks edge_ranks() const noexcept {
+            return DirectedRanks(vertices_no);
+        }
+
+        CompressedSparseRow build_neighbourhoods() const {
+            return this->to_csr();
+        }
+
+        /**
+         * condensation (method)
+         *
+         * This returns the graph of the strongly connected components given by `component`: it has an adjacency
+         * (component[u], component[v]) for each edge (u, v) between different components, possibly repeated.
+         */
+        CompressedSparseRow condensation(const std::vector<vid_t>& component, const size_t components_no) const {
+            const CompressedSparseRow& csr = this->neighbourhoods();
+
+            std::vector<size_t> offsets(components_no + 1, 0);
+            for (vid_t u = 0; u < vertices_no; u++)
+                for (const vid_t v : csr.neighbours(u))
+                    if (component[u] != component[v])
+                        ++offsets[component[u] + 1];
+            for (size_t c = 1; c <= components_no; c++)
+                offsets[c] += offsets[c - 1];
+
+            std::vector<vid_t> targets(offsets.back());
+            std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+            for (vid_t u = 0; u < vertices_no; u++)
+                for (const vid_t v : csr.neighbours(u))
+                    if (component[u] != component[v])
+                        targets[cursors[component[u]]++] = component[v];
+
+            return CompressedSparseRow(std::move(offsets), std::move(targets));
+        }
+
+        /**
+         * reach_sink (method)
+         *
+         * This is the search of the Eswaran-Tarjan augmentation: it visits the unmarked components reachable from
+         * `source` in `dag`, and returns the first sink found (marking everything visited on the way), or
+         * `components_no` if there is none. It uses an explicit stack.
+         */
+        static vid_t reach_sink(const CompressedSparseRow& dag, const vid_t source, const size_t components_no,
+                                std::vector<bool>& marked, std::vector<std::pair<vid_t, size_t>>& stack) {
+            const size_t* const offsets = dag.offsets_data().data();
+            const vid_t* const targets = dag.targets_data().data();
+
+            marked[source] = true;
+            stack.assign(1, {source, offsets[source]});
+            while (!stack.empty()) {
+                const vid_t vertex = stack.back().first;
+                if (offsets[vertex] == offsets[vertex + 1])
+                    return vertex;
+
+                size_t& next = stack.back().second;
+                while (next < offsets[vertex + 1] && marked[targets[next]])
+                    ++next;
+                if (next == offsets[vertex + 1]) {
+                    stack.pop_back();
+                } else {
+                    const vid_t child = targets[next++];
+                    marked[child] = true;
+                    stack.push_back({child, offsets[child]});
+                }
+            }
+            return static_cast<vid_t>(components_no);
+        }
+
+    public:
+        using base_t::base_t;
+
+        /**
+         * build_dag (method)
+         *
+         * This adds `edges_no` random new edges (u, v) with u > v, so that the graph stays acyclic if it was built
+         * this way, drawing from `engine`.
+         *
+         * Unlike add_edges, the stored edges may go either way, and only the ones with u > v are numbered by the
+         * ranks: their ranks are collected first, in O(edges) time and memory.
+         */
+        template<typename engine_type>
+        void build_dag(const size_t edges_no, engine_type& engine) {
+            const UndirectedRanks ranks(vertices_no);
+            std::vector<uint64_t> excluded;
+            for (auto it = storage.begin(); it != storage.end(); ++it)
+                if (ranks.is_valid(*it))
+                    excluded.push_back(ranks.rank(*it));
+
+            this->add_random_edges(edges_no, ranks, excluded, engine);
+        }
+
+        void build_dag(const size_t edges_no) {
+            build_dag(edges_no, random::engine());
+        }
+
+        /**
+         * strong_components (method)
+         *
+         * This computes the strongly connected components with an iterative version of Tarjan's algorithm, in
+         * O(vertices + edges) time, and returns their number. `component[v]` is set to the component of `v`: the
+         * components are numbered in reverse topological order, i.e. every edge between different components goes
+         * from a bigger number to a smaller one.
+         */
+        size_t strong_components(std::vector<vid_t>& component) const {
+            const CompressedSparseRow& csr = this->neighbourhoods();
+            const size_t* const offsets = csr.offsets_data().data();
+            const vid_t* const targets = csr.targets_data().data();
+            const vid_t UNVISITED = std::numeric_limits<vid_t>::max();
+
+            // The DFS order of the visited vertices, and the lowest order reachable from their DFS subtree
+            std::vector<vid_t> order(vertices_no, UNVISITED), low(vertices_no);
+            std::vector<vid_t> open;
+            std::vector<std::pair<vid_t, size_t>> stack;
+            component.assign(vertices_no, UNVISITED);
+            vid_t visited_no = 0;
+            size_t components_no = 0;
+
+            for (vid_t root = 0; root < vertices_no; root++) {
+                if (order[root] != UNVISITED)
+                    continue;
+
+                order[root] = low[root] = visited_no++;
+                open.push_back(root);
+                stack.push_back({root, offsets[root]});
+                while (!stack.empty()) {
+                    const vid_t vertex = stack.back().first;
+                    size_t& next = stack.back().second;
+
+                    if (next < offsets[vertex + 1]) {
+                        const vid_t head = targets[next++];
+                        if (order[head] == UNVISITED) {
+                            order[head] = low[head] = visited_no++;
+                            open.push_back(head);
+                            stack.push_back({head, offsets[head]});
+                        } else if (component[head] == UNVISITED) {
+                            low[vertex] = std::min(low[vertex], order[head]);
+                        }
+                        continue;
+                    }
+
+                    stack.pop_back();
+                    if (!stack.empty())
+                        low[stack.back().first] = std::min(low[stack.back().first], low[vertex]);
+
+                    if (low[vertex] == order[vertex]) {
+                        vid_t member;
+                        do {
+                            member = open.back();
+                            open.pop_back();
+                            component[member] = static_cast<vid_t>(components_no);
+                        } while (member != vertex);
+                        ++components_no;
+                    }
+                }
+            }
+
+            return components_no;
+        }
+
+        /**
+         * connect (method)
+         *
+         * This makes the graph strongly connected, adding the minimum number of edges, i.e. max(sources, sinks) of the
+         * condensation (where isolated components count as both), in O(vertices + edges) time, with the augmentation
+         * of Eswaran and Tarjan:
+         *  - sources are paired with sinks reachable from them, with a single search that never visits a component
+         *    twice, so that the pairing is maximal;
+         *  - the pairs, the sources or sinks left over by the smaller group, and the isolated components are chained
+         *    in a cycle, each element linked from the sink (or exit) of the previous one;
+         *  - the remaining sources and sinks are linked in pairs, sink to source.
+         * Each component is represented by a uniformly random vertex of its own, and the order of the sources, sinks
+         * and isolated components is shuffled, drawing from `engine`.
+         */
+        template<typename engine_type>
+        void connect(engine_type& engine) {
+            std::vector<vid_t> component;
+            const size_t components_no = strong_components(component);
+            if (components_no <= 1)
+                return;
+
+            // Reservoir sampling: the i-th vertex met in a component replaces its representative with probability 1/i
+            std::vector<vid_t> seen(components_no, 0), representative(components_no);
+            for (vid_t vertex = 0; vertex < vertices_no; vertex++)
+                if (random::bounded(engine, ++seen[component[vertex]]) == 0)
+                    representative[component[vertex]] = vertex;
+            std::vector<vid_t>().swap(seen);
+
+            const CompressedSparseRow dag = condensation(component, components_no);
+            std::vector<vid_t>().swap(component);
+
+            std::vector<bool> has_in(components_no, false);
+            for (const vid_t head : dag.targets_data())
+                has_in[head] = true;
+
+            std::vector<vid_t> sources, sinks, isolated;
+            for (vid_t c = 0; c < components_no; c++) {
+                const bool has_out = dag.degree(c) > 0;
+                if (!has_in[c] && !has_out)
+                    isolated.push_back(c);
+                else if (!has_in[c])
+                    sources.push_back(c);
+                else if (!has_out)
+                    sinks.push_back(c);
+            }
+            std::vector<bool>().swap(has_in);
+            std::shuffle(sources.begin(), sources.end(), engine);
+            std::shuffle(isolated.begin(), isolated.end(), engine);
+
+            // The matched sources are moved to the front, and matched[i] is the sink paired with sources[i]. A sink is
+            // matched as soon as a search reaches it, so the unmatched sinks are exactly the unmarked ones.
+            std::vector<bool> marked(components_no, false);
+            std::vector<std::pair<vid_t, size_t>> stack;
+            std::vector<vid_t> matched, unmatched_sources, unmatched_sinks;
+            for (const vid_t source : sources) {
+                const vid_t sink = reach_sink(dag, source, components_no, marked, stack);
+                if (sink == components_no) {
+                    unmatched_sources.push_back(source);
+                } else {
+                    sources[matched.size()] = source;
+                    matched.push_back(sink);
+                }
+            }
+            for (const vid_t sink : sinks)
+                if (!marked[sink])
+                    unmatched_sinks.push_back(sink);
+            std::shuffle(unmatched_sinks.begin(), unmatched_sinks.end(), engine);
+
+            std::vector<adjacency_t> edges;
+            auto link = [&](const vid_t from, const vid_t to) {
+                edges.push_back({representative[from], representative[to]});
+            };
+
+            const size_t pairs_no = std::min(unmatched_sources.size(), unmatched_sinks.size());
+            for (size_t i = 0; i < pairs_no; i++)
+                link(unmatched_sinks[i], unmatched_sources[i]);
+
+            // The elements of the cycle, as (entry, exit) components
+            std::vector<std::pair<vid_t, vid_t>> cycle;
+            for (size_t i = 0; i < matched.size(); i++)
+                cycle.push_back({sources[i], matched[i]});
+            for (size_t i = pairs_no; i < unmatched_sources.size(); i++)
+                cycle.push_back({unmatched_sources[i], unmatched_sources[i]});
+            for (size_t i = pairs_no; i < unmatched_sinks.size(); i++)
+                cycle.push_back({unmatched_sinks[i], unmatched_sinks[i]});
+            for (const vid_t c : isolated)
+                cycle.push_back({c, c});
+            for (size_t i = 0; i < cycle.size(); i++)
+                link(cycle[i].second, cycle[(i + 1) % cycle.size()].first);
+
+            this->add_edges(edges.begin(), edges.end());
+        }
     };
 
 }
@@ -0,0 +1,158 @@
+#ifndef KONIG_DISJOINTSET_HPP
+#define KONIG_DISJOINTSET_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+#include "util.hpp"
+#include "Exception.hpp"
+
+namespace konig {
+
+    /**
+     * DisjointSet (type)
+     *
+     * This is a union-find structure over the elements [0, size()), each one starting in a set of its own. The parents
+     * are stored as 32-bit vid_t, and find() is iterative (with path halving), so that even path-shaped inputs with
+     * millions of elements take no stack.
+     *
+     * There are two ways of merging sets:
+     *  - merge() links by rank, and must not be called concurrently with anything else;
+     *  - concurrent_merge() is lock-free, and can be called by any number of threads at the same time (together with
+     *    find() and same()): it links the root with the bigger index below the other one with a compare-and-swap,
+     *    retrying if the roots changed meanwhile. Since links always go from bigger to smaller indices, they can never
+     *    form a cycle.
+     * Both can be used on the same structure, in different phases: the ranks only drive the linking heuristic, so they
+     * being stale after a concurrent phase doesn't affect correctness.
+     */
+    class DisjointSet {
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        std::vector<std::atomic<vid_t>> parents;
+        std::vector<uint8_t> ranks;
+        std::atomic<size_t> sets_no;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        vid_t parent(const vid_t element) const noexcept {
+            return parents[element].load(std::memory_order_acquire);
+        }
+
+    public:
+        /**
+         * DisjointSet (constructor)
+         *
+         * This creates `size` singleton sets.
+         */
+        explicit DisjointSet(const size_t size) : parents(size), ranks(size, 0), sets_no(size) {
+            if (size > size_t(std::numeric_limits<vid_t>::max()) + 1)
+                throw InvalidArgument(context_info("too many elements"));
+            for (size_t i = 0; i < size; i++)
+                parents[i].store(static_cast<vid_t>(i), std::memory_order_relaxed);
+        }
+
+        DisjointSet(const DisjointSet&) = delete;
+        DisjointSet& operator=(const DisjointSet&) = delete;
+
+        /**
+         * size (method)
+         *
+         * This returns the number of elements.
+         */
+        size_t size() const noexcept {
+            return parents.size();
+        }
+
+        /**
+         * sets (method)
+         *
+         * This returns the current number of disjoint sets.
+         */
+        size_t sets() const noexcept {
+            return sets_no.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * find (method)
+         *
+         * This returns the representative of the set containing `element`. Along the way, every visited element is
+         * linked to its grandparent (path halving): concurrent finds may overwrite each other's shortcuts, but always
+         * with an ancestor, so the structure stays valid.
+         */
+        vid_t find(vid_t element) noexcept {
+            vid_t up = parent(element);
+            while (up != element) {
+                const vid_t grandparent = parent(up);
+                if (grandparent != up)
+                    parents[element].store(grandparent, std::memory_order_release);
+                element = grandparent;
+                up = parent(element);
+            }
+            return element;
+        }
+
+        /**
+         * same (method)
+         *
+         * This checks whether `a` and `b` belong to the same set.
+         */
+        bool same(const vid_t a, const vid_t b) noexcept {
+            return find(a) == find(b);
+        }
+
+        /**
+         * merge (method)
+         *
+         * This merges the sets containing `a` and `b`, linking by rank, and returns whether they were different. It is
+         * not thread-safe.
+         */
+        bool merge(vid_t a, vid_t b) noexcept {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+                return false;
+
+            if (ranks[a] < ranks[b])
+                std::swap(a, b);
+            parents[b].store(a, std::memory_order_relaxed);
+            if (ranks[a] == ranks[b])
+                ++ranks[a];
+
+            sets_no.store(sets_no.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /**
+         * concurrent_merge (method)
+         *
+         * This is the same as merge, but it is lock-free and can be called concurrently: the root with the bigger index
+         * is linked below the other one, which always has a smaller index.
+         */
+        bool concurrent_merge(vid_t a, vid_t b) noexcept {
+            while (true) {
+                a = find(a);
+                b = find(b);
+                if (a == b)
+                    return false;
+
+                if (a < b)
+                    std::swap(a, b);
+                vid_t expected = a;
+                if (parents[a].compare_exchange_weak(expected, b, std::memory_order_acq_rel)) {
+                    sets_no.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+    };
+
+}
+
+#endif //KONIG_DISJOINTSET_HPP
@@ -3,6 +3,8 @@
 
 #include <exception>
 #include <iosfwd>
+#include <stdexcept>
+#include <string>
 
 namespace konig {
 
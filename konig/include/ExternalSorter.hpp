@@ -0,0 +1,451 @@
+#ifndef KONIG_EXTERNALSORTER_HPP
+#define KONIG_EXTERNALSORTER_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "util.hpp"
+#include "Exception.hpp"
+#include "AdjacencyTree.hpp"
+#include "GraphFile.hpp"
+#include "GraphWriter.hpp"
+#include "RangeSampler.hpp"
+
+namespace konig {
+
+    /**
+     * ExternalSorter (type)
+     *
+     * This sorts, and removes the duplicates of, a stream of adjacencies which may not fit in memory, using at most
+     * `memory_budget` bytes (plus O(vertices) for the offsets of the binary writer, see write_graph).
+     *
+     * Adjacencies are collected in runs of memory_budget / 2 bytes. Every full run is sorted and written to a temporary
+     * file by a background thread, while the next run is being filled, so that sampling overlaps with sorting and I/O.
+     * Once finish() is called, visit() merges the runs with a k-way merge, splitting the budget among the read buffers
+     * of the runs. If all the adjacencies fit in a single run, nothing is ever written to disk.
+     *
+     * The temporary file is created in `directory` and unlinked right away, so it is released when the sorter is
+     * destroyed, even if the process is terminated.
+     */
+    class ExternalSorter {
+
+        //////////////////////////
+        // Subtypes             //
+        //////////////////////////
+    private:
+        // A sorted, duplicate-free run written to the temporary file
+        struct Run {
+            uint64_t offset;    // in bytes
+            uint64_t length;    // in adjacencies
+        };
+
+        // The read buffer of a run during a merge
+        struct RunCursor {
+            uint64_t offset;
+            uint64_t remaining;
+            std::vector<adjacency_t> buffer;
+            size_t position;
+        };
+
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        static const size_t MIN_MEMORY_BUDGET = 1 << 12;
+
+        size_t memory_budget;
+        size_t run_capacity;
+        int fd = -1;
+        uint64_t file_size = 0;
+
+        std::vector<adjacency_t> filling;      // the run being collected
+        std::vector<adjacency_t> spilling;     // the run being sorted and written in background
+        std::vector<Run> runs;
+        bool finished = false;
+        uint64_t pushed_no = 0;
+        mutable uint64_t distinct_no = 0;
+        mutable bool counted = false;
+
+        std::thread writer_thread;
+        Run pending_run;
+        std::exception_ptr writer_error;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        static void sort_run(std::vector<adjacency_t>& run) {
+            if (!std::is_sorted(run.begin(), run.end()))
+                std::sort(run.begin(), run.end());
+            run.erase(std::unique(run.begin(), run.end()), run.end());
+        }
+
+        /**
+         * write_at (method)
+         *
+         * This writes `size` bytes to the temporary file, starting from the byte `offset`.
+         */
+        void write_at(const char* bytes, size_t size, uint64_t offset) const {
+            while (size) {
+                const ssize_t written = ::pwrite(fd, bytes, size, static_cast<off_t>(offset));
+                if (written < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    throw Exception(context_info("cannot write to the temporary file"));
+                }
+                bytes += written;
+                size -= written;
+                offset += written;
+            }
+        }
+
+        /**
+         * read_at (method)
+         *
+         * This reads `size` bytes from the temporary file, starting from the byte `offset`.
+         */
+        void read_at(char* bytes, size_t size, uint64_t offset) const {
+            while (size) {
+                const ssize_t read = ::pread(fd, bytes, size, static_cast<off_t>(offset));
+                if (read < 0 && errno == EINTR)
+                    continue;
+                if (read <= 0)
+                    throw Exception(context_info("cannot read from the temporary file"));
+                bytes += read;
+                size -= read;
+                offset += read;
+            }
+        }
+
+        /**
+         * wait_writer (method)
+         *
+         * This waits for the background thread to write its run, and rethrows its error, if any.
+         */
+        void wait_writer() {
+            if (!writer_thread.joinable())
+                return;
+
+            writer_thread.join();
+            if (writer_error) {
+                const std::exception_ptr error = writer_error;
+                writer_error = std::exception_ptr();
+                std::rethrow_exception(error);
+            }
+            runs.push_back(pending_run);
+            file_size += pending_run.length * sizeof(adjacency_t);
+        }
+
+        /**
+         * spill (method)
+         *
+         * This hands the current run to a background thread, which sorts it and appends it to the temporary file,
+         * after waiting for the previous one.
+         */
+        void spill() {
+            wait_writer();
+            filling.swap(spilling);
+            filling.clear();
+            filling.reserve(run_capacity);  // after the first swap this is the never-reserved buffer
+
+            writer_thread = std::thread([this]() {
+                try {
+                    sort_run(spilling);
+                    pending_run.offset = file_size;
+                    pending_run.length = spilling.size();
+                    write_at(reinterpret_cast<const char*>(spilling.data()), spilling.size() * sizeof(adjacency_t),
+                             file_size);
+                } catch (...) {
+                    writer_error = std::current_exception();
+                }
+            });
+        }
+
+        /**
+         * refill (method)
+         *
+         * This loads the next adjacencies of a run in its read buffer, and returns false if the run is over.
+         */
+        bool refill(RunCursor& cursor) const {
+            if (cursor.position < cursor.buffer.size())
+                return true;
+            if (!cursor.remaining)
+                return false;
+
+            cursor.buffer.resize(std::min<uint64_t>(cursor.buffer.capacity(), cursor.remaining));
+            read_at(reinterpret_cast<char*>(cursor.buffer.data()), cursor.buffer.size() * sizeof(adjacency_t),
+                    cursor.offset);
+            cursor.offset += cursor.buffer.size() * sizeof(adjacency_t);
+            cursor.remaining -= cursor.buffer.size();
+            cursor.position = 0;
+            return true;
+        }
+
+        void ensure_finished() const {
+            if (!finished)
+                throw StructureViolation(context_info("the ExternalSorter has not been finished yet"));
+        }
+
+    public:
+        /**
+         * ExternalSorter (constructor)
+         *
+         * This creates a sorter using about `memory_budget` bytes, which spills its runs to a temporary file in
+         * `directory` (by default, $TMPDIR or /tmp).
+         */
+        explicit ExternalSorter(const size_t memory_budget, std::string directory = std::string())
+                : memory_budget(memory_budget) {
+            if (memory_budget < MIN_MEMORY_BUDGET)
+                throw InvalidArgument(context_info("the memory budget is too small"));
+            run_capacity = memory_budget / (2 * sizeof(adjacency_t));
+
+            if (directory.empty()) {
+                const char* const tmpdir = std::getenv("TMPDIR");
+                directory = (tmpdir && *tmpdir) ? tmpdir : "/tmp";
+            }
+            std::string name = directory + "/konig-spill-XXXXXX";
+            fd = mkstemp(&name[0]);
+            if (fd < 0)
+                throw InvalidArgument(context_info("cannot create a temporary file in " + directory));
+            ::unlink(name.c_str());
+
+            filling.reserve(run_capacity);
+        }
+
+        ExternalSorter(const ExternalSorter&) = delete;
+        ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+        ~ExternalSorter() {
+            if (writer_thread.joinable())
+                writer_thread.join();
+            ::close(fd);
+        }
+
+        /**
+         * push (overloaded method)
+         *
+         * This adds an adjacency to the stream.
+         */
+        void push(const adjacency_t adjacency) {
+            if (finished)
+                throw StructureViolation(context_info("the ExternalSorter has already been finished"));
+            filling.push_back(adjacency);
+            ++pushed_no;
+            if (filling.size() == run_capacity)
+                spill();
+        }
+
+        /**
+         * push (overloaded method)
+         *
+         * This adds all the adjacencies in [first, last) to the stream.
+         */
+        template<typename InputIt>
+        void push(InputIt first, const InputIt last) {
+            for (; first != last; ++first)
+                push(*first);
+        }
+
+        /**
+         * finish (method)
+         *
+         * This ends the stream: the last run is sorted (and spilled, if some run already was), and the run buffers are
+         * released. It must be called before visiting the adjacencies.
+         */
+        void finish() {
+            if (finished)
+                return;
+
+            if (runs.empty() && !writer_thread.joinable()) {
+                sort_run(filling);
+                distinct_no = filling.size();
+                counted = true;
+            } else {
+                if (!filling.empty())
+                    spill();
+                wait_writer();
+                std::vector<adjacency_t>().swap(filling);
+            }
+            std::vector<adjacency_t>().swap(spilling);
+            finished = true;
+        }
+
+        /**
+         * pushed (method)
+         *
+         * This returns the number of adjacencies pushed so far, duplicates included.
+         */
+        uint64_t pushed() const noexcept {
+            return pushed_no;
+        }
+
+        /**
+         * spilled_runs (method)
+         *
+         * This returns the number of runs written to disk so far.
+         */
+        size_t spilled_runs() const noexcept {
+            return runs.size();
+        }
+
+        /**
+         * visit (method)
+         *
+         * This calls `callback(tail, head)` for all the distinct adjacencies, sorted, merging the spilled runs. It can
+         * be called many times.
+         *
+         * @pre finish() has been called
+         */
+        template<typename callback_t>
+        void visit(callback_t callback) const {
+            ensure_finished();
+            if (runs.empty()) {
+                for (const auto& adjacency : filling)
+                    callback(adjacency.first, adjacency.second);
+                return;
+            }
+
+            const size_t min_read_buffer = 1 << 8;
+            const size_t read_buffer = std::max(min_read_buffer, memory_budget / (runs.size() * sizeof(adjacency_t)));
+            std::vector<RunCursor> cursors(runs.size());
+            typedef std::pair<adjacency_t, size_t> head_t;
+            std::priority_queue<head_t, std::vector<head_t>, std::greater<head_t>> heads;
+
+            for (size_t run = 0; run < runs.size(); run++) {
+                RunCursor& cursor = cursors[run];
+                cursor.offset = runs[run].offset;
+                cursor.remaining = runs[run].length;
+                cursor.buffer.reserve(read_buffer);
+                cursor.position = 0;
+                if (refill(cursor))
+                    heads.push({cursor.buffer[cursor.position++], run});
+            }
+
+            bool first = true;
+            adjacency_t previous(0, 0);
+            while (!heads.empty()) {
+                const head_t top = heads.top();
+                heads.pop();
+                if (first || top.first != previous) {
+                    callback(top.first.first, top.first.second);
+                    previous = top.first;
+                    first = false;
+                }
+
+                RunCursor& cursor = cursors[top.second];
+                if (refill(cursor))
+                    heads.push({cursor.buffer[cursor.position++], top.second});
+            }
+        }
+
+        /**
+         * size (method)
+         *
+         * This returns the number of distinct adjacencies. When runs have been spilled, the first call merges them
+         * (see visit) to count them.
+         *
+         * @pre finish() has been called
+         */
+        uint64_t size() const {
+            ensure_finished();
+            if (!counted) {
+                uint64_t count = 0;
+                visit([&](vid_t, vid_t) { ++count; });
+                distinct_no = count;
+                counted = true;
+            }
+            return distinct_no;
+        }
+    };
+
+    /**
+     * sample_adjacencies (function)
+     *
+     * This is the out-of-core version of sample_adjacencies(ranks, count, seed): the ranks are sampled chunk by chunk
+     * (see RangeSampler), decoded and pushed to `sorter`, which is then finished. With `symmetric`, each adjacency
+     * (u, v) is pushed together with (v, u), as needed to write the neighbourhoods of an undirected graph.
+     *
+     * The adjacencies are the same as the ones returned by the in-memory version with the same seed.
+     */
+    template<typename ranks_t>
+    void sample_adjacencies(const ranks_t& ranks, const uint64_t count, const uint64_t seed, ExternalSorter& sorter,
+                            const bool symmetric = false) {
+        RangeSampler sampler(count, ranks.size(), seed);
+        std::vector<uint64_t> chunk_ranks;
+        std::vector<adjacency_t> chunk_adjacencies;
+
+        for (size_t chunk = 0; chunk < sampler.chunks(); chunk++) {
+            chunk_ranks.resize(sampler.chunk_size(chunk));
+            chunk_adjacencies.resize(chunk_ranks.size());
+            sampler.sample_chunk(chunk, chunk_ranks.data());
+            ranks.decode(chunk_ranks.begin(), chunk_ranks.end(), chunk_adjacencies.begin());
+
+            for (const auto& adjacency : chunk_adjacencies) {
+                sorter.push(adjacency);
+                if (symmetric)
+                    sorter.push({adjacency.second, adjacency.first});
+            }
+        }
+        sorter.finish();
+    }
+
+    namespace detail {
+
+        // Source of adjacencies for write_graph_file
+        struct ExternalSorterSource {
+            const ExternalSorter& sorter;
+
+            template<typename callback_t>
+            void visit(callback_t callback) const {
+                sorter.visit(callback);
+            }
+        };
+    }
+
+    /**
+     * write_graph (overloaded function)
+     *
+     * This writes the adjacencies of `sorter` to `writer` as a binary graph file (see GraphFileHeader) with at least
+     * `vertices_no` vertices, merging the runs twice (once to lay out the sections and once to write them). Besides
+     * the budget of the sorter, it only takes the O(vertices) offsets arrays.
+     */
+    inline void write_graph(GraphWriter& writer, const ExternalSorter& sorter, const size_t vertices_no = 0,
+                            const bool compressed = false) {
+        detail::write_graph_file(writer, vertices_no, detail::ExternalSorterSource{sorter}, compressed, NULL, 0);
+    }
+
+    /**
+     * write_adjacencies (function)
+     *
+     * This writes the adjacencies of `sorter` to `writer`, one per line as "tail head", in order.
+     */
+    inline void write_adjacencies(GraphWriter& writer, const ExternalSorter& sorter) {
+        sorter.visit([&](const vid_t tail, const vid_t head) {
+            writer.put(tail).put(' ').put(head).put('\n');
+        });
+    }
+
+    /**
+     * write_edges (function)
+     *
+     * This writes the adjacencies of `sorter` in the format of Graph::write: a header line with `vertices_no` and the
+     * number of adjacencies, followed by write_adjacencies. Counting the adjacencies takes an extra merge.
+     */
+    inline void write_edges(GraphWriter& writer, const ExternalSorter& sorter, const size_t vertices_no) {
+        writer.put(vertices_no).put(' ').put(sorter.size()).put('\n');
+        write_adjacencies(writer, sorter);
+    }
+
+}
+
+#endif //KONIG_EXTERNALSORTER_HPP
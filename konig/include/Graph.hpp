@@ -1,11 +1,741 @@
 #ifndef KONIG_GRAPH_HPP
 #define KONIG_GRAPH_HPP
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "util.hpp"
+#include "Exception.hpp"
+#include "AdjacencyManager.hpp"
+#include "CompressedSparseRow.hpp"
+#include "DisjointSet.hpp"
+#include "GraphFile.hpp"
+#include "GraphWriter.hpp"
+#include "Labeler.hpp"
+#include "Permutation.hpp"
+#include "SequentialSampler.hpp"
+#include "Weighter.hpp"
+
 namespace konig {
 
-    template<typename vertex_t, typename weight_t>
+    /**
+     * Graph (type)
+     *
+     * This is the common base of UndirectedGraph and DirectedGraph, which pass themselves as `derived_t` (CRTP): there
+     * are no virtual methods, and the labeler, the weighter and the storage of the adjacencies are compile-time
+     * policies, so that unweighted graphs with the identity labeling pay nothing for the features they don't use.
+     *
+     *  - `labeler_t` turns vertex indices into output labels (see Labeler.hpp);
+     *  - `weighter_t` assigns weights to the edges (see Weighter.hpp);
+     *  - `storage_t` keeps the adjacencies, with the interface of AdjacencyManager.
+     *
+     * Each edge is stored once, as its canonical adjacency. The neighbourhoods of the vertices, which for undirected
+     * graphs span adjacencies in both orientations, are only built (as a CompressedSparseRow) the first time they are
+     * queried, and dropped whenever the graph changes.
+     *
+     * The derived class must provide:
+     *
+     *  - `static adjacency_t canonical(vid_t tail, vid_t head)`, the adjacency representing an edge;
+     *  - `ranks_t edge_ranks() const`, which numbers the edges sampled by add_edges (see AdjacencyRanks.hpp), such
+     *    that its valid adjacencies are canonical;
+     *  - `CompressedSparseRow build_neighbourhoods() const`, which computes the neighbourhoods.
+     */
+    template<typename derived_t, typename labeler_t, typename weighter_t, typename storage_t>
     class Graph {
 
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    protected:
+        size_t vertices_no;
+        labeler_t labeler;
+        weighter_t weighter;
+
+        storage_t storage;
+
+        mutable std::unique_ptr<CompressedSparseRow> neighbourhoods_cache;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        derived_t& self() noexcept {
+            return static_cast<derived_t&>(*this);
+        }
+
+        const derived_t& self() const noexcept {
+            return static_cast<const derived_t&>(*this);
+        }
+
+        /**
+         * write_edges (method)
+         *
+         * This writes the header and the edges of `csr` (the canonical adjacencies), the i-th line being the edge
+         * stored at position order(i).
+         */
+        template<typename order_t>
+        void write_edges(GraphWriter& writer, const CompressedSparseRow& csr, const order_t& order,
+                         const unsigned threads) const {
+            writer.put(vertices_no).put(' ').put(csr.size()).put('\n');
+
+            const size_t* const offsets = csr.offsets_data().data();
+            const vid_t* const targets = csr.targets_data().data();
+            const size_t* const offsets_end = offsets + csr.offsets_data().size();
+
+            writer.write_items(csr.size(), [&](TextBuffer& buffer, size_t first, const size_t last) {
+                vid_t tail = 0;
+                for (; first < last; first++) {
+                    const size_t position = order(first);
+                    if (position < offsets[tail] || position >= offsets[tail + 1])
+                        tail = static_cast<vid_t>(std::upper_bound(offsets, offsets_end, position) - offsets - 1);
+
+                    const vid_t head = targets[position];
+                    buffer.put(labeler(tail)).put(' ').put(labeler(head));
+                    detail::put_weight(buffer, weighter, adjacency_t(tail, head),
+                                       std::integral_constant<bool, weighter_t::weighted>());
+                    buffer.put('\n');
+                }
+            }, threads);
+        }
+
+        void write_binary(GraphWriter& writer, const bool compressed, std::true_type) const {
+            konig::write_graph(writer, to_weighted_csr(), compressed);
+        }
+
+        void write_binary(GraphWriter& writer, const bool compressed, std::false_type) const {
+            konig::write_graph(writer, to_csr(), compressed);
+        }
+
+        struct IdentityOrder {
+            size_t operator()(const size_t index) const noexcept {
+                return index;
+            }
+        };
+
+        void check_vertex(const vid_t vertex) const {
+            if (vertex >= vertices_no)
+                throw InvalidArgument(context_info("the vertex does not belong to the graph"));
+        }
+
+    protected:
+        /**
+         * store (overloaded method)
+         *
+         * This stores a canonical adjacency.
+         */
+        void store(const adjacency_t edge) {
+            neighbourhoods_cache.reset();
+            storage.insert(edge);
+        }
+
+        /**
+         * store (overloaded method)
+         *
+         * This stores a batch of canonical adjacencies.
+         */
+        void store(const std::vector<adjacency_t>& edges) {
+            neighbourhoods_cache.reset();
+            storage.insert(edges.begin(), edges.end());
+        }
+
+        /**
+         * replace (method)
+         *
+         * This replaces all the edges with a sorted batch of canonical adjacencies, building the storage in linear time.
+         * The vertex index of the storage is grown first, in case vertices() grew.
+         */
+        void replace(const std::vector<adjacency_t>& edges) {
+            neighbourhoods_cache.reset();
+            storage.reserve(vertices_no);
+            storage.assign(edges.begin(), edges.end());
+        }
+
+        /**
+         * check_vertices (method)
+         *
+         * This checks that a graph on `vertices_no` vertices can be represented.
+         */
+        static void check_vertices(const uint64_t vertices_no) {
+            if (vertices_no > uint64_t(std::numeric_limits<vid_t>::max()))
+                throw InvalidArgument(context_info("too many vertices"));
+        }
+
+        /**
+         * add_random_edges (overloaded method)
+         *
+         * This adds `edges_no` new edges, sampled uniformly among the valid adjacencies of `ranks` which are not in
+         * `exclusions` (the sorted ranks of the edges of the graph which are valid for `ranks`), drawing from `engine`.
+         * The samples are produced sorted and stored with a single bulk insertion.
+         *
+         * When the new edges are most of the missing adjacencies and a sizeable part of the rank space, the ones to
+         * leave out are sampled instead, and the rest is streamed out of the rank space (see
+         * ComplementSampler::pays_off).
+         */
+        template<typename ranks_t, typename exclusions_t, typename engine_type>
+        void add_random_edges(const size_t edges_no, const ranks_t& ranks, const exclusions_t& exclusions,
+                              engine_type& engine) {
+            const uint64_t missing = ranks.size() - exclusions.size();
+            if (edges_no > missing)
+                throw InvalidArgument(context_info("too many edges for the given graph"));
+
+            std::vector<adjacency_t> edges;
+            edges.reserve(edges_no);
+            if (ComplementSampler<exclusions_t, engine_type>::pays_off(edges_no, ranks.size(), exclusions.size()))
+                sample_edges(ComplementSampler<exclusions_t, engine_type>(edges_no, ranks.size(), exclusions, engine),
+                             ranks, edges);
+            else
+                sample_edges(ExcludingSampler<exclusions_t, engine_type>(edges_no, ranks.size(), exclusions, engine),
+                             ranks, edges);
+
+            store(edges);
+        }
+
+        /**
+         * add_random_edges (overloaded method)
+         *
+         * This is the same as above, when all the stored adjacencies are valid for `ranks` (as for the canonical
+         * adjacencies numbered by edge_ranks()): the storage is used as the exclusions directly, through
+         * RankedExclusions, so nothing proportional to the number of edges is copied.
+         */
+        template<typename ranks_t, typename engine_type>
+        void add_random_edges(const size_t edges_no, const ranks_t& ranks, engine_type& engine) {
+            add_random_edges(edges_no, ranks, RankedExclusions<storage_t, ranks_t>(storage, ranks), engine);
+        }
+
+        /**
+         * sample_edges (method)
+         *
+         * This appends to `edges` the adjacencies of the (increasing) ranks yielded by `sampler`.
+         */
+        template<typename sampler_t, typename ranks_t>
+        static void sample_edges(sampler_t&& sampler, const ranks_t& ranks, std::vector<adjacency_t>& edges) {
+            typename ranks_t::Decoder decoder(ranks);
+            uint64_t rank;
+            while (sampler.next(rank))
+                edges.push_back(decoder(rank));
+        }
+
+        /**
+         * merge_endpoints (method)
+         *
+         * This merges, in `components`, the endpoints of every stored adjacency. The adjacencies are split by rank among
+         * `threads` threads (0 means one per hardware thread), which merge them concurrently.
+         */
+        void merge_endpoints(DisjointSet& components, unsigned threads = 1) const {
+            if (!threads)
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            const size_t adjacencies_no = storage.size();
+            threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, adjacencies_no / 1024)));
+
+            if (threads == 1) {
+                for (auto it = storage.begin(); it != storage.end(); ++it)
+                    components.merge(it->first, it->second);
+                return;
+            }
+
+            auto merge_slice = [&](const unsigned thread) {
+                const size_t first = adjacencies_no * thread / threads;
+                const size_t last = adjacencies_no * (thread + 1) / threads;
+                auto it = storage.select(first + 1);
+                for (size_t i = first; i < last; i++, ++it)
+                    components.concurrent_merge(it->first, it->second);
+            };
+
+            std::vector<std::thread> pool;
+            for (unsigned thread = 1; thread < threads; thread++)
+                pool.emplace_back(merge_slice, thread);
+            merge_slice(0);
+            for (auto& thread : pool)
+                thread.join();
+        }
+
+    public:
+        /**
+         * Graph (constructor)
+         *
+         * This creates a graph on `vertices_no` vertices, without edges. If the labeler has a size() (see Labeler.hpp),
+         * it must be able to label all the vertices.
+         */
+        explicit Graph(const size_t vertices_no, labeler_t labeler = labeler_t(), weighter_t weighter = weighter_t())
+                : vertices_no(vertices_no), labeler(std::move(labeler)), weighter(std::move(weighter)),
+                  storage(vertices_no) {
+            check_vertices(vertices_no);
+            if (detail::labels_no(this->labeler, 0) < vertices_no)
+                throw InvalidArgument(context_info("the labeler cannot label all the vertices"));
+        }
+
+        /**
+         * vertices (method)
+         *
+         * This returns the number of vertices.
+         */
+        size_t vertices() const noexcept {
+            return vertices_no;
+        }
+
+        /**
+         * adjacencies (method)
+         *
+         * This returns the underlying storage, holding the canonical adjacency of each edge.
+         */
+        const storage_t& adjacencies() const noexcept {
+            return storage;
+        }
+
+        /**
+         * neighbourhoods (method)
+         *
+         * This returns the neighbourhoods of all the vertices, building them if the graph changed since the last call.
+         * The first call after a change is not thread-safe.
+         */
+        const CompressedSparseRow& neighbourhoods() const {
+            if (!neighbourhoods_cache)
+                neighbourhoods_cache.reset(new CompressedSparseRow(self().build_neighbourhoods()));
+            return *neighbourhoods_cache;
+        }
+
+        /**
+         * neighbours (method)
+         *
+         * This returns the neighbours of `vertex` (the heads of its edges, for directed graphs), sorted.
+         */
+        CompressedSparseRow::neighbourhood neighbours(const vid_t vertex) const {
+            check_vertex(vertex);
+            return neighbourhoods().neighbours(vertex);
+        }
+
+        /**
+         * degree (method)
+         *
+         * This returns the number of neighbours of `vertex`.
+         */
+        size_t degree(const vid_t vertex) const {
+            check_vertex(vertex);
+            return neighbourhoods().degree(vertex);
+        }
+
+        /**
+         * add_edge (method)
+         *
+         * This adds the edge from `tail` to `head`, if it is not in the graph yet. Self loops are not allowed.
+         */
+        void add_edge(const vid_t tail, const vid_t head) {
+            check_vertex(tail);
+            check_vertex(head);
+            if (tail == head)
+                throw InvalidArgument(context_info("self loops are not allowed"));
+
+            store(derived_t::canonical(tail, head));
+        }
+
+        /**
+         * add_edges (overloaded method)
+         *
+         * This adds all the edges (pairs (tail, head)) in [first, last) with a single bulk insertion.
+         */
+        template<typename InputIt>
+        void add_edges(InputIt first, InputIt last) {
+            std::vector<adjacency_t> edges;
+            for (; first != last; ++first) {
+                const adjacency_t edge = *first;
+                check_vertex(edge.first);
+                check_vertex(edge.second);
+                if (edge.first == edge.second)
+                    throw InvalidArgument(context_info("self loops are not allowed"));
+                edges.push_back(derived_t::canonical(edge.first, edge.second));
+            }
+
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+            store(edges);
+        }
+
+        /**
+         * add_edges (overloaded method)
+         *
+         * This adds `edges_no` random new edges, uniformly among the missing ones, drawing from `engine`.
+         */
+        template<typename engine_type>
+        void add_edges(const size_t edges_no, engine_type& engine) {
+            add_random_edges(edges_no, self().edge_ranks(), engine);
+        }
+
+        /**
+         * add_edges (overloaded method)
+         *
+         * This is the same as add_edges(edges_no, random::engine()).
+         */
+        void add_edges(const size_t edges_no) {
+            add_edges(edges_no, random::engine());
+        }
+
+        /**
+         * has_edge (method)
+         *
+         * This checks whether the edge from `tail` to `head` is in the graph.
+         */
+        bool has_edge(const vid_t tail, const vid_t head) const {
+            return tail != head && storage.has(derived_t::canonical(tail, head));
+        }
+
+        /**
+         * build_forest (method)
+         *
+         * This adds `edges_no` edges forming a random forest: `edges_no` distinct vertices in [1, vertices_no) are
+         * linked to a random vertex with a smaller index.
+         */
+        template<typename engine_type>
+        void build_forest(const size_t edges_no, engine_type& engine) {
+            if (vertices_no == 0 || edges_no > vertices_no - 1)
+                throw InvalidArgument(context_info("too many edges for a forest"));
+
+            std::vector<adjacency_t> edges;
+            edges.reserve(edges_no);
+            SequentialSampler<engine_type> sampler(edges_no, vertices_no - 1, engine);
+            uint64_t vertex;
+            while (sampler.next(vertex)) {
+                const vid_t child = static_cast<vid_t>(vertex + 1);
+                const vid_t parent = static_cast<vid_t>(random::bounded(engine, child));
+                edges.push_back(derived_t::canonical(parent, child));
+            }
+            add_edges(edges.begin(), edges.end());
+        }
+
+        void build_forest(const size_t edges_no) {
+            build_forest(edges_no, random::engine());
+        }
+
+        /**
+         * build_tree (method)
+         *
+         * This adds the edges of a random spanning tree.
+         */
+        template<typename engine_type>
+        void build_tree(engine_type& engine) {
+            build_forest(vertices_no ? vertices_no - 1 : 0, engine);
+        }
+
+        void build_tree() {
+            build_tree(random::engine());
+        }
+
+        /**
+         * build_path (method)
+         *
+         * This adds the edges (i, i + 1).
+         */
+        void build_path() {
+            std::vector<adjacency_t> edges;
+            for (vid_t i = 0; i + 1 < vertices_no; i++)
+                edges.push_back({i, i + 1});
+            add_edges(edges.begin(), edges.end());
+        }
+
+        /**
+         * build_cycle (method)
+         *
+         * This adds the edges (i, i + 1) and (vertices_no - 1, 0).
+         */
+        void build_cycle() {
+            if (vertices_no < 3)
+                throw InvalidArgument(context_info("a cycle needs at least 3 vertices"));
+
+            std::vector<adjacency_t> edges;
+            for (vid_t i = 0; i + 1 < vertices_no; i++)
+                edges.push_back({i, i + 1});
+            edges.push_back({static_cast<vid_t>(vertices_no - 1), 0});
+            add_edges(edges.begin(), edges.end());
+        }
+
+        /**
+         * build_star (method)
+         *
+         * This adds the edges (0, i).
+         */
+        void build_star() {
+            std::vector<adjacency_t> edges;
+            for (vid_t i = 1; i < vertices_no; i++)
+                edges.push_back({0, i});
+            add_edges(edges.begin(), edges.end());
+        }
+
+        /**
+         * build_wheel (method)
+         *
+         * This adds the spokes (0, i) and the rim (i, i + 1), closed by (vertices_no - 1, 1).
+         */
+        void build_wheel() {
+            if (vertices_no < 4)
+                throw InvalidArgument(context_info("a wheel needs at least 4 vertices"));
+
+            std::vector<adjacency_t> edges;
+            for (vid_t i = 1; i < vertices_no; i++) {
+                edges.push_back({0, i});
+                edges.push_back(i + 1 < vertices_no ? adjacency_t(i, i + 1) : adjacency_t(i, 1));
+            }
+            add_edges(edges.begin(), edges.end());
+        }
+
+        /**
+         * build_clique (method)
+         *
+         * This adds the edges (i, j) for all i < j.
+         */
+        void build_clique() {
+            std::vector<adjacency_t> edges;
+            for (vid_t i = 0; i < vertices_no; i++)
+                for (vid_t j = i + 1; j < vertices_no; j++)
+                    edges.push_back({i, j});
+            add_edges(edges.begin(), edges.end());
+        }
+
+        /**
+         * unite (method)
+         *
+         * This adds all the edges of `other`, which may have a different number of vertices: the graph gets the
+         * biggest of the two. Both sets of adjacencies are sorted, so this is a linear merge followed by a bulk build.
+         */
+        void unite(const derived_t& other) {
+            std::vector<adjacency_t> edges;
+            edges.reserve(storage.size() + other.storage.size());
+            std::set_union(storage.begin(), storage.end(), other.storage.begin(), other.storage.end(),
+                           std::back_inserter(edges));
+            vertices_no = std::max(vertices_no, other.vertices_no);
+            replace(edges);
+        }
+
+        /**
+         * intersect (method)
+         *
+         * This removes the edges which are not in `other`, with a linear merge followed by a bulk build.
+         */
+        void intersect(const derived_t& other) {
+            std::vector<adjacency_t> edges;
+            std::set_intersection(storage.begin(), storage.end(), other.storage.begin(), other.storage.end(),
+                                  std::back_inserter(edges));
+            replace(edges);
+        }
+
+        /**
+         * subtract (method)
+         *
+         * This removes the edges which are in `other`, with a linear merge followed by a bulk build.
+         */
+        void subtract(const derived_t& other) {
+            std::vector<adjacency_t> edges;
+            std::set_difference(storage.begin(), storage.end(), other.storage.begin(), other.storage.end(),
+                                std::back_inserter(edges));
+            replace(edges);
+        }
+
+        /**
+         * complement (method)
+         *
+         * This replaces the edges with the ones missing from the graph, streaming the (sorted) adjacencies numbered by
+         * edge_ranks() against the stored ones.
+         */
+        void complement() {
+            typedef decltype(self().edge_ranks()) ranks_t;
+            const ranks_t ranks = self().edge_ranks();
+            typename ranks_t::Decoder decoder(ranks);
+
+            std::vector<adjacency_t> edges;
+            edges.reserve(ranks.size() - storage.size());
+            auto it = storage.begin();
+            for (uint64_t rank = 0; rank < ranks.size(); rank++) {
+                const adjacency_t adjacency = decoder(rank);
+                if (it != storage.end() && *it == adjacency)
+                    ++it;
+                else
+                    edges.push_back(adjacency);
+            }
+            replace(edges);
+        }
+
+        /**
+         * add_disjoint (method)
+         *
+         * This adds a copy of `other` on new vertices: vertex v of `other` becomes vertices() + v. Shifting both
+         * endpoints keeps the adjacencies canonical and puts them after the existing ones, so they are just appended.
+         */
+        void add_disjoint(const derived_t& other) {
+            check_vertices(uint64_t(vertices_no) + other.vertices_no);
+            const vid_t offset = static_cast<vid_t>(vertices_no);
+
+            std::vector<adjacency_t> edges(storage.begin(), storage.end());
+            edges.reserve(storage.size() + other.storage.size());
+            for (auto it = other.storage.begin(); it != other.storage.end(); ++it)
+                edges.push_back({it->first + offset, it->second + offset});
+            vertices_no += other.vertices_no;
+            replace(edges);
+        }
+
+        /**
+         * relabel (method)
+         *
+         * This moves each vertex v to `permutation`[v], which must be a permutation of [0, vertices()). The relabelled
+         * adjacencies are bucketed by their first endpoint with a counting sort, and each bucket is sorted on its own.
+         */
+        void relabel(const std::vector<vid_t>& permutation) {
+            if (permutation.size() != vertices_no)
+                throw InvalidArgument(context_info("the permutation must have an element for each vertex"));
+            std::vector<bool> used(vertices_no, false);
+            for (const vid_t vertex : permutation) {
+                if (vertex >= vertices_no || used[vertex])
+                    throw InvalidArgument(context_info("this is not a permutation of the vertices"));
+                used[vertex] = true;
+            }
+
+            std::vector<size_t> offsets(vertices_no + 1, 0);
+            for (auto it = storage.begin(); it != storage.end(); ++it)
+                ++offsets[derived_t::canonical(permutation[it->first], permutation[it->second]).first + 1];
+            for (size_t v = 1; v <= vertices_no; v++)
+                offsets[v] += offsets[v - 1];
+
+            std::vector<adjacency_t> edges(storage.size());
+            std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+            for (auto it = storage.begin(); it != storage.end(); ++it) {
+                const adjacency_t edge = derived_t::canonical(permutation[it->first], permutation[it->second]);
+                edges[cursors[edge.first]++] = edge;
+            }
+            for (size_t v = 0; v < vertices_no; v++)
+                std::sort(edges.begin() + offsets[v], edges.begin() + offsets[v + 1]);
+            replace(edges);
+        }
+
+        /**
+         * cartesian_product (method)
+         *
+         * This replaces the graph with its Cartesian product with `other`: the vertex (i, j), for i in this graph and
+         * j in `other`, is numbered j * vertices() + i, and it is linked to (i', j) for each edge from i to i', and to
+         * (i, j') for each edge from j to j'.
+         *
+         * The adjacencies of the vertex (i, j) are those of j in `other` with a smaller second endpoint, then those of i
+         * (shifted), then the remaining ones of j: they are emitted already sorted, in linear time.
+         */
+        void cartesian_product(const derived_t& other) {
+            const uint64_t width = vertices_no;
+            check_vertices(width * other.vertices_no);
+
+            const CompressedSparseRow rows = storage.to_csr(vertices_no);
+            const CompressedSparseRow other_rows = other.storage.to_csr(other.vertices_no);
+            std::vector<adjacency_t> edges;
+            edges.reserve(rows.size() * other.vertices_no + other_rows.size() * width);
+
+            for (vid_t j = 0; j < other.vertices_no; j++) {
+                const auto columns = other_rows.neighbours(j);
+                const vid_t* const split = std::lower_bound(columns.begin(), columns.end(), j);
+                for (vid_t i = 0; i < width; i++) {
+                    const vid_t vertex = static_cast<vid_t>(j * width + i);
+                    for (const vid_t* column = columns.begin(); column != split; ++column)
+                        edges.push_back({vertex, static_cast<vid_t>(*column * width + i)});
+                    for (const vid_t head : rows.neighbours(i))
+                        edges.push_back({vertex, static_cast<vid_t>(j * width + head)});
+                    for (const vid_t* column = split; column != columns.end(); ++column)
+                        edges.push_back({vertex, static_cast<vid_t>(*column * width + i)});
+                }
+            }
+            vertices_no = static_cast<size_t>(width * other.vertices_no);
+            replace(edges);
+        }
+
+        /**
+         * edges (method)
+         *
+         * This returns the number of edges.
+         */
+        size_t edges() const noexcept {
+            return storage.size();
+        }
+
+        /**
+         * to_csr (method)
+         *
+         * This returns a snapshot of the edges, each one as its canonical adjacency, on vertices() vertices.
+         */
+        CompressedSparseRow to_csr() const {
+            return storage.to_csr(vertices_no);
+        }
+
+        /**
+         * to_weighted_csr (method)
+         *
+         * This returns the same snapshot as to_csr, with the weight given by the weighter to each edge, aligned with
+         * the targets array. It is only available for weighted graphs.
+         */
+        template<typename weighter_type = weighter_t>
+        WeightedCompressedSparseRow<typename weighter_type::weight_t> to_weighted_csr() const {
+            static_assert(weighter_type::weighted, "the graph is not weighted");
+
+            CompressedSparseRow csr = to_csr();
+            std::vector<typename weighter_type::weight_t> weights;
+            weights.reserve(csr.size());
+            for (vid_t tail = 0; tail < vertices_no; tail++)
+                for (const vid_t head : csr.neighbours(tail))
+                    weights.push_back(weighter(adjacency_t(tail, head)));
+            return WeightedCompressedSparseRow<typename weighter_type::weight_t>(std::move(csr), std::move(weights));
+        }
+
+        /**
+         * write_graph (method)
+         *
+         * This writes the edges to `writer` as a binary graph file (see GraphFile.hpp), each one as its canonical
+         * adjacency, together with its weight for weighted graphs. Vertices are written as they are: the labeler is
+         * not applied.
+         */
+        void write_graph(GraphWriter& writer, const bool compressed = false) const {
+            write_binary(writer, compressed, std::integral_constant<bool, weighter_t::weighted>());
+        }
+
+        /**
+         * write (method)
+         *
+         * This writes the graph to `writer`: a header line with the number of vertices and edges, followed by a line
+         * per edge with the labels of its endpoints (and its weight, for weighted graphs), sorted. Edges are formatted
+         * with `threads` threads (0 means one per hardware thread).
+         */
+        void write(GraphWriter& writer, const unsigned threads = 1) const {
+            write_edges(writer, to_csr(), IdentityOrder(), threads);
+        }
+
+        /**
+         * write_shuffled (method)
+         *
+         * This is the same as write(writer, threads), but the edges are listed in the random order given by `seed`,
+         * computed on the fly with a FeistelPermutation.
+         */
+        void write_shuffled(GraphWriter& writer, const uint64_t seed, const unsigned threads = 1) const {
+            const CompressedSparseRow csr = to_csr();
+            write_edges(writer, csr, FeistelPermutation(csr.size(), seed), threads);
+        }
+
+        /**
+         * to_string (method)
+         *
+         * This returns the output of write_shuffled with a random seed.
+         */
+        std::string to_string() const {
+            std::string result;
+            {
+                GraphWriter writer(result);
+                write_shuffled(writer, random::engine()());
+            }
+            return result;
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const Graph& graph) {
+            return os << graph.to_string();
+        }
     };
+
 }
-#endif // KONIG_GRAPH_HPP
\ No newline at end of file
+
+#endif //KONIG_GRAPH_HPP
@@ -0,0 +1,567 @@
+#ifndef KONIG_GRAPHFILE_HPP
+#define KONIG_GRAPHFILE_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "util.hpp"
+#include "Exception.hpp"
+#include "CompressedSparseRow.hpp"
+#include "AdjacencyManager.hpp"
+#include "GraphWriter.hpp"
+
+namespace konig {
+
+    /**
+     * GraphFileHeader (type)
+     *
+     * This is the header of a Konig binary graph file. The file is laid out as follows, every section starting at a
+     * multiple of 8 bytes, all integers in the native byte order:
+     *
+     *  - the header;
+     *  - the offsets array: (vertices + 1) uint64_t, as in CompressedSparseRow;
+     *  - compressed files only: the byte offsets array, (vertices + 1) uint64_t, where the neighbourhood of the vertex
+     *    v is encoded in the bytes [byte_offsets[v], byte_offsets[v + 1]) of the targets section;
+     *  - the targets section, of targets_bytes bytes: either adjacencies vid_t, or (compressed files) every
+     *    neighbourhood encoded as its first vertex followed by the gaps between consecutive vertices minus one, all as
+     *    LEB128 varints;
+     *  - weighted files only: the weights array, adjacencies * weight_size bytes, aligned with the adjacencies.
+     */
+    struct GraphFileHeader {
+        static const uint64_t MAGIC = 0x46524747494e4f4bULL;      // "KONIGGRF" in a little-endian file
+        static const uint64_t ENDIANNESS = 0x0102030405060708ULL;
+        static const uint32_t VERSION = 1;
+
+        static const uint32_t COMPRESSED = 1;
+        static const uint32_t WEIGHTED = 2;
+
+        uint64_t magic;
+        uint64_t endianness;
+        uint32_t version;
+        uint32_t flags;
+        uint64_t vertices;
+        uint64_t adjacencies;
+        uint64_t targets_bytes;
+        uint32_t weight_size;
+        uint32_t reserved;
+        uint64_t padding;
+    };
+
+    static_assert(sizeof(GraphFileHeader) == 64, "GraphFileHeader must take 64 bytes");
+
+    namespace detail {
+
+        inline uint64_t align_section(const uint64_t size) noexcept {
+            return (size + 7) & ~uint64_t(7);
+        }
+
+        inline size_t varint_length(uint64_t value) noexcept {
+            size_t length = 1;
+            while (value >= 0x80) {
+                value >>= 7;
+                ++length;
+            }
+            return length;
+        }
+
+        inline char* put_varint(uint64_t value, char* out) noexcept {
+            while (value >= 0x80) {
+                *(out++) = static_cast<char>(value | 0x80);
+                value >>= 7;
+            }
+            *(out++) = static_cast<char>(value);
+            return out;
+        }
+
+        inline uint64_t get_varint(const uint8_t*& cursor) noexcept {
+            uint64_t value = 0;
+            for (int shift = 0; ; shift += 7) {
+                const uint8_t byte = *(cursor++);
+                value |= uint64_t(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+        }
+
+        /**
+         * write_graph_file (function)
+         *
+         * This writes a graph file with at least `vertices_no` vertices to `writer`. `source.visit(callback)` must call
+         * `callback(tail, head)` for all the adjacencies, sorted; it is called twice (once to lay out the sections and
+         * once to write them), so the adjacencies are never copied to an intermediate structure.
+         */
+        template<typename source_t>
+        void write_graph_file(GraphWriter& writer, const size_t vertices_no, const source_t& source,
+                              const bool compressed, const void* const weights, const uint32_t weight_size) {
+            static const char ZEROS[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+            std::vector<uint64_t> offsets(vertices_no + 1, 0);
+            std::vector<uint64_t> byte_offsets(compressed ? vertices_no + 1 : 0, 0);
+            uint64_t adjacencies_no = 0;
+            vid_t previous_tail = 0, previous_head = 0;
+
+            // First pass: count the adjacencies (and their encoded bytes) of each vertex
+            source.visit([&](const vid_t tail, const vid_t head) {
+                const size_t needed = size_t(std::max(tail, head)) + 2;
+                if (offsets.size() < needed) {
+                    offsets.resize(needed, 0);
+                    if (compressed)
+                        byte_offsets.resize(needed, 0);
+                }
+
+                ++offsets[tail + 1];
+                if (compressed) {
+                    const bool first = !adjacencies_no || tail != previous_tail;
+                    byte_offsets[tail + 1] += varint_length(first ? head : uint64_t(head - previous_head - 1));
+                }
+                ++adjacencies_no;
+                previous_tail = tail;
+                previous_head = head;
+            });
+
+            for (size_t v = 1; v < offsets.size(); v++) {
+                offsets[v] += offsets[v - 1];
+                if (compressed)
+                    byte_offsets[v] += byte_offsets[v - 1];
+            }
+
+            GraphFileHeader header;
+            std::memset(&header, 0, sizeof(header));
+            header.magic = GraphFileHeader::MAGIC;
+            header.endianness = GraphFileHeader::ENDIANNESS;
+            header.version = GraphFileHeader::VERSION;
+            header.flags = (compressed ? GraphFileHeader::COMPRESSED : 0) | (weights ? GraphFileHeader::WEIGHTED : 0);
+            header.vertices = offsets.size() - 1;
+            header.adjacencies = adjacencies_no;
+            header.targets_bytes = compressed ? byte_offsets.back() : adjacencies_no * sizeof(vid_t);
+            header.weight_size = weights ? weight_size : 0;
+
+            writer.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            writer.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+            if (compressed)
+                writer.write(reinterpret_cast<const char*>(byte_offsets.data()), byte_offsets.size() * sizeof(uint64_t));
+
+            // Second pass: write the targets section
+            adjacencies_no = 0;
+            source.visit([&](const vid_t tail, const vid_t head) {
+                if (compressed) {
+                    char encoded[10];
+                    const bool first = !adjacencies_no || tail != previous_tail;
+                    const uint64_t value = first ? head : uint64_t(head - previous_head - 1);
+                    writer.write(encoded, put_varint(value, encoded) - encoded);
+                } else {
+                    writer.write(reinterpret_cast<const char*>(&head), sizeof(head));
+                }
+                ++adjacencies_no;
+                previous_tail = tail;
+                previous_head = head;
+            });
+            writer.write(ZEROS, align_section(header.targets_bytes) - header.targets_bytes);
+
+            if (weights)
+                writer.write(static_cast<const char*>(weights), adjacencies_no * weight_size);
+            writer.flush();
+        }
+
+        // Sources of adjacencies for write_graph_file
+        struct CompressedSparseRowSource {
+            const CompressedSparseRow& csr;
+
+            template<typename callback_t>
+            void visit(callback_t callback) const {
+                for (vid_t v = 0; v < csr.vertices(); v++)
+                    for (const vid_t head : csr.neighbours(v))
+                        callback(v, head);
+            }
+        };
+
+        template<typename manager_t>
+        struct AdjacencyManagerSource {
+            const manager_t& manager;
+
+            template<typename callback_t>
+            void visit(callback_t callback) const {
+                for (auto it = manager.begin(); it != manager.end(); ++it)
+                    callback(it->first, it->second);
+            }
+        };
+    }
+
+    /**
+     * write_graph (overloaded function)
+     *
+     * This writes `csr` to `writer` as a binary graph file (see GraphFileHeader), compressing its neighbourhoods if
+     * `compressed` is true.
+     */
+    inline void write_graph(GraphWriter& writer, const CompressedSparseRow& csr, const bool compressed = false) {
+        detail::write_graph_file(writer, csr.vertices(), detail::CompressedSparseRowSource{csr}, compressed, NULL, 0);
+    }
+
+    /**
+     * write_graph (overloaded function)
+     *
+     * This writes `csr` and its weights to `writer` as a binary graph file. Weights are copied byte by byte, so
+     * `weight_t` must be trivially copyable.
+     */
+    template<typename weight_t>
+    void write_graph(GraphWriter& writer, const WeightedCompressedSparseRow<weight_t>& csr,
+                     const bool compressed = false) {
+        static_assert(std::is_trivially_copyable<weight_t>::value, "weights must be trivially copyable");
+
+        detail::write_graph_file(writer, csr.vertices(), detail::CompressedSparseRowSource{csr}, compressed,
+                                 csr.weights_data().data(), sizeof(weight_t));
+    }
+
+    /**
+     * write_graph (overloaded function)
+     *
+     * This writes the adjacencies of `manager` to `writer` as a binary graph file with at least `vertices_no`
+     * vertices, visiting the structure directly (no CompressedSparseRow snapshot is built).
+     */
+    template<template<typename> class vertex_index_t, typename tree_t>
+    void write_graph(GraphWriter& writer, const BasicAdjacencyManager<vertex_index_t, tree_t>& manager,
+                     const size_t vertices_no = 0, const bool compressed = false) {
+        typedef BasicAdjacencyManager<vertex_index_t, tree_t> manager_t;
+        detail::write_graph_file(writer, vertices_no, detail::AdjacencyManagerSource<manager_t>{manager}, compressed,
+                                 NULL, 0);
+    }
+
+    /**
+     * MappedGraph (type)
+     *
+     * This is a read-only view of a binary graph file, mapped in memory: opening it costs O(1) regardless of the size
+     * of the graph, and pages are loaded by the operating system as they are accessed. Only the header and the size
+     * of the sections are validated; the content is trusted to come from write_graph.
+     *
+     * The interface follows CompressedSparseRow; neighbourhoods of compressed files are decoded on the fly.
+     */
+    class MappedGraph {
+
+        //////////////////////////
+        // Subtypes             //
+        //////////////////////////
+    public:
+        /**
+         * neighbour_iterator (type)
+         *
+         * This is a forward iterator over the second endpoints of the adjacencies of a vertex, in increasing order.
+         */
+        class neighbour_iterator : public std::iterator<std::forward_iterator_tag, vid_t, std::ptrdiff_t,
+                const vid_t*, const vid_t&> {
+            friend class MappedGraph;
+
+            const vid_t* target;        // plain files
+            const uint8_t* cursor;      // compressed files
+            uint64_t remaining;
+            vid_t value;
+
+            neighbour_iterator(const vid_t* target, const uint8_t* cursor, const uint64_t remaining)
+                    : target(target), cursor(cursor), remaining(remaining), value(0) {
+                if (remaining)
+                    value = target ? *target : static_cast<vid_t>(detail::get_varint(this->cursor));
+            }
+
+        public:
+            neighbour_iterator() : target(NULL), cursor(NULL), remaining(0), value(0) { }
+
+            const vid_t& operator*() const noexcept {
+                return value;
+            }
+
+            neighbour_iterator& operator++() noexcept {
+                if (--remaining)
+                    value = target ? *(++target) : value + static_cast<vid_t>(detail::get_varint(cursor)) + 1;
+                return *this;
+            }
+
+            neighbour_iterator operator++(int) noexcept {
+                neighbour_iterator result = *this;
+                ++(*this);
+                return result;
+            }
+
+            bool operator==(const neighbour_iterator& other) const noexcept {
+                return remaining == other.remaining;
+            }
+
+            bool operator!=(const neighbour_iterator& other) const noexcept {
+                return !(*this == other);
+            }
+        };
+
+        /**
+         * neighbourhood (type)
+         *
+         * This is the range of the second endpoints of the adjacencies of a vertex.
+         */
+        class neighbourhood {
+            neighbour_iterator first;
+            uint64_t length;
+
+        public:
+            neighbourhood(neighbour_iterator first, const uint64_t length) : first(first), length(length) { }
+
+            neighbour_iterator begin() const noexcept {
+                return first;
+            }
+
+            neighbour_iterator end() const noexcept {
+                return neighbour_iterator();
+            }
+
+            size_t size() const noexcept {
+                return length;
+            }
+
+            bool empty() const noexcept {
+                return !length;
+            }
+        };
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        void* mapping = NULL;
+        size_t mapping_size = 0;
+
+        const GraphFileHeader* header = NULL;
+        const uint64_t* offsets = NULL;
+        const uint64_t* byte_offsets = NULL;
+        const uint8_t* targets = NULL;
+        const uint8_t* weights = NULL;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        void unmap() noexcept {
+            if (mapping)
+                munmap(mapping, mapping_size);
+            mapping = NULL;
+        }
+
+        /**
+         * validate (method)
+         *
+         * This checks the header and locates the sections, in O(1).
+         */
+        void validate() {
+            if (mapping_size < sizeof(GraphFileHeader))
+                throw InvalidArgument(context_info("the file is too short to be a graph file"));
+
+            const uint8_t* const base = static_cast<const uint8_t*>(mapping);
+            header = reinterpret_cast<const GraphFileHeader*>(base);
+            if (header->magic != GraphFileHeader::MAGIC)
+                throw InvalidArgument(context_info("the file is not a graph file"));
+            if (header->endianness != GraphFileHeader::ENDIANNESS)
+                throw InvalidArgument(context_info("the graph file was written with a different byte order"));
+            if (header->version != GraphFileHeader::VERSION)
+                throw InvalidArgument(context_info("unsupported graph file version"));
+
+            const uint64_t max_entries = mapping_size / sizeof(uint64_t);
+            if (header->vertices >= max_entries || header->adjacencies > mapping_size ||
+                header->targets_bytes > mapping_size)
+                throw InvalidArgument(context_info("the graph file is truncated"));
+
+            const uint64_t offsets_bytes = (header->vertices + 1) * sizeof(uint64_t);
+            uint64_t expected_size = sizeof(GraphFileHeader) + offsets_bytes * (is_compressed() ? 2 : 1);
+            const uint64_t targets_start = expected_size;
+            expected_size += detail::align_section(header->targets_bytes);
+            const uint64_t weights_start = expected_size;
+            if (is_weighted())
+                expected_size += header->adjacencies * header->weight_size;
+            if (expected_size != mapping_size)
+                throw InvalidArgument(context_info("the graph file is truncated"));
+
+            offsets = reinterpret_cast<const uint64_t*>(base + sizeof(GraphFileHeader));
+            if (is_compressed())
+                byte_offsets = offsets + header->vertices + 1;
+            targets = base + targets_start;
+            weights = is_weighted() ? base + weights_start : NULL;
+
+            if (offsets[header->vertices] != header->adjacencies ||
+                (!is_compressed() && header->targets_bytes != header->adjacencies * sizeof(vid_t)))
+                throw InvalidArgument(context_info("the graph file is corrupted"));
+        }
+
+    public:
+        /**
+         * MappedGraph (constructor)
+         *
+         * This maps the graph file at `path`.
+         */
+        explicit MappedGraph(const std::string& path) {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw InvalidArgument(context_info("cannot open " + path));
+
+            struct stat file_status;
+            if (fstat(fd, &file_status) < 0) {
+                ::close(fd);
+                throw Exception(context_info("cannot stat " + path));
+            }
+            mapping_size = static_cast<size_t>(file_status.st_size);
+
+            if (mapping_size) {
+                mapping = mmap(NULL, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+                if (mapping == MAP_FAILED) {
+                    mapping = NULL;
+                    ::close(fd);
+                    throw Exception(context_info("cannot map " + path));
+                }
+            }
+            ::close(fd);
+
+            try {
+                validate();
+            } catch (...) {
+                unmap();
+                throw;
+            }
+        }
+
+        MappedGraph(const MappedGraph&) = delete;
+        MappedGraph& operator=(const MappedGraph&) = delete;
+
+        MappedGraph(MappedGraph&& other) noexcept
+                : mapping(other.mapping), mapping_size(other.mapping_size), header(other.header),
+                  offsets(other.offsets), byte_offsets(other.byte_offsets), targets(other.targets),
+                  weights(other.weights) {
+            other.mapping = NULL;
+        }
+
+        ~MappedGraph() {
+            unmap();
+        }
+
+        bool is_compressed() const noexcept {
+            return header->flags & GraphFileHeader::COMPRESSED;
+        }
+
+        bool is_weighted() const noexcept {
+            return header->flags & GraphFileHeader::WEIGHTED;
+        }
+
+        /**
+         * vertices (method)
+         *
+         * This returns the number of vertices.
+         */
+        size_t vertices() const noexcept {
+            return header->vertices;
+        }
+
+        /**
+         * size (method)
+         *
+         * This returns the number of adjacencies.
+         */
+        size_t size() const noexcept {
+            return header->adjacencies;
+        }
+
+        /**
+         * degree (method)
+         *
+         * This returns the number of adjacencies having `vertex` as first endpoint.
+         *
+         * @pre `vertex` < vertices()
+         */
+        size_t degree(const vid_t vertex) const noexcept {
+            return offsets[vertex + 1] - offsets[vertex];
+        }
+
+        /**
+         * neighbours (method)
+         *
+         * This returns the second endpoints of the adjacencies having `vertex` as first endpoint, in increasing order.
+         *
+         * @pre `vertex` < vertices()
+         */
+        neighbourhood neighbours(const vid_t vertex) const noexcept {
+            const uint64_t length = degree(vertex);
+            if (is_compressed())
+                return neighbourhood(neighbour_iterator(NULL, targets + byte_offsets[vertex], length), length);
+            return neighbourhood(
+                    neighbour_iterator(reinterpret_cast<const vid_t*>(targets) + offsets[vertex], NULL, length), length);
+        }
+
+        /**
+         * position (method)
+         *
+         * This returns the index of `adjacency` among all the adjacencies (the index of its weight), or size() if the
+         * adjacency does not exist. Neighbourhoods are binary searched in plain files and scanned in compressed ones.
+         */
+        size_t position(const adjacency_t adjacency) const noexcept {
+            if (adjacency.first >= vertices())
+                return size();
+
+            if (!is_compressed()) {
+                const vid_t* const first = reinterpret_cast<const vid_t*>(targets) + offsets[adjacency.first];
+                const vid_t* const last = reinterpret_cast<const vid_t*>(targets) + offsets[adjacency.first + 1];
+                const vid_t* const found = std::lower_bound(first, last, adjacency.second);
+                return (found != last && *found == adjacency.second) ? found - reinterpret_cast<const vid_t*>(targets)
+                                                                     : size();
+            }
+
+            size_t index = offsets[adjacency.first];
+            for (const vid_t head : neighbours(adjacency.first)) {
+                if (head >= adjacency.second)
+                    return head == adjacency.second ? index : size();
+                ++index;
+            }
+            return size();
+        }
+
+        /**
+         * has (method)
+         *
+         * This checks whether `adjacency` exists.
+         */
+        bool has(const adjacency_t adjacency) const noexcept {
+            return position(adjacency) != size();
+        }
+
+        /**
+         * weights_data (method)
+         *
+         * This returns the weights array, made of size() entries.
+         */
+        template<typename weight_t>
+        const weight_t* weights_data() const {
+            if (!is_weighted())
+                throw StructureViolation(context_info("the graph file has no weights"));
+            if (header->weight_size != sizeof(weight_t))
+                throw InvalidArgument(context_info("the weights of the graph file have a different size"));
+            return reinterpret_cast<const weight_t*>(weights);
+        }
+
+        /**
+         * to_csr (method)
+         *
+         * This decodes the whole graph into a CompressedSparseRow.
+         */
+        CompressedSparseRow to_csr() const {
+            std::vector<size_t> csr_offsets(offsets, offsets + vertices() + 1);
+            std::vector<vid_t> csr_targets;
+            csr_targets.reserve(size());
+            for (vid_t v = 0; v < vertices(); v++)
+                for (const vid_t head : neighbours(v))
+                    csr_targets.push_back(head);
+            return CompressedSparseRow(std::move(csr_offsets), std::move(csr_targets));
+        }
+    };
+
+}
+
+#endif //KONIG_GRAPHFILE_HPP
@@ -0,0 +1,493 @@
+#ifndef KONIG_GRAPHWRITER_HPP
+#define KONIG_GRAPHWRITER_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <unistd.h>
+#include "util.hpp"
+#include "Exception.hpp"
+#include "CompressedSparseRow.hpp"
+#include "Permutation.hpp"
+
+namespace konig {
+
+    namespace format {
+
+        /**
+         * format_uint (function)
+         *
+         * This writes the decimal representation of `value` starting at `out`, and returns the pointer past its last
+         * character. Digits are produced two at a time from a lookup table. At most 20 characters are written.
+         */
+        inline char* format_uint(uint64_t value, char* out) noexcept {
+            static const char DIGIT_PAIRS[] =
+                    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                    "8081828384858687888990919293949596979899";
+
+            char digits[20];
+            char* cursor = digits + 20;
+
+            while (value >= 100) {
+                const unsigned pair = static_cast<unsigned>(value % 100) * 2;
+                value /= 100;
+                *(--cursor) = DIGIT_PAIRS[pair + 1];
+                *(--cursor) = DIGIT_PAIRS[pair];
+            }
+            if (value >= 10) {
+                const unsigned pair = static_cast<unsigned>(value) * 2;
+                *(--cursor) = DIGIT_PAIRS[pair + 1];
+                *(--cursor) = DIGIT_PAIRS[pair];
+            } else {
+                *(--cursor) = static_cast<char>('0' + value);
+            }
+
+            const size_t length = digits + 20 - cursor;
+            std::memcpy(out, cursor, length);
+            return out + length;
+        }
+
+        /**
+         * format_int (function)
+         *
+         * This is the same as format_uint, for signed values. At most 20 characters are written.
+         */
+        inline char* format_int(const int64_t value, char* out) noexcept {
+            if (value < 0) {
+                *(out++) = '-';
+                return format_uint(0 - static_cast<uint64_t>(value), out);
+            }
+            return format_uint(static_cast<uint64_t>(value), out);
+        }
+    }
+
+    /**
+     * TextBuffer (type)
+     *
+     * This is a growable character buffer with fast formatting of the values that appear in a graph description
+     * (integers, floating point numbers, strings). Integers are formatted by hand, without going through iostreams or
+     * printf.
+     */
+    class TextBuffer {
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        static const size_t MAX_NUMBER_LENGTH = 32;
+
+        std::vector<char> storage;
+        size_t length = 0;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        /**
+         * tail (method)
+         *
+         * This makes room for `characters` more characters and returns the pointer to the first free one.
+         */
+        char* tail(const size_t characters) {
+            if (length + characters > storage.size())
+                storage.resize(std::max(storage.size() * 2, length + characters));
+            return storage.data() + length;
+        }
+
+        template<typename T>
+        void put_number(const T value, std::true_type /* is_integral */) {
+            char* out = tail(MAX_NUMBER_LENGTH);
+            if (std::is_signed<T>::value)
+                length = format::format_int(static_cast<int64_t>(value), out) - storage.data();
+            else
+                length = format::format_uint(static_cast<uint64_t>(value), out) - storage.data();
+        }
+
+        template<typename T>
+        void put_number(const T value, std::false_type /* is_integral */) {
+            char* out = tail(MAX_NUMBER_LENGTH);
+            length += std::snprintf(out, MAX_NUMBER_LENGTH, "%g", static_cast<double>(value));
+        }
+
+    public:
+        explicit TextBuffer(const size_t capacity = 0) : storage(capacity) { }
+
+        /**
+         * put (overloaded method)
+         *
+         * This appends the decimal representation of a number.
+         */
+        template<typename T>
+        typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, char>::value, TextBuffer&>::type
+        put(const T value) {
+            put_number(value, std::is_integral<T>());
+            return *this;
+        }
+
+        /**
+         * put (overloaded method)
+         *
+         * This appends a single character.
+         */
+        TextBuffer& put(const char character) {
+            *tail(1) = character;
+            ++length;
+            return *this;
+        }
+
+        /**
+         * put (overloaded method)
+         *
+         * This appends `size` characters starting from `characters` (which may be NULL if `size` is 0).
+         */
+        TextBuffer& put(const char* const characters, const size_t size) {
+            if (!size)
+                return *this;
+            std::memcpy(tail(size), characters, size);
+            length += size;
+            return *this;
+        }
+
+        /**
+         * put (overloaded method)
+         *
+         * This appends a string.
+         */
+        TextBuffer& put(const std::string& characters) {
+            return put(characters.data(), characters.size());
+        }
+
+        /**
+         * put (overloaded method)
+         *
+         * This appends a NUL-terminated string.
+         */
+        TextBuffer& put(const char* const characters) {
+            return put(characters, std::strlen(characters));
+        }
+
+        const char* data() const noexcept {
+            return storage.data();
+        }
+
+        size_t size() const noexcept {
+            return length;
+        }
+
+        void clear() noexcept {
+            length = 0;
+        }
+    };
+
+    /**
+     * GraphWriter (type)
+     *
+     * This writes text to a file descriptor, a FILE* or a std::string, through a big TextBuffer which is flushed once
+     * it grows past `flush_threshold` characters: the output is never materialized as a whole.
+     *
+     * write_items() formats a sequence of items (typically, the edges of a graph) in parallel: the sequence is cut into
+     * blocks, each thread formats whole blocks into its own buffer, and the buffers are then written in order, so the
+     * output does not depend on the number of threads.
+     */
+    class GraphWriter {
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        static const size_t DEFAULT_FLUSH_THRESHOLD = 1 << 20;
+        static const size_t ITEMS_PER_BLOCK = 1 << 15;
+
+        int fd = -1;
+        std::FILE* file = NULL;
+        std::string* string = NULL;
+
+        size_t flush_threshold = DEFAULT_FLUSH_THRESHOLD;
+        TextBuffer text_buffer;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        /**
+         * write_through (method)
+         *
+         * This writes `size` characters to the underlying sink, bypassing the buffer.
+         */
+        void write_through(const char* characters, size_t size) {
+            if (string) {
+                string->append(characters, size);
+            } else if (file) {
+                if (std::fwrite(characters, 1, size, file) != size)
+                    throw Exception(context_info("cannot write to the output file"));
+            } else {
+                while (size) {
+                    const ssize_t written = ::write(fd, characters, size);
+                    if (written < 0) {
+                        if (errno == EINTR)
+                            continue;
+                        throw Exception(context_info("cannot write to the output file descriptor"));
+                    }
+                    characters += written;
+                    size -= written;
+                }
+            }
+        }
+
+        void flush_if_full() {
+            if (text_buffer.size() >= flush_threshold)
+                flush();
+        }
+
+    public:
+        /**
+         * GraphWriter (constructor)
+         *
+         * This creates a writer to the file descriptor `fd`, which is not closed by the writer.
+         */
+        explicit GraphWriter(const int fd, const size_t flush_threshold = DEFAULT_FLUSH_THRESHOLD)
+                : fd(fd), flush_threshold(flush_threshold), text_buffer(flush_threshold + 64) { }
+
+        /**
+         * GraphWriter (constructor)
+         *
+         * This creates a writer to `file`, which is not closed by the writer.
+         */
+        explicit GraphWriter(std::FILE* const file, const size_t flush_threshold = DEFAULT_FLUSH_THRESHOLD)
+                : file(file), flush_threshold(flush_threshold), text_buffer(flush_threshold + 64) { }
+
+        /**
+         * GraphWriter (constructor)
+         *
+         * This creates a writer appending to `string`.
+         */
+        explicit GraphWriter(std::string& string, const size_t flush_threshold = DEFAULT_FLUSH_THRESHOLD)
+                : string(&string), flush_threshold(flush_threshold), text_buffer(flush_threshold + 64) { }
+
+        GraphWriter(const GraphWriter&) = delete;
+        GraphWriter& operator=(const GraphWriter&) = delete;
+
+        ~GraphWriter() {
+            try {
+                flush();
+            } catch (const Exception&) {
+                // Destructors must not throw: call flush() explicitly to be notified of errors
+            }
+        }
+
+        /**
+         * put (method)
+         *
+         * This appends a value (see TextBuffer::put) to the output.
+         */
+        template<typename T>
+        GraphWriter& put(const T& value) {
+            text_buffer.put(value);
+            flush_if_full();
+            return *this;
+        }
+
+        /**
+         * write (overloaded method)
+         *
+         * This appends `size` raw bytes starting from `characters` to the output.
+         */
+        void write(const char* const characters, const size_t size) {
+            if (text_buffer.size() + size < flush_threshold) {
+                text_buffer.put(characters, size);
+            } else {
+                flush();
+                write_through(characters, size);
+            }
+        }
+
+        /**
+         * write (overloaded method)
+         *
+         * This appends the content of `buffer` to the output.
+         */
+        void write(const TextBuffer& buffer) {
+            write(buffer.data(), buffer.size());
+        }
+
+        /**
+         * flush (method)
+         *
+         * This writes the buffered characters to the underlying sink.
+         */
+        void flush() {
+            if (text_buffer.size()) {
+                write_through(text_buffer.data(), text_buffer.size());
+                text_buffer.clear();
+            }
+            if (file)
+                std::fflush(file);
+        }
+
+        /**
+         * write_items (method)
+         *
+         * This appends `count` items to the output, using `threads` threads (0 means one per hardware thread). The
+         * items are cut into blocks, and `formatter(buffer, first, last)` is called to format the items in
+         * [first, last) into the TextBuffer `buffer`: it may be called concurrently from different threads, but items
+         * always appear in index order, whatever the number of threads.
+         *
+         * The blocks are dealt round-robin to `threads` workers, spawned once, each formatting into its own buffer;
+         * the calling thread writes the buffers out in order, and a worker moves on to its next block as soon as its
+         * buffer has been written. An exception thrown by the formatter or by the sink stops all the workers and is
+         * rethrown.
+         */
+        template<typename formatter_t>
+        void write_items(const size_t count, formatter_t formatter, unsigned threads = 1) {
+            if (!threads)
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            const size_t blocks_no = (count + ITEMS_PER_BLOCK - 1) / ITEMS_PER_BLOCK;
+            threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, blocks_no)));
+
+            if (threads == 1) {
+                for (size_t first = 0; first < count; first += ITEMS_PER_BLOCK) {
+                    formatter(text_buffer, first, std::min(count, first + ITEMS_PER_BLOCK));
+                    flush_if_full();
+                }
+                return;
+            }
+
+            std::vector<TextBuffer> buffers(threads);
+            std::vector<size_t> formatted(threads, 0);  // blocks formatted by each worker
+            std::vector<size_t> written(threads, 0);    // blocks of each worker already written out
+            std::mutex mutex;
+            std::condition_variable changed;
+            bool aborted = false;
+            std::exception_ptr error;
+
+            auto abort = [&]() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                    aborted = true;
+                }
+                changed.notify_all();
+            };
+
+            auto worker = [&](const unsigned index) {
+                try {
+                    for (size_t block = index, round = 0; block < blocks_no; block += threads, round++) {
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            changed.wait(lock, [&]() { return aborted || written[index] == round; });
+                            if (aborted)
+                                return;
+                        }
+
+                        const size_t first = block * ITEMS_PER_BLOCK;
+                        buffers[index].clear();
+                        formatter(buffers[index], first, std::min(count, first + ITEMS_PER_BLOCK));
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            formatted[index] = round + 1;
+                        }
+                        changed.notify_all();
+                    }
+                } catch (...) {
+                    abort();
+                }
+            };
+
+            std::vector<std::thread> pool;
+            for (unsigned index = 0; index < threads; index++)
+                pool.emplace_back(worker, index);
+
+            try {
+                for (size_t block = 0; block < blocks_no; block++) {
+                    const unsigned index = static_cast<unsigned>(block % threads);
+                    const size_t round = block / threads;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        changed.wait(lock, [&]() { return aborted || formatted[index] > round; });
+                        if (aborted)
+                            break;
+                    }
+
+                    if (buffers[index].size())
+                        write(buffers[index]);
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        written[index] = round + 1;
+                    }
+                    changed.notify_all();
+                }
+            } catch (...) {
+                abort();
+            }
+
+            for (auto& thread : pool)
+                thread.join();
+            if (error)
+                std::rethrow_exception(error);
+        }
+    };
+
+    /**
+     * write_adjacencies (function)
+     *
+     * This writes the adjacencies of `csr` to `writer`, one per line as "tail head", in order, formatting them with
+     * `threads` threads (0 means one per hardware thread).
+     */
+    inline void write_adjacencies(GraphWriter& writer, const CompressedSparseRow& csr, const unsigned threads = 1) {
+        const size_t* const offsets = csr.offsets_data().data();
+        const vid_t* const targets = csr.targets_data().data();
+        const size_t* const offsets_end = offsets + csr.offsets_data().size();
+
+        writer.write_items(csr.size(), [=](TextBuffer& buffer, size_t first, const size_t last) {
+            // The tail of the first adjacency of the block is the last vertex whose range starts before it
+            vid_t tail = static_cast<vid_t>(std::upper_bound(offsets, offsets_end, first) - offsets - 1);
+            for (; first < last; first++) {
+                while (offsets[tail + 1] <= first)
+                    ++tail;
+                buffer.put(tail).put(' ').put(targets[first]).put('\n');
+            }
+        }, threads);
+    }
+
+    /**
+     * write_adjacencies (function)
+     *
+     * This is the same as write_adjacencies(writer, csr, threads), but the i-th line is the adjacency stored at
+     * position order(i): with a FeistelPermutation, the adjacencies are written in a random order without
+     * materializing a shuffled copy of them.
+     *
+     * @pre order.size() == csr.size()
+     */
+    inline void write_adjacencies(GraphWriter& writer, const CompressedSparseRow& csr, const FeistelPermutation& order,
+                                  const unsigned threads = 1) {
+        if (order.size() != csr.size())
+            throw InvalidArgument(context_info("the order does not cover the adjacencies"));
+
+        const size_t* const offsets = csr.offsets_data().data();
+        const vid_t* const targets = csr.targets_data().data();
+        const size_t* const offsets_end = offsets + csr.offsets_data().size();
+
+        writer.write_items(csr.size(), [=, &order](TextBuffer& buffer, size_t first, const size_t last) {
+            for (; first < last; first++) {
+                const size_t position = order(first);
+                const vid_t tail = static_cast<vid_t>(std::upper_bound(offsets, offsets_end, position) - offsets - 1);
+                buffer.put(tail).put(' ').put(targets[position]).put('\n');
+            }
+        }, threads);
+    }
+
+}
+
+#endif //KONIG_GRAPHWRITER_HPP
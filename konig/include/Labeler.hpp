@@ -0,0 +1,136 @@
+#ifndef KONIG_LABELER_HPP
+#define KONIG_LABELER_HPP
+
+#include <limits>
+#include <utility>
+#include <vector>
+#include "util.hpp"
+#include "Exception.hpp"
+#include "Permutation.hpp"
+
+namespace konig {
+
+    /*
+     * Labelers are the policies used by the Graph classes to turn vertex indices into the labels which are written to
+     * the output. A labeler defines the type `label_t` and a const, deterministic and injective
+     * `operator()(vid_t vertex)`. Since labelers are template arguments, calls to them are resolved at compile time and
+     * usually inlined.
+     *
+     * Labelers which can only label a limited number of vertices also define `size()`, which the Graph constructor
+     * checks against the number of vertices.
+     */
+
+    namespace detail {
+
+        /**
+         * labels_no (overloaded function)
+         *
+         * This returns labeler.size() when the labeler defines it, or the maximum uint64_t otherwise. It is meant to
+         * be called as labels_no(labeler, 0).
+         */
+        template<typename labeler_t>
+        auto labels_no(const labeler_t& labeler, int) -> decltype(uint64_t(labeler.size())) {
+            return labeler.size();
+        }
+
+        template<typename labeler_t>
+        uint64_t labels_no(const labeler_t&, long) noexcept {
+            return std::numeric_limits<uint64_t>::max();
+        }
+    }
+
+    /**
+     * IdentityLabeler (type)
+     *
+     * This labels each vertex with its own index.
+     */
+    struct IdentityLabeler {
+        typedef vid_t label_t;
+
+        vid_t operator()(const vid_t vertex) const noexcept {
+            return vertex;
+        }
+    };
+
+    /**
+     * IotaLabeler (type)
+     *
+     * This labels the i-th vertex with the integer start + i.
+     */
+    class IotaLabeler {
+    private:
+        int64_t start;
+
+    public:
+        typedef int64_t label_t;
+
+        explicit IotaLabeler(const int64_t start = 0) : start(start) { }
+
+        int64_t operator()(const vid_t vertex) const noexcept {
+            return start + vertex;
+        }
+    };
+
+    /**
+     * PermutationLabeler (type)
+     *
+     * This assigns to the vertices distinct random labels from the range [start, end), through a FeistelPermutation:
+     * unlike shuffling a vector with all the labels of the range, it takes O(1) memory regardless of the width of the
+     * range, and the labels only depend on the seed. The range must not be empty, and the Graph constructor rejects
+     * graphs with more than end - start vertices.
+     */
+    class PermutationLabeler {
+    private:
+        int64_t start;
+        FeistelPermutation permutation;
+
+    public:
+        typedef int64_t label_t;
+
+        PermutationLabeler(const int64_t start, const int64_t end, const uint64_t seed)
+                : start(start), permutation(end > start ? uint64_t(end - start) : 1, seed) {
+            if (end <= start)
+                throw InvalidArgument(context_info("the range of the labels is empty"));
+        }
+
+        /**
+         * size (method)
+         *
+         * This returns the number of available labels, i.e. the maximum number of vertices which can be labelled.
+         */
+        uint64_t size() const noexcept {
+            return permutation.size();
+        }
+
+        int64_t operator()(const vid_t vertex) const noexcept {
+            return start + static_cast<int64_t>(permutation(vertex));
+        }
+    };
+
+    /**
+     * StaticLabeler (type)
+     *
+     * This labels the i-th vertex with the i-th element of a given vector of labels.
+     */
+    template<typename T>
+    class StaticLabeler {
+    private:
+        std::vector<T> labels;
+
+    public:
+        typedef T label_t;
+
+        explicit StaticLabeler(std::vector<T> labels) : labels(std::move(labels)) { }
+
+        uint64_t size() const noexcept {
+            return labels.size();
+        }
+
+        const T& operator()(const vid_t vertex) const noexcept {
+            return labels[vertex];
+        }
+    };
+
+}
+
+#endif //KONIG_LABELER_HPP
@@ -0,0 +1,362 @@
+#ifndef KONIG_NODEPOOL_HPP
+#define KONIG_NODEPOOL_HPP
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include "Exception.hpp"
+
+namespace konig {
+
+    /**
+     * NodePool (type)
+     *
+     * This is a slab allocator for the vertices of the node-based structures of Konig (such as AdjacencyTree).
+     * Instead of requesting memory to the global allocator one node at a time, it carves nodes out of big blocks
+     * whose size grows geometrically, and it keeps destroyed nodes in an intrusive free list so that their memory
+     * is reused by the next creation.
+     *
+     * Since the blocks are released all at once when the pool is destroyed (or cleared), no per-node destructor is
+     * ever run: this is why `T` is required to be trivially destructible.
+     */
+    template<typename T>
+    class NodePool {
+        static_assert(std::is_trivially_destructible<T>::value, "NodePool requires trivially destructible nodes");
+
+        //////////////////////////
+        // Subtypes             //
+        //////////////////////////
+
+    private:
+        /**
+         * Slot (type)
+         *
+         * A slot either holds a live node, or (while it is free) the pointer to the next free slot.
+         */
+        union Slot {
+            Slot* next_free;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        };
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+
+    private:
+        static const size_t MIN_BLOCK_SIZE = 64;
+        static const size_t MAX_BLOCK_SIZE = 1 << 16;
+
+        std::vector<std::unique_ptr<Slot[]>> blocks;
+        size_t next_block_size = MIN_BLOCK_SIZE;
+
+        // Slots of the last block that have never been handed out
+        Slot* block_cursor = NULL;
+        Slot* block_end = NULL;
+
+        Slot* free_list = NULL;
+        size_t free_slots = 0;
+
+        size_t live_nodes = 0;
+        size_t total_slots = 0;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+
+    private:
+        /**
+         * allocate_block (method)
+         *
+         * This allocates a new block of `block_size` slots, which becomes the block new nodes are carved from. Any
+         * untouched slot left in the previous block is moved to the free list, so that it is not lost.
+         */
+        void allocate_block(const size_t block_size) {
+            std::unique_ptr<Slot[]> block(new Slot[block_size]);
+
+            while (block_cursor != block_end) {
+                block_cursor->next_free = free_list;
+                free_list = block_cursor++;
+                ++free_slots;
+            }
+
+            block_cursor = block.get();
+            block_end = block.get() + block_size;
+            total_slots += block_size;
+            blocks.push_back(std::move(block));
+        }
+
+    public:
+        NodePool() = default;
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+
+        /**
+         * create (method)
+         *
+         * This constructs a new node, forwarding `args` to the constructor of `T`, and returns a pointer to it.
+         */
+        template<typename... Args>
+        T* create(Args&&... args) {
+            Slot* slot;
+
+            if (free_list) {
+                slot = free_list;
+                free_list = free_list->next_free;
+                --free_slots;
+            } else {
+                if (block_cursor == block_end) {
+                    allocate_block(next_block_size);
+                    if (next_block_size < MAX_BLOCK_SIZE)
+                        next_block_size *= 2;
+                }
+                slot = block_cursor++;
+            }
+
+            ++live_nodes;
+            return new (&slot->storage) T(std::forward<Args>(args)...);
+        }
+
+        /**
+         * destroy (method)
+         *
+         * This gives back to the pool the memory of a node previously returned by create().
+         *
+         * @pre `node` in *not* NULL, and belongs to this pool
+         */
+        void destroy(T* const node) noexcept {
+#ifdef KONIG_DEBUG
+            assert(node);
+            assert(live_nodes > 0);
+#endif
+            Slot* slot = reinterpret_cast<Slot*>(node);
+            slot->next_free = free_list;
+            free_list = slot;
+            ++free_slots;
+            --live_nodes;
+        }
+
+        /**
+         * reserve (method)
+         *
+         * This makes sure that the next `nodes` calls to create() will not need to allocate memory, by allocating
+         * (at most) a single block big enough to host the missing nodes.
+         */
+        void reserve(const size_t nodes) {
+            const size_t available = free_slots + (block_end - block_cursor);
+            if (nodes > available)
+                allocate_block(nodes - available);
+        }
+
+        /**
+         * clear (method)
+         *
+         * This releases all the blocks at once. All the nodes created so far are invalidated.
+         */
+        void clear() noexcept {
+            blocks.clear();
+            next_block_size = MIN_BLOCK_SIZE;
+            block_cursor = block_end = NULL;
+            free_list = NULL;
+            free_slots = live_nodes = total_slots = 0;
+        }
+
+        /**
+         * size (method)
+         *
+         * This returns the number of live nodes.
+         */
+        size_t size() const noexcept {
+            return live_nodes;
+        }
+
+        /**
+         * capacity (method)
+         *
+         * This returns the number of slots allocated so far, either live or free.
+         */
+        size_t capacity() const noexcept {
+            return total_slots;
+        }
+    };
+
+    /**
+     * IndexedNodePool (type)
+     *
+     * This is a NodePool which hands out 32-bit indices instead of pointers, so that the nodes can link each other with
+     * half the memory. Index 0 is never handed out, and can be used as the null link. At most 2^32 - 1 nodes can be
+     * created.
+     *
+     * The nodes live in a single array, so that resolving an index is a single addition. The array grows
+     * geometrically with realloc (which, for big arrays, remaps the pages instead of copying them): hence `T` must be
+     * trivially copy constructible, and references to the nodes are invalidated by create() and reserve(), while
+     * their indices stay valid.
+     */
+    template<typename T>
+    class IndexedNodePool {
+        static_assert(std::is_trivially_destructible<T>::value, "IndexedNodePool requires trivially destructible nodes");
+        static_assert(std::is_trivially_copy_constructible<T>::value, "IndexedNodePool relocates its nodes bitwise");
+
+        //////////////////////////
+        // Subtypes             //
+        //////////////////////////
+
+    public:
+        typedef uint32_t index_t;
+
+    private:
+        union Slot {
+            index_t next_free;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        };
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+
+    private:
+        static const uint64_t MIN_SLOTS = 64;
+        static const uint64_t MAX_INDEX = (uint64_t(1) << 32) - 1;
+
+        // slots[0] is never used, so that the indices can be used directly
+        Slot* slots = NULL;
+        uint64_t total_slots = 0;
+
+        // The first index that has never been handed out
+        uint64_t next_index = 1;
+
+        index_t free_list = 0;
+        size_t free_slots = 0;
+
+        size_t live_nodes = 0;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+
+    private:
+        /**
+         * grow (method)
+         *
+         * This enlarges the array to host (at least) `slots_no` slots. The nodes keep their indices.
+         */
+        void grow(uint64_t slots_no) {
+            if (slots_no > MAX_INDEX)
+                throw StructureViolation(context_info("an IndexedNodePool cannot hold more than 2^32 - 1 nodes"));
+            slots_no = std::max(slots_no, std::min(uint64_t(MAX_INDEX), std::max(uint64_t(MIN_SLOTS), 2 * total_slots)));
+
+            Slot* const grown = static_cast<Slot*>(std::realloc(slots, (slots_no + 1) * sizeof(Slot)));
+            if (!grown)
+                throw std::bad_alloc();
+            slots = grown;
+            total_slots = slots_no;
+        }
+
+    public:
+        IndexedNodePool() = default;
+        IndexedNodePool(const IndexedNodePool&) = delete;
+        IndexedNodePool& operator=(const IndexedNodePool&) = delete;
+
+        ~IndexedNodePool() {
+            std::free(slots);
+        }
+
+        /**
+         * create (method)
+         *
+         * This constructs a new node, forwarding `args` to the constructor of `T`, and returns its index.
+         */
+        template<typename... Args>
+        index_t create(Args&&... args) {
+            index_t index;
+
+            if (free_list) {
+                index = free_list;
+                free_list = slots[index].next_free;
+                --free_slots;
+            } else {
+                if (next_index > total_slots)
+                    grow(next_index);
+                index = static_cast<index_t>(next_index++);
+            }
+
+            ++live_nodes;
+            new (&slots[index].storage) T(std::forward<Args>(args)...);
+            return index;
+        }
+
+        /**
+         * destroy (method)
+         *
+         * This gives back to the pool the slot of a node previously returned by create().
+         *
+         * @pre `index` in *not* 0, and belongs to this pool
+         */
+        void destroy(const index_t index) noexcept {
+#ifdef KONIG_DEBUG
+            assert(index);
+            assert(live_nodes > 0);
+#endif
+            slots[index].next_free = free_list;
+            free_list = index;
+            ++free_slots;
+            --live_nodes;
+        }
+
+        /**
+         * operator[] (method)
+         *
+         * This returns the node with the given index. Just like a pointer, this doesn't propagate the constness of the
+         * pool to the node.
+         *
+         * @pre `index` in *not* 0, and belongs to this pool
+         */
+        T& operator[](const index_t index) const noexcept {
+            return *reinterpret_cast<T*>(&slots[index].storage);
+        }
+
+        /**
+         * reserve (method)
+         *
+         * This makes sure that the next `nodes` calls to create() will not need to allocate memory, by growing the
+         * array (at most) once.
+         */
+        void reserve(const size_t nodes) {
+            const uint64_t available = free_slots + (total_slots + 1 - next_index);
+            if (nodes > available)
+                grow(total_slots + (nodes - available));
+        }
+
+        /**
+         * clear (method)
+         *
+         * This releases the array. All the nodes created so far are invalidated.
+         */
+        void clear() noexcept {
+            std::free(slots);
+            slots = NULL;
+            total_slots = 0;
+            next_index = 1;
+            free_list = 0;
+            free_slots = live_nodes = 0;
+        }
+
+        size_t size() const noexcept {
+            return live_nodes;
+        }
+
+        size_t capacity() const noexcept {
+            return total_slots;
+        }
+    };
+
+}
+
+#endif //KONIG_NODEPOOL_HPP
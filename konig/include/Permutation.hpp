@@ -0,0 +1,125 @@
+#ifndef KONIG_PERMUTATION_HPP
+#define KONIG_PERMUTATION_HPP
+
+#include "util.hpp"
+#include "Exception.hpp"
+
+namespace konig {
+
+    /**
+     * FeistelPermutation (type)
+     *
+     * This is a keyed pseudo-random bijection of [0, size), computed on the fly in O(1) time and memory: it replaces
+     * the materialization and shuffling of a vector of `size` elements. The same seed always gives the same
+     * permutation, and since every element is mapped independently the permutation can be evaluated by many threads
+     * at once.
+     *
+     * It is a balanced Feistel network over the smallest even number of bits covering `size`, whose round function is
+     * a keyed 64-bit mixer; values falling outside [0, size) are mapped again ("cycle walking") until they land inside,
+     * which takes less than 4 rounds of the network on average.
+     */
+    class FeistelPermutation {
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        static const int ROUNDS = 6;
+
+        uint64_t domain_size;
+        int half_bits;
+        uint64_t half_mask;
+        uint64_t keys[ROUNDS];
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        uint64_t round_function(const uint64_t half, const int round) const noexcept {
+            uint64_t z = (half ^ keys[round]) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 31)) * 0x94d049bb133111ebULL;
+            return (z ^ (z >> 29)) & half_mask;
+        }
+
+        uint64_t encrypt(const uint64_t value) const noexcept {
+            uint64_t left = value >> half_bits, right = value & half_mask;
+            for (int round = 0; round < ROUNDS; round++) {
+                const uint64_t next_right = left ^ round_function(right, round);
+                left = right;
+                right = next_right;
+            }
+            return (left << half_bits) | right;
+        }
+
+        uint64_t decrypt(const uint64_t value) const noexcept {
+            uint64_t left = value >> half_bits, right = value & half_mask;
+            for (int round = ROUNDS - 1; round >= 0; round--) {
+                const uint64_t previous_left = right ^ round_function(left, round);
+                right = left;
+                left = previous_left;
+            }
+            return (left << half_bits) | right;
+        }
+
+    public:
+        /**
+         * FeistelPermutation (constructor)
+         *
+         * This creates the permutation of [0, size) identified by `seed`.
+         *
+         * @pre `size` <= 2^62
+         */
+        FeistelPermutation(const uint64_t size, uint64_t seed) : domain_size(size), half_bits(1) {
+            if (size > (uint64_t(1) << 62))
+                throw InvalidArgument(context_info("the permutation domain is too big"));
+
+            while (half_bits < 31 && (uint64_t(1) << (2 * half_bits)) < size)
+                ++half_bits;
+            half_mask = (uint64_t(1) << half_bits) - 1;
+
+            for (auto& key : keys)
+                key = random::splitmix64(seed);
+        }
+
+        /**
+         * size (method)
+         *
+         * This returns the size of the domain.
+         */
+        uint64_t size() const noexcept {
+            return domain_size;
+        }
+
+        /**
+         * operator() (method)
+         *
+         * This returns the image of `value`.
+         *
+         * @pre `value` < size()
+         */
+        uint64_t operator()(uint64_t value) const noexcept {
+            do {
+                value = encrypt(value);
+            } while (value >= domain_size);
+            return value;
+        }
+
+        /**
+         * inverse (method)
+         *
+         * This returns the value whose image is `image`.
+         *
+         * @pre `image` < size()
+         */
+        uint64_t inverse(uint64_t image) const noexcept {
+            do {
+                image = decrypt(image);
+            } while (image >= domain_size);
+            return image;
+        }
+    };
+
+}
+
+#endif //KONIG_PERMUTATION_HPP
@@ -0,0 +1,418 @@
+#ifndef KONIG_RANGESAMPLER_HPP
+#define KONIG_RANGESAMPLER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include "util.hpp"
+#include "Exception.hpp"
+#include "AdjacencyTree.hpp"
+
+namespace konig {
+
+    namespace sampling {
+
+        namespace detail {
+
+            /**
+             * stirling_error (function)
+             *
+             * This returns log(k!) - log(sqrt(2 pi k) (k / e)^k), the (small) error of Stirling's approximation.
+             */
+            inline double stirling_error(const double k) {
+                if (k <= 15) {
+                    static const double half_log_2pi = 0.918938533204672741780329736406;
+                    return std::lgamma(k + 1) - (k + 0.5) * std::log(k) + k - half_log_2pi;
+                }
+
+                const double k2 = k * k;
+                const double s0 = 1.0 / 12, s1 = 1.0 / 360, s2 = 1.0 / 1260, s3 = 1.0 / 1680, s4 = 1.0 / 1188;
+                if (k > 500)
+                    return (s0 - s1 / k2) / k;
+                if (k > 80)
+                    return (s0 - (s1 - s2 / k2) / k2) / k;
+                if (k > 35)
+                    return (s0 - (s1 - (s2 - s3 / k2) / k2) / k2) / k;
+                return (s0 - (s1 - (s2 - (s3 - s4 / k2) / k2) / k2) / k2) / k;
+            }
+
+            /**
+             * deviance (function)
+             *
+             * This returns x log(x / mean) + mean - x, computed with a series when x is close to the mean, where the
+             * plain formula would cancel out.
+             */
+            inline double deviance(const double x, const double mean) {
+                if (std::fabs(x - mean) < 0.1 * (x + mean)) {
+                    double v = (x - mean) / (x + mean);
+                    double result = (x - mean) * v, term = 2 * x * v;
+                    v *= v;
+                    for (int j = 1; j < 1000; j++) {
+                        term *= v;
+                        const double next = result + term / (2 * j + 1);
+                        if (next == result)
+                            break;
+                        result = next;
+                    }
+                    return result;
+                }
+                return x * std::log(x / mean) + mean - x;
+            }
+
+            /**
+             * log_binomial_pmf (function)
+             *
+             * This returns the logarithm of the probability of `x` successes out of `n` trials of probability `p`
+             * (with q = 1 - p), using the saddle point expansion of Loader: all the terms are small, so that the
+             * result keeps its precision even when `n` is in the order of 2^64.
+             */
+            inline double log_binomial_pmf(const double x, const double n, const double p, const double q) {
+                if (x == 0)
+                    return p < 0.1 ? -deviance(n, n * q) - n * p : n * std::log(q);
+                if (x == n)
+                    return q < 0.1 ? -deviance(n, n * p) - n * q : n * std::log(p);
+
+                static const double log_2pi = 1.837877066409345483560659472811;
+                return stirling_error(n) - stirling_error(x) - stirling_error(n - x) - deviance(x, n * p) -
+                       deviance(n - x, n * q) - 0.5 * (log_2pi + std::log(x) + std::log1p(-x / n));
+            }
+
+            /**
+             * log_hypergeometric_pmf (function)
+             *
+             * This returns the logarithm of the probability that `x` of `n` draws out of a population of `N` elements
+             * belong to a subset of `K` elements, as a ratio of binomial probabilities with p = n / N (which cancels
+             * out exactly).
+             */
+            inline double log_hypergeometric_pmf(const double x, const double N, const double K, const double n) {
+                const double p = n / N, q = (N - n) / N;
+                return log_binomial_pmf(x, K, p, q) + log_binomial_pmf(n - x, N - K, p, q) -
+                       log_binomial_pmf(n, N, p, q);
+            }
+        }
+
+        /**
+         * hypergeometric (function)
+         *
+         * This returns how many of `draws` elements, sampled without replacement from a population of `population`
+         * elements, belong to a given subset of `successes` elements.
+         *
+         * Few draws are simulated one by one; otherwise the distribution is inverted starting from its mode, which
+         * takes O(standard deviation) steps. The probability of the mode is computed with the saddle point expansion
+         * (see detail::log_binomial_pmf) rather than with differences of log-factorials, which for populations in the
+         * order of 10^13 would leave no significant digits.
+         */
+        template<typename engine_type>
+        uint64_t hypergeometric(engine_type& engine, const uint64_t population, const uint64_t successes,
+                                const uint64_t draws) {
+            if (!draws || !successes)
+                return 0;
+            if (successes == population)
+                return draws;
+
+            if (draws <= 16) {
+                uint64_t hits = 0, remaining_successes = successes, remaining_population = population;
+                for (uint64_t i = 0; i < draws; i++) {
+                    if (random::bounded(engine, remaining_population--) < remaining_successes) {
+                        ++hits;
+                        --remaining_successes;
+                    }
+                }
+                return hits;
+            }
+
+            const double N = double(population), K = double(successes), n = double(draws);
+            const uint64_t failures = population - successes;
+            const uint64_t min_hits = (draws > failures) ? draws - failures : 0;
+            const uint64_t max_hits = std::min(draws, successes);
+
+            uint64_t mode = static_cast<uint64_t>((n + 1) * (K + 1) / (N + 2));
+            mode = std::max(min_hits, std::min(max_hits, mode));
+
+            const double mode_probability = std::exp(detail::log_hypergeometric_pmf(double(mode), N, K, n));
+            // Below this, the rest of both tails weighs less than the rounding errors of the walk
+            const double negligible = mode_probability * 1e-20;
+
+            double u = random::canonical(engine) - mode_probability;
+            if (u < 0)
+                return mode;
+
+            uint64_t low = mode, high = mode;
+            double low_probability = mode_probability, high_probability = mode_probability;
+            while ((low > min_hits && low_probability > negligible) ||
+                   (high < max_hits && high_probability > negligible)) {
+                if (high < max_hits) {
+                    const double x = double(high);
+                    high_probability *= (K - x) * (n - x) / ((x + 1) * (N - K - n + x + 1));
+                    ++high;
+                    if ((u -= high_probability) < 0)
+                        return high;
+                }
+                if (low > min_hits) {
+                    const double x = double(low);
+                    low_probability *= x * (N - K - n + x) / ((K - x + 1) * (n - x + 1));
+                    --low;
+                    if ((u -= low_probability) < 0)
+                        return low;
+                }
+            }
+
+            return mode; // Only reachable because of rounding errors
+        }
+
+        /**
+         * sample_sorted (function)
+         *
+         * This writes to [out, out + count) `count` distinct integers, sampled uniformly from [0, width), in increasing
+         * order.
+         *
+         * Up to half of the range, it draws independent values, sorts them and draws again the ones that turned out to
+         * be duplicates (the result is the set of the first `count` distinct values of an independent sequence, hence
+         * uniform). Above half of the range, it samples the excluded values instead.
+         *
+         * @pre `count` <= `width`
+         */
+        template<typename engine_type>
+        void sample_sorted(engine_type& engine, const uint64_t count, const uint64_t width, uint64_t* const out) {
+            if (count == width) {
+                std::iota(out, out + count, uint64_t(0));
+            } else if (count > width / 2) {
+                std::vector<uint64_t> excluded(width - count);
+                sample_sorted(engine, width - count, width, excluded.data());
+
+                uint64_t* cursor = out;
+                auto excluded_it = excluded.begin();
+                for (uint64_t value = 0; value < width; value++) {
+                    if (excluded_it != excluded.end() && *excluded_it == value)
+                        ++excluded_it;
+                    else
+                        *(cursor++) = value;
+                }
+            } else {
+                uint64_t filled = 0;
+                while (filled < count) {
+                    for (uint64_t i = filled; i < count; i++)
+                        out[i] = random::bounded(engine, width);
+                    std::sort(out, out + count);
+                    filled = std::unique(out, out + count) - out;
+                }
+            }
+        }
+    }
+
+    /**
+     * RangeSampler (type)
+     *
+     * This samples `sample_size` distinct integers out of [0, universe), uniformly, possibly using many threads.
+     *
+     * The range is split into a number of chunks which only depends on the sample size and on the universe. How many
+     * samples fall in each chunk is decided up front with a sequence of hypergeometric splits, and each chunk is then
+     * sampled independently with its own stream of the seed (see random::stream). As a consequence the samples only
+     * depend on the seed, and not on the number of threads used.
+     *
+     * The samples of each chunk are produced sorted, and chunks are laid out in order, so the concatenation of all the
+     * chunks is sorted: it can be fed directly to the bulk-loading facilities of AdjacencyTree.
+     */
+    class RangeSampler {
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        static const uint64_t SAMPLES_PER_CHUNK = 1 << 16;
+        static const uint64_t MAX_CHUNKS = 1 << 16;
+
+        uint64_t sample_size;
+        uint64_t universe;
+
+        std::vector<uint64_t> chunk_counts;    // samples in each chunk
+        std::vector<uint64_t> chunk_offsets;   // prefix sums of chunk_counts
+        std::vector<random::engine_t> chunk_engines;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        /**
+         * split (method)
+         *
+         * This distributes `draws` samples among the chunks in [first_chunk, last_chunk).
+         */
+        void split(random::engine_t& engine, const size_t first_chunk, const size_t last_chunk, const uint64_t draws) {
+            if (last_chunk - first_chunk == 1) {
+                chunk_counts[first_chunk] = draws;
+                return;
+            }
+
+            const size_t middle_chunk = first_chunk + (last_chunk - first_chunk) / 2;
+            const uint64_t population = chunk_first(last_chunk) - chunk_first(first_chunk);
+            const uint64_t left_population = chunk_first(middle_chunk) - chunk_first(first_chunk);
+            const uint64_t left_draws = sampling::hypergeometric(engine, population, left_population, draws);
+
+            split(engine, first_chunk, middle_chunk, left_draws);
+            split(engine, middle_chunk, last_chunk, draws - left_draws);
+        }
+
+    public:
+        /**
+         * RangeSampler (constructor)
+         *
+         * This plans the sampling of `sample_size` distinct integers out of [0, universe) with the given seed. The
+         * actual sampling happens when calling run() or samples().
+         */
+        RangeSampler(const uint64_t sample_size, const uint64_t universe, const uint64_t seed)
+                : sample_size(sample_size), universe(universe) {
+            if (sample_size > universe)
+                throw InvalidArgument(context_info("too many values to sample from the given range"));
+
+            uint64_t chunks_no = (sample_size + SAMPLES_PER_CHUNK - 1) / SAMPLES_PER_CHUNK;
+            chunks_no = std::max(uint64_t(1), std::min(std::min(chunks_no, uint64_t(MAX_CHUNKS)), std::max(universe, uint64_t(1))));
+
+            chunk_counts.resize(chunks_no);
+            random::engine_t engine = random::stream(seed, 0);
+            split(engine, 0, chunks_no, sample_size);
+
+            chunk_offsets.resize(chunks_no + 1, 0);
+            std::partial_sum(chunk_counts.begin(), chunk_counts.end(), chunk_offsets.begin() + 1);
+
+            chunk_engines.reserve(chunks_no);
+            for (size_t i = 0; i < chunks_no; i++) {
+                engine.jump();
+                chunk_engines.push_back(engine);
+            }
+        }
+
+        /**
+         * size (method)
+         *
+         * This returns the number of samples.
+         */
+        uint64_t size() const noexcept {
+            return sample_size;
+        }
+
+        /**
+         * chunks (method)
+         *
+         * This returns the number of chunks the range is split into.
+         */
+        size_t chunks() const noexcept {
+            return chunk_counts.size();
+        }
+
+        /**
+         * chunk_first (method)
+         *
+         * This returns the first integer covered by the chunk `chunk` (or the universe, for chunk == chunks()).
+         */
+        uint64_t chunk_first(const size_t chunk) const noexcept {
+            const uint64_t chunks_no = chunk_counts.size();
+            return chunk * (universe / chunks_no) + std::min(uint64_t(chunk), universe % chunks_no);
+        }
+
+        /**
+         * chunk_size (method)
+         *
+         * This returns the number of samples falling in the chunk `chunk`.
+         */
+        uint64_t chunk_size(const size_t chunk) const noexcept {
+            return chunk_counts[chunk];
+        }
+
+        /**
+         * chunk_offset (method)
+         *
+         * This returns the position, among all the sorted samples, of the first sample of the chunk `chunk`.
+         */
+        uint64_t chunk_offset(const size_t chunk) const noexcept {
+            return chunk_offsets[chunk];
+        }
+
+        /**
+         * sample_chunk (method)
+         *
+         * This writes the chunk_size(chunk) samples of the chunk `chunk` to `out`, sorted. Whatever the order chunks are
+         * sampled in, the result is always the same.
+         */
+        void sample_chunk(const size_t chunk, uint64_t* const out) const {
+            random::engine_t engine = chunk_engines[chunk];
+            const uint64_t first = chunk_first(chunk);
+
+            sampling::sample_sorted(engine, chunk_counts[chunk], chunk_first(chunk + 1) - first, out);
+            for (uint64_t i = 0; i < chunk_counts[chunk]; i++)
+                out[i] += first;
+        }
+
+        /**
+         * run (method)
+         *
+         * This samples all the chunks using `threads` threads (0 means one per hardware thread), and calls
+         * `callback(chunk, first, last)` for each of them, where [first, last) are the sorted samples of the chunk. The
+         * callback may be called concurrently from different threads, in any order.
+         */
+        template<typename callback_t>
+        void run(unsigned threads, callback_t callback) const {
+            if (!threads)
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            threads = static_cast<unsigned>(std::min<size_t>(threads, chunks()));
+
+            std::atomic<size_t> next_chunk(0);
+            auto worker = [&]() {
+                std::vector<uint64_t> buffer;
+                for (size_t chunk = next_chunk++; chunk < chunks(); chunk = next_chunk++) {
+                    buffer.resize(chunk_counts[chunk]);
+                    sample_chunk(chunk, buffer.data());
+                    callback(chunk, buffer.data(), buffer.data() + buffer.size());
+                }
+            };
+
+            std::vector<std::thread> pool;
+            for (unsigned i = 1; i < threads; i++)
+                pool.emplace_back(worker);
+            worker();
+            for (auto& thread : pool)
+                thread.join();
+        }
+
+        /**
+         * samples (method)
+         *
+         * This returns all the samples, sorted, using `threads` threads (0 means one per hardware thread).
+         */
+        std::vector<uint64_t> samples(const unsigned threads = 0) const {
+            std::vector<uint64_t> result(sample_size);
+            run(threads, [&](size_t chunk, const uint64_t* first, const uint64_t* last) {
+                std::copy(first, last, result.begin() + chunk_offsets[chunk]);
+            });
+            return result;
+        }
+    };
+
+    /**
+     * sample_adjacencies (function)
+     *
+     * This samples `count` distinct adjacencies, uniformly among the ones numbered by `ranks` (see AdjacencyRanks.hpp),
+     * using `threads` threads (0 means one per hardware thread). Ranks are sampled and decoded chunk by chunk, directly
+     * into the returned vector, which is sorted (ranks follow the order of the adjacencies) and does not depend on the
+     * number of threads.
+     */
+    template<typename ranks_t>
+    std::vector<adjacency_t> sample_adjacencies(const ranks_t& ranks, const uint64_t count, const uint64_t seed,
+                                                const unsigned threads = 0) {
+        RangeSampler sampler(count, ranks.size(), seed);
+        std::vector<adjacency_t> result(count);
+
+        sampler.run(threads, [&](size_t chunk, const uint64_t* first, const uint64_t* last) {
+            ranks.decode(first, last, result.begin() + sampler.chunk_offset(chunk));
+        });
+
+        return result;
+    }
+
+}
+
+#endif //KONIG_RANGESAMPLER_HPP
@@ -0,0 +1,456 @@
+#ifndef KONIG_SEQUENTIALSAMPLER_HPP
+#define KONIG_SEQUENTIALSAMPLER_HPP
+
+#include <cmath>
+#include <iterator>
+#include "util.hpp"
+#include "Exception.hpp"
+
+namespace konig {
+
+    /**
+     * SequentialSampler (type)
+     *
+     * This lazily samples `sample_size` distinct integers out of [0, universe), uniformly, yielding them in increasing
+     * order in O(1) memory. It implements Vitter's Method D (``An efficient algorithm for sequential random sampling'',
+     * 1987), which computes directly how many integers to skip before the next sample, falling back to the simpler
+     * Method A when the sample is dense with respect to the remaining range.
+     */
+    template<typename engine_type = random::engine_t>
+    class SequentialSampler {
+
+        //////////////////////////
+        // Subtypes             //
+        //////////////////////////
+    public:
+        /**
+         * iterator (type)
+         *
+         * This is an input iterator over the samples. Since samples are generated on the fly, the sampler can be visited
+         * only once.
+         */
+        class iterator : public std::iterator<std::input_iterator_tag, uint64_t> {
+            friend class SequentialSampler;
+
+            SequentialSampler* sampler;
+            uint64_t value;
+
+            iterator(SequentialSampler* sampler) : sampler(sampler), value(0) {
+                ++(*this);
+            }
+
+        public:
+            iterator() : sampler(NULL), value(0) { }
+
+            const uint64_t& operator*() const noexcept {
+                return value;
+            }
+
+            iterator& operator++() {
+                if (sampler && !sampler->next(value))
+                    sampler = NULL;
+                return *this;
+            }
+
+            bool operator==(const iterator& other) const noexcept {
+                return sampler == other.sampler && (!sampler || value == other.value);
+            }
+
+            bool operator!=(const iterator& other) const noexcept {
+                return !(*this == other);
+            }
+        };
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        static constexpr double ALPHA_INVERSE = 13;
+
+        engine_type* engine;
+
+        uint64_t remaining_samples;     // n in Vitter's paper
+        uint64_t remaining_universe;    // N in Vitter's paper
+        uint64_t position = 0;          // first integer not skipped yet
+        bool method_a = false;
+
+        // State of Method D
+        double v_prime = 0;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        /**
+         * uniform (method)
+         *
+         * This returns a uniformly distributed double in (0, 1], so that its logarithm is always finite.
+         */
+        double uniform() {
+            return 1.0 - random::canonical(*engine);
+        }
+
+        /**
+         * skip_method_a (method)
+         *
+         * This returns how many integers to skip before the next sample, with Method A: O(skip) time.
+         *
+         * @pre remaining_samples >= 2
+         */
+        uint64_t skip_method_a() {
+            double top = double(remaining_universe - remaining_samples);
+            double n_real = double(remaining_universe);
+            const double v = uniform();
+
+            uint64_t skip = 0;
+            double quotient = top / n_real;
+            while (quotient > v) {
+                ++skip;
+                top -= 1;
+                n_real -= 1;
+                quotient *= top / n_real;
+            }
+            return skip;
+        }
+
+        /**
+         * skip_method_d (method)
+         *
+         * This returns how many integers to skip before the next sample, with Method D: O(1) expected time.
+         *
+         * @pre remaining_samples >= 2
+         */
+        uint64_t skip_method_d() {
+            const uint64_t n = remaining_samples;
+            const uint64_t N = remaining_universe;
+            const double n_real = double(n), N_real = double(N);
+            const double n_inverse = 1.0 / n_real, n_minus_1_inverse = 1.0 / (n_real - 1.0);
+            const uint64_t qu1 = N - n + 1;
+            const double qu1_real = double(qu1);
+
+            uint64_t skip;
+            while (true) {
+                double x;
+                while (true) {
+                    x = N_real * (1.0 - v_prime);
+                    skip = static_cast<uint64_t>(x);
+                    if (skip < qu1)
+                        break;
+                    v_prime = std::exp(std::log(uniform()) * n_inverse);
+                }
+
+                const double u = uniform();
+                const double y1 = std::exp(std::log(u * N_real / qu1_real) * n_minus_1_inverse);
+                v_prime = y1 * (1.0 - x / N_real) * (qu1_real / (qu1_real - double(skip)));
+                if (v_prime <= 1.0)
+                    break; // Accepted by the squeeze test
+
+                double y2 = 1.0, top = N_real - 1.0, bottom;
+                uint64_t limit;
+                if (n - 1 > skip) {
+                    bottom = N_real - n_real;
+                    limit = N - skip;
+                } else {
+                    bottom = N_real - 1.0 - double(skip);
+                    limit = qu1;
+                }
+                for (uint64_t t = N - 1; t >= limit; t--) {
+                    y2 = (y2 * top) / bottom;
+                    top -= 1.0;
+                    bottom -= 1.0;
+                }
+
+                if (N_real / (N_real - x) >= y1 * std::exp(std::log(y2) * n_minus_1_inverse)) {
+                    v_prime = std::exp(std::log(uniform()) * n_minus_1_inverse);
+                    break; // Accepted by the full test
+                }
+                v_prime = std::exp(std::log(uniform()) * n_inverse);
+            }
+
+            return skip;
+        }
+
+    public:
+        /**
+         * SequentialSampler (constructor)
+         *
+         * This prepares the sampling of `sample_size` distinct integers out of [0, universe), drawing from `engine`
+         * (which must outlive the sampler).
+         */
+        SequentialSampler(const uint64_t sample_size, const uint64_t universe, engine_type& engine)
+                : engine(&engine), remaining_samples(sample_size), remaining_universe(universe) {
+            if (sample_size > universe)
+                throw InvalidArgument(context_info("too many values to sample from the given range"));
+
+            if (remaining_samples > 1)
+                v_prime = std::exp(std::log(uniform()) / double(remaining_samples));
+        }
+
+        /**
+         * next (method)
+         *
+         * This stores the next sample in `value` and returns true, or returns false if all the samples have been
+         * produced already.
+         */
+        bool next(uint64_t& value) {
+            if (!remaining_samples)
+                return false;
+
+            uint64_t skip;
+            if (remaining_samples == 1) {
+                skip = random::bounded(*engine, remaining_universe);
+            } else {
+                if (!method_a && ALPHA_INVERSE * double(remaining_samples) >= double(remaining_universe))
+                    method_a = true;
+                skip = method_a ? skip_method_a() : skip_method_d();
+            }
+
+            value = position + skip;
+            position = value + 1;
+            remaining_universe -= skip + 1;
+            --remaining_samples;
+            return true;
+        }
+
+        /**
+         * remaining (method)
+         *
+         * This returns the number of samples not produced yet.
+         */
+        uint64_t remaining() const noexcept {
+            return remaining_samples;
+        }
+
+        iterator begin() {
+            return iterator(this);
+        }
+
+        iterator end() {
+            return iterator();
+        }
+    };
+
+    /**
+     * ExcludingSampler (type)
+     *
+     * This lazily samples `sample_size` distinct integers out of [0, universe), excluding the values of `exclusions`,
+     * and yields them in increasing order.
+     *
+     * `exclusions` is not copied: it must be a random-access sequence (size() and operator[]) of distinct integers in
+     * increasing order, such as RankedExclusions, which reads them straight from a sorted adjacency structure. Each
+     * sample is drawn from the reduced range [0, universe - exclusions.size()) and shifted past the exclusions that
+     * precede it, found with a galloping search: sampling k values costs O(k log(exclusions.size())) accesses to
+     * `exclusions`, regardless of how many exclusions there are between two samples.
+     */
+    template<typename exclusions_t, typename engine_type = random::engine_t>
+    class ExcludingSampler {
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        const exclusions_t& exclusions;
+        SequentialSampler<engine_type> sampler;
+
+        // Number of exclusions preceding the last sample
+        uint64_t skipped = 0;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        /**
+         * precedes (method)
+         *
+         * This checks whether the `index`-th exclusion comes before the `sample`-th non-excluded value.
+         */
+        bool precedes(const uint64_t index, const uint64_t sample) const {
+            return exclusions[index] - index <= sample;
+        }
+
+    public:
+        ExcludingSampler(const uint64_t sample_size, const uint64_t universe, const exclusions_t& exclusions,
+                         engine_type& engine)
+                : exclusions(exclusions),
+                  sampler(sample_size, universe >= exclusions.size() ? universe - exclusions.size() : 0, engine) { }
+
+        /**
+         * next (method)
+         *
+         * This stores the next sample in `value` and returns true, or returns false if all the samples have been
+         * produced already.
+         */
+        bool next(uint64_t& value) {
+            uint64_t sample;
+            if (!sampler.next(sample))
+                return false;
+
+            // Gallop past the exclusions preceding the sample, then binary search the exact boundary
+            const uint64_t total = exclusions.size();
+            uint64_t low = skipped, step = 1;
+            while (low + step <= total && precedes(low + step - 1, sample)) {
+                low += step;
+                step *= 2;
+            }
+            uint64_t high = std::min(total, low + step);
+            while (low < high) {
+                const uint64_t middle = low + (high - low) / 2;
+                if (precedes(middle, sample))
+                    low = middle + 1;
+                else
+                    high = middle;
+            }
+
+            skipped = low;
+            value = sample + skipped;
+            return true;
+        }
+
+        /**
+         * remaining (method)
+         *
+         * This returns the number of samples not produced yet.
+         */
+        uint64_t remaining() const noexcept {
+            return sampler.remaining();
+        }
+    };
+
+    /**
+     * ComplementSampler (type)
+     *
+     * This is the same as ExcludingSampler, for samples which cover most of the non-excluded values: instead of the
+     * `sample_size` values, it samples the (few) ones to leave out, with an ExcludingSampler, and yields everything else
+     * while streaming through [0, universe). It takes O(1) memory besides `exclusions`, and O(universe) time, which is
+     * less than the O(sample_size log(exclusions.size())) of ExcludingSampler once the sample is dense.
+     *
+     * `exclusions` is not copied, and must be a random-access sequence of distinct integers in increasing order.
+     */
+    template<typename exclusions_t, typename engine_type = random::engine_t>
+    class ComplementSampler {
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        const exclusions_t& exclusions;
+        uint64_t universe;
+        uint64_t remaining_samples;
+
+        // The values left out of the sample, in increasing order
+        ExcludingSampler<exclusions_t, engine_type> holes;
+        uint64_t next_hole;
+
+        uint64_t position = 0;
+        uint64_t next_exclusion = 0;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        static uint64_t holes_no(const uint64_t sample_size, const uint64_t universe, const exclusions_t& exclusions) {
+            const uint64_t available = universe >= exclusions.size() ? universe - exclusions.size() : 0;
+            if (sample_size > available)
+                throw InvalidArgument(context_info("too many values to sample from the given range"));
+            return available - sample_size;
+        }
+
+        void advance_hole() {
+            if (!holes.next(next_hole))
+                next_hole = universe;
+        }
+
+    public:
+        /**
+         * pays_off (method)
+         *
+         * This checks whether sampling `sample_size` values out of [0, universe), minus `exclusions_no` exclusions, is
+         * cheaper with a ComplementSampler than with an ExcludingSampler: the sample must cover most of the
+         * non-excluded values, but also a constant fraction of the universe, since all of it is walked. A few values
+         * missing from a nearly full universe are better found by the ExcludingSampler.
+         */
+        static bool pays_off(const uint64_t sample_size, const uint64_t universe,
+                             const uint64_t exclusions_no) noexcept {
+            const uint64_t available = universe >= exclusions_no ? universe - exclusions_no : 0;
+            return sample_size > available / 2 && sample_size >= universe / 4;
+        }
+
+        ComplementSampler(const uint64_t sample_size, const uint64_t universe, const exclusions_t& exclusions,
+                          engine_type& engine)
+                : exclusions(exclusions), universe(universe), remaining_samples(sample_size),
+                  holes(holes_no(sample_size, universe, exclusions), universe, exclusions, engine) {
+            advance_hole();
+        }
+
+        /**
+         * next (method)
+         *
+         * This stores the next sample in `value` and returns true, or returns false if all the samples have been
+         * produced already.
+         */
+        bool next(uint64_t& value) {
+            if (!remaining_samples)
+                return false;
+
+            const uint64_t total = exclusions.size();
+            while (true) {
+                if (next_exclusion < total && exclusions[next_exclusion] == position) {
+                    ++next_exclusion;
+                } else if (position == next_hole) {
+                    advance_hole();
+                } else {
+                    break;
+                }
+                ++position;
+            }
+
+            value = position++;
+            --remaining_samples;
+            return true;
+        }
+
+        /**
+         * remaining (method)
+         *
+         * This returns the number of samples not produced yet.
+         */
+        uint64_t remaining() const noexcept {
+            return remaining_samples;
+        }
+    };
+
+    /**
+     * RankedExclusions (type)
+     *
+     * This exposes the adjacencies of a sorted structure (such as AdjacencyTree or AdjacencyManager) as the sorted
+     * sequence of their ranks, according to `ranks_t` (see AdjacencyRanks.hpp), without copying them: the i-th element
+     * is computed with a select query. All the adjacencies of the structure must be valid for `ranks`.
+     *
+     * The structure is taken by non-const reference, so that splay trees splay the selected adjacencies: the accesses
+     * of the samplers are clustered, and a non-splaying descent could take O(n) steps on a tree left unbalanced by
+     * previous operations.
+     */
+    template<typename structure_t, typename ranks_t>
+    class RankedExclusions {
+    private:
+        structure_t& structure;
+        const ranks_t& ranks;
+
+    public:
+        RankedExclusions(structure_t& structure, const ranks_t& ranks) : structure(structure), ranks(ranks) { }
+
+        uint64_t size() const {
+            return structure.size();
+        }
+
+        uint64_t operator[](const uint64_t index) const {
+            return ranks.rank(*structure.select(index + 1));
+        }
+    };
+
+}
+
+#endif //KONIG_SEQUENTIALSAMPLER_HPP
@@ -0,0 +1,376 @@
+#ifndef KONIG_SHARDEDADJACENCYMANAGER_HPP
+#define KONIG_SHARDEDADJACENCYMANAGER_HPP
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "util.hpp"
+#include "Exception.hpp"
+#include "AdjacencyManager.hpp"
+#include "CompressedSparseRow.hpp"
+
+namespace konig {
+
+    /**
+     * ShardedAdjacencyManager (type)
+     *
+     * This splits the adjacencies among `shards_no` independent `manager_t`s (AdjacencyManager by default), by ranges
+     * of their first endpoint: shard i holds the adjacencies whose first endpoint is in [i * width, (i + 1) * width),
+     * where width = ceil(vertices_no / shards_no), and the last shard also holds every first endpoint beyond. Since the
+     * ranges are contiguous, iterating over the shards in order visits all the adjacencies in increasing order.
+     *
+     * Each shard is protected by its own mutex, so that threads inserting adjacencies of different shards never
+     * contend: insert, erase, has and degree can be called concurrently. A worker can also own a shard and work on it
+     * directly through shard(i), with no locking at all, as long as no one else touches that shard meanwhile.
+     *
+     * Inside a shard, the first endpoints are stored relative to the first vertex of the shard, so that the vertex
+     * index of every shard only covers its own range.
+     *
+     * The global queries (iteration, rank/select, to_csr) are not synchronized: they are meant to be used once the
+     * generation is over.
+     */
+    template<typename manager_t = AdjacencyManager>
+    class ShardedAdjacencyManager {
+
+        //////////////////////////
+        // Subtypes             //
+        //////////////////////////
+    private:
+        struct Shard {
+            manager_t manager;
+            mutable std::mutex mutex;
+
+            explicit Shard(const size_t vertices_no) : manager(vertices_no) { }
+        };
+
+    public:
+        typedef typename manager_t::iterator shard_iterator;
+
+        /**
+         * iterator (type)
+         *
+         * This is a forward iterator over all the adjacencies, in increasing order, going through the shards one after
+         * the other.
+         */
+        class iterator : public std::iterator<std::forward_iterator_tag, adjacency_t, std::ptrdiff_t,
+                                              const adjacency_t*, const adjacency_t&> {
+            friend class ShardedAdjacencyManager;
+
+            // Members
+        private:
+            const ShardedAdjacencyManager* owner;
+            size_t shard;
+            shard_iterator inner;
+            adjacency_t current;
+
+            iterator(const ShardedAdjacencyManager* owner, const size_t shard, const shard_iterator inner)
+                    : owner(owner), shard(shard), inner(inner) {
+                skip_empty();
+            }
+
+            /**
+             * skip_empty (method)
+             *
+             * This moves the iterator to the first adjacency of the next non-empty shard, if the current one is over.
+             */
+            void skip_empty() {
+                while (shard < owner->shards.size() && inner == owner->shards[shard]->manager.end()) {
+                    if (++shard < owner->shards.size())
+                        inner = owner->shards[shard]->manager.begin();
+                }
+                if (shard < owner->shards.size())
+                    current = {inner->first + owner->shard_begin(shard), inner->second};
+            }
+
+            // Methods
+        public:
+            iterator() : owner(NULL), shard(0) { }
+
+            /**
+             * shard_index (method)
+             *
+             * This returns the shard of the adjacency pointed by the iterator (shards_no() for the past-the-end one).
+             */
+            size_t shard_index() const noexcept {
+                return shard;
+            }
+
+            const adjacency_t& operator*() const noexcept {
+                return current;
+            }
+
+            const adjacency_t* operator->() const noexcept {
+                return &current;
+            }
+
+            iterator& operator++() {
+                ++inner;
+                skip_empty();
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator copy(*this);
+                ++(*this);
+                return copy;
+            }
+
+            bool operator==(const iterator& other) const noexcept {
+                return shard == other.shard && (shard == owner->shards.size() || inner == other.inner);
+            }
+
+            bool operator!=(const iterator& other) const noexcept {
+                return !(*this == other);
+            }
+        };
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        std::vector<std::unique_ptr<Shard>> shards;
+        size_t shard_width;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        adjacency_t to_shard(const adjacency_t adjacency) const noexcept {
+            return {static_cast<vid_t>(adjacency.first - shard_begin(shard_of(adjacency.first))), adjacency.second};
+        }
+
+        /**
+         * prefix_size (method)
+         *
+         * This returns the number of adjacencies stored in the shards before `shard`.
+         */
+        size_t prefix_size(const size_t shard) const {
+            size_t result = 0;
+            for (size_t i = 0; i < shard; i++)
+                result += shards[i]->manager.size();
+            return result;
+        }
+
+    public:
+        /**
+         * ShardedAdjacencyManager (constructor)
+         *
+         * This creates `shards_no` empty shards splitting the vertices in [0, vertices_no) evenly.
+         */
+        ShardedAdjacencyManager(const size_t vertices_no, const size_t shards_no) {
+            if (!shards_no)
+                throw InvalidArgument(context_info("there must be at least one shard"));
+            shard_width = std::max<size_t>(1, (vertices_no + shards_no - 1) / shards_no);
+
+            shards.reserve(shards_no);
+            for (size_t i = 0; i < shards_no; i++) {
+                const size_t first = std::min(vertices_no, i * shard_width);
+                const size_t last = std::min(vertices_no, first + shard_width);
+                shards.emplace_back(new Shard(last - first));
+            }
+        }
+
+        ShardedAdjacencyManager(const ShardedAdjacencyManager&) = delete;
+        ShardedAdjacencyManager& operator=(const ShardedAdjacencyManager&) = delete;
+
+        size_t shards_no() const noexcept {
+            return shards.size();
+        }
+
+        /**
+         * shard_of (method)
+         *
+         * This returns the shard holding the adjacencies whose first endpoint is `vertex`.
+         */
+        size_t shard_of(const vid_t vertex) const noexcept {
+            return std::min<size_t>(vertex / shard_width, shards.size() - 1);
+        }
+
+        /**
+         * shard_begin (method)
+         *
+         * This returns the first vertex of `shard`, which is subtracted from the first endpoints of its adjacencies.
+         */
+        vid_t shard_begin(const size_t shard) const noexcept {
+            return static_cast<vid_t>(shard * shard_width);
+        }
+
+        /**
+         * shard (method)
+         *
+         * This returns the manager of the given shard, for a worker owning it, without locking. Its adjacencies have
+         * their first endpoint relative to shard_begin(`shard`).
+         */
+        manager_t& shard(const size_t shard) noexcept {
+            return shards[shard]->manager;
+        }
+
+        const manager_t& shard(const size_t shard) const noexcept {
+            return shards[shard]->manager;
+        }
+
+        /**
+         * insert (overloaded method)
+         *
+         * This inserts `adjacency`, unless it is already there, and returns whether it has been inserted. It only locks
+         * the shard of `adjacency`.
+         */
+        bool insert(const adjacency_t adjacency) {
+            Shard& shard = *shards[shard_of(adjacency.first)];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            return shard.manager.insert(to_shard(adjacency)).second;
+        }
+
+        /**
+         * insert (overloaded method)
+         *
+         * This inserts all the adjacencies in [first, last), ignoring those already there: the batch is split by shard,
+         * and the shards are filled by `threads` threads (0 means one per core), each shard with a single batch
+         * insertion under its lock.
+         */
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last, unsigned threads = 1) {
+            std::vector<std::vector<adjacency_t>> batches(shards.size());
+            for (; first != last; ++first)
+                batches[shard_of(first->first)].push_back(to_shard(*first));
+
+            if (!threads)
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            threads = static_cast<unsigned>(std::min<size_t>(threads, shards.size()));
+
+            std::vector<std::exception_ptr> errors(threads);
+            auto fill_shards = [&](const unsigned thread) {
+                try {
+                    for (size_t i = thread; i < shards.size(); i += threads) {
+                        if (batches[i].empty())
+                            continue;
+                        std::lock_guard<std::mutex> lock(shards[i]->mutex);
+                        shards[i]->manager.insert(batches[i].begin(), batches[i].end());
+                    }
+                } catch (...) {
+                    errors[thread] = std::current_exception();
+                }
+            };
+
+            std::vector<std::thread> pool;
+            for (unsigned thread = 1; thread < threads; thread++)
+                pool.emplace_back(fill_shards, thread);
+            fill_shards(0);
+            for (auto& thread : pool)
+                thread.join();
+
+            for (const auto& error : errors)
+                if (error)
+                    std::rethrow_exception(error);
+        }
+
+        /**
+         * erase (method)
+         *
+         * This deletes `adjacency`. If it does not exist, nothing happens.
+         */
+        void erase(const adjacency_t adjacency) {
+            Shard& shard = *shards[shard_of(adjacency.first)];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.manager.erase(to_shard(adjacency));
+        }
+
+        bool has(const adjacency_t adjacency) const {
+            const Shard& shard = *shards[shard_of(adjacency.first)];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            return shard.manager.has(to_shard(adjacency));
+        }
+
+        size_t degree(const vid_t vertex) const {
+            const Shard& shard = *shards[shard_of(vertex)];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            return shard.manager.degree(static_cast<vid_t>(vertex - shard_begin(shard_of(vertex))));
+        }
+
+        /**
+         * size (method)
+         *
+         * This returns the total number of adjacencies, locking one shard at a time.
+         */
+        size_t size() const {
+            size_t result = 0;
+            for (const auto& shard : shards) {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                result += shard->manager.size();
+            }
+            return result;
+        }
+
+        /**
+         * freeze (method)
+         *
+         * This freezes all the shards (see AdjacencyManager::freeze).
+         */
+        void freeze() {
+            for (auto& shard : shards) {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                shard->manager.freeze();
+            }
+        }
+
+        void thaw() {
+            for (auto& shard : shards) {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                shard->manager.thaw();
+            }
+        }
+
+        iterator begin() const {
+            return iterator(this, 0, shards.front()->manager.begin());
+        }
+
+        iterator end() const {
+            return iterator(this, shards.size(), shard_iterator());
+        }
+
+        /**
+         * rank (method)
+         *
+         * This returns the global rank (starting from 1) of the adjacency pointed by `it`: its rank inside its shard,
+         * plus the sizes of the previous shards. Like the trees, it returns size() + 1 for end().
+         */
+        size_t rank(const iterator it) {
+            if (it.shard == shards.size())
+                return prefix_size(shards.size()) + 1;
+            return prefix_size(it.shard) + shards[it.shard]->manager.rank(it.inner);
+        }
+
+        /**
+         * select (method)
+         *
+         * This returns an iterator to the adjacency whose global rank (starting from 1) is `rank`, or end() if there is
+         * none.
+         */
+        iterator select(size_t rank) const {
+            for (size_t i = 0; i < shards.size(); i++) {
+                const size_t shard_size = shards[i]->manager.size();
+                if (rank >= 1 && rank <= shard_size)
+                    return iterator(this, i, shards[i]->manager.select(rank));
+                rank -= std::min(rank, shard_size);
+            }
+            return end();
+        }
+
+        /**
+         * to_csr (method)
+         *
+         * This returns a CompressedSparseRow snapshot of all the adjacencies, with at least `vertices_no` vertices.
+         */
+        CompressedSparseRow to_csr(const size_t vertices_no = 0) const {
+            return CompressedSparseRow(begin(), end(), vertices_no);
+        }
+    };
+
+}
+
+#endif //KONIG_SHARDEDADJACENCYMANAGER_HPP
@@ -0,0 +1,147 @@
+#ifndef KONIG_STATISTICS_HPP
+#define KONIG_STATISTICS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+
+/*
+ * Instrumentation of the hot paths of AdjacencyTree. It is enabled by defining KONIG_STATISTICS (like KONIG_DEBUG
+ * enables the internal assertions): otherwise KONIG_COUNT expands to nothing, the trees carry no statistics at all, and
+ * there is no cost.
+ */
+#ifdef KONIG_STATISTICS
+#define KONIG_COUNT(statement) statement
+#else
+#define KONIG_COUNT(statement)
+#endif
+
+namespace konig {
+
+    /**
+     * TreeStatistics (type)
+     *
+     * This collects, for each kind of public operation of an AdjacencyTree, how many times it has been called and how
+     * many splays, rotations and vertex allocations it caused in total, as well as the maximum depth of a vertex
+     * reached by a splay (i.e. the number of rotations needed to bring it to the root). The counters are not
+     * synchronized: they are only updated by the methods which modify the tree (queries on a frozen tree don't splay
+     * and are not counted), hence they can be read as long as the tree is not being modified.
+     */
+    struct TreeStatistics {
+
+        //////////////////////////
+        // Subtypes             //
+        //////////////////////////
+
+        enum operation_t {
+            INSERT,         // insert(adjacency)
+            BATCH_INSERT,   // insert(first, last), assign(first, last), freeze()
+            ERASE,          // erase(iterator)
+            FIND,           // find, has, lower_bound, upper_bound
+            RANK,           // rank, splaying select
+            ITERATE,        // iterator arithmetic other than ++ and --
+            OTHER,          // anything called outside of a public operation
+            OPERATIONS_NO
+        };
+
+        /**
+         * Scope (type)
+         *
+         * While a Scope is alive, the counters are attributed to its operation. Nested scopes (e.g. has() calling
+         * find()) are attributed to the outermost one. A scope which is not `enabled` (a query on a frozen tree, which
+         * may run concurrently with others) does not touch the statistics at all.
+         */
+        class Scope {
+        private:
+            TreeStatistics* statistics;
+
+        public:
+            Scope(TreeStatistics& statistics, const operation_t operation, const bool enabled = true) noexcept
+                    : statistics(enabled && statistics.current == OTHER ? &statistics : NULL) {
+                if (this->statistics) {
+                    statistics.current = operation;
+                    ++statistics.calls[operation];
+                }
+            }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            ~Scope() {
+                if (statistics)
+                    statistics->current = OTHER;
+            }
+        };
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+
+        uint64_t calls[OPERATIONS_NO] = {};
+        uint64_t splays[OPERATIONS_NO] = {};
+        uint64_t rotations[OPERATIONS_NO] = {};
+        uint64_t allocations[OPERATIONS_NO] = {};
+        uint64_t max_depth[OPERATIONS_NO] = {};
+        operation_t current = OTHER;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+
+        /**
+         * on_splay (method)
+         *
+         * This records a splay which took `depth` rotations.
+         */
+        void on_splay(const uint64_t depth) noexcept {
+            ++splays[current];
+            rotations[current] += depth;
+            max_depth[current] = std::max(max_depth[current], depth);
+        }
+
+        void on_allocation(const uint64_t count = 1) noexcept {
+            allocations[current] += count;
+        }
+
+        /**
+         * reset (method)
+         *
+         * This sets all the counters back to zero.
+         */
+        void reset() noexcept {
+            *this = TreeStatistics();
+        }
+
+        static const char* name(const operation_t operation) noexcept {
+            static const char* const names[OPERATIONS_NO] = {
+                    "insert", "batch_insert", "erase", "find", "rank", "iterate", "other"
+            };
+            return names[operation];
+        }
+
+        /**
+         * dump (method)
+         *
+         * This writes a table of the counters to `os`, one line for each operation which has been used.
+         */
+        void dump(std::ostream& os) const {
+            os << "operation calls splays rotations rotations/splay max_depth allocations\n";
+            for (int i = 0; i < OPERATIONS_NO; i++) {
+                if (!calls[i] && !splays[i] && !allocations[i])
+                    continue;
+                os << name(operation_t(i)) << ' ' << calls[i] << ' ' << splays[i] << ' ' << rotations[i] << ' '
+                   << (splays[i] ? double(rotations[i]) / splays[i] : 0.0) << ' ' << max_depth[i] << ' '
+                   << allocations[i] << '\n';
+            }
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const TreeStatistics& statistics) {
+            statistics.dump(os);
+            return os;
+        }
+    };
+
+}
+
+#endif //KONIG_STATISTICS_HPP
@@ -1,13 +1,263 @@
-#ifndef KONIG_EDGEMANAGER_HPP
-#define KONIG_EDGEMANAGER_HPP
+#ifndef KONIG_STRUCTUREMANAGER_HPP
+#define KONIG_STRUCTUREMANAGER_HPP
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "util.hpp"
+#include "Exception.hpp"
+#include "AdjacencyManager.hpp"
+#include "CompressedSparseRow.hpp"
 
 namespace konig {
 
-    template<typename weight_t>
+    /**
+     * StructureManager (type)
+     *
+     * This is an AdjacencyManager whose adjacencies carry a weight. Weights are not stored in the nodes of the tree:
+     * they are kept in a separate array, sorted like the adjacencies (the weight of the adjacency of rank r is at index
+     * r - 1), so that the topology stays compact and the weights can be scanned, or exported along with a
+     * CompressedSparseRow snapshot, as a contiguous array.
+     *
+     * Inserting or erasing a single adjacency shifts the weights which follow it, which costs O(size()) (a memmove,
+     * for trivially copyable weights). Batches are merged into the array with a single linear pass.
+     */
+    template<typename weight_t, typename manager_t = AdjacencyManager>
     class StructureManager {
 
+        //////////////////////////
+        // Subtypes             //
+        //////////////////////////
+    public:
+        typedef typename manager_t::iterator iterator;
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        manager_t adjacencies;
+        std::vector<weight_t> weights;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        /**
+         * merge_batch (method)
+         *
+         * This inserts the sorted and unique `batch` of (adjacency, weight) pairs, merging it with the existing
+         * adjacencies in a single pass. Adjacencies already in the structure keep their weight.
+         */
+        void merge_batch(const std::vector<std::pair<adjacency_t, weight_t>>& batch) {
+            std::vector<weight_t> merged;
+            merged.reserve(weights.size() + batch.size());
+
+            auto existing = adjacencies.begin();
+            size_t existing_index = 0;
+            for (const auto& element : batch) {
+                while (existing_index < weights.size() && *existing < element.first) {
+                    merged.push_back(weights[existing_index++]);
+                    ++existing;
+                }
+                if (existing_index < weights.size() && *existing == element.first)
+                    continue;
+                merged.push_back(element.second);
+            }
+            merged.insert(merged.end(), weights.begin() + existing_index, weights.end());
+
+            std::vector<adjacency_t> batch_adjacencies;
+            batch_adjacencies.reserve(batch.size());
+            for (const auto& element : batch)
+                batch_adjacencies.push_back(element.first);
+
+            adjacencies.insert(batch_adjacencies.begin(), batch_adjacencies.end());
+            weights.swap(merged);
+        }
+
+        static void sort_batch(std::vector<std::pair<adjacency_t, weight_t>>& batch) {
+            auto by_adjacency = [](const std::pair<adjacency_t, weight_t>& a, const std::pair<adjacency_t, weight_t>& b) {
+                return a.first < b.first;
+            };
+            auto same_adjacency = [](const std::pair<adjacency_t, weight_t>& a,
+                                     const std::pair<adjacency_t, weight_t>& b) {
+                return a.first == b.first;
+            };
+
+            if (!std::is_sorted(batch.begin(), batch.end(), by_adjacency))
+                std::stable_sort(batch.begin(), batch.end(), by_adjacency);
+            batch.erase(std::unique(batch.begin(), batch.end(), same_adjacency), batch.end());
+        }
+
+    public:
+        StructureManager() = default;
+
+        /**
+         * StructureManager (constructor)
+         *
+         * This preallocates the vertex index for the vertices in [0, vertices_no).
+         */
+        explicit StructureManager(const size_t vertices_no) : adjacencies(vertices_no) { }
+
+        iterator begin() const {
+            return adjacencies.begin();
+        }
+
+        iterator begin(const vid_t vertex) const noexcept {
+            return adjacencies.begin(vertex);
+        }
+
+        iterator end() const noexcept {
+            return adjacencies.end();
+        }
+
+        iterator end(const vid_t vertex) const noexcept {
+            return adjacencies.end(vertex);
+        }
+
+        size_t degree(const vid_t vertex) const noexcept {
+            return adjacencies.degree(vertex);
+        }
+
+        size_t size() const {
+            return adjacencies.size();
+        }
+
+        /**
+         * topology (method)
+         *
+         * This returns the underlying AdjacencyManager.
+         */
+        const manager_t& topology() const noexcept {
+            return adjacencies;
+        }
+
+        /**
+         * insert (overloaded method)
+         *
+         * This inserts `adjacency` with the given weight. If the adjacency is already there, nothing happens (its weight
+         * is not changed). It returns an iterator to the adjacency and whether it has been inserted.
+         */
+        std::pair<iterator, bool> insert(const adjacency_t adjacency, const weight_t& weight) {
+            const auto result = adjacencies.insert(adjacency);
+            if (result.second)
+                weights.insert(weights.begin() + (adjacencies.rank(result.first) - 1), weight);
+            return result;
+        }
+
+        /**
+         * insert (overloaded method)
+         *
+         * This inserts the adjacencies in [first, last), the i-th of them with the i-th weight starting from
+         * `weights_first`. Adjacencies already there (or repeated in the batch, after their first occurrence) are
+         * ignored.
+         */
+        template<typename InputIt, typename WeightIt>
+        void insert(InputIt first, InputIt last, WeightIt weights_first) {
+            std::vector<std::pair<adjacency_t, weight_t>> batch;
+            for (; first != last; ++first, ++weights_first)
+                batch.emplace_back(*first, *weights_first);
+
+            sort_batch(batch);
+            merge_batch(batch);
+        }
+
+        /**
+         * insert (overloaded method)
+         *
+         * This inserts the adjacencies in [first, last) with random weights in [bottom, top] (see random::randrange),
+         * drawn from `engine` all at once with random::fill.
+         */
+        template<typename InputIt, typename engine_type>
+        void insert(InputIt first, InputIt last, engine_type& engine, const weight_t bottom, const weight_t top) {
+            std::vector<std::pair<adjacency_t, weight_t>> batch;
+            for (; first != last; ++first)
+                batch.emplace_back(*first, weight_t());
+            sort_batch(batch);
+
+            std::vector<weight_t> random_weights(batch.size());
+            random::fill(engine, random_weights.begin(), random_weights.end(), bottom, top);
+            for (size_t i = 0; i < batch.size(); i++)
+                batch[i].second = random_weights[i];
+
+            merge_batch(batch);
+        }
+
+        /**
+         * erase (method)
+         *
+         * This deletes `adjacency` and its weight. If the adjacency does not exist, nothing happens.
+         */
+        void erase(const adjacency_t adjacency) {
+            const auto it = adjacencies.find(adjacency);
+            if (it == adjacencies.end())
+                return;
+
+            weights.erase(weights.begin() + (adjacencies.rank(it) - 1));
+            adjacencies.erase(it);
+        }
+
+        iterator find(const adjacency_t adjacency) const noexcept {
+            return adjacencies.find(adjacency);
+        }
+
+        bool has(const adjacency_t adjacency) const noexcept {
+            return adjacencies.has(adjacency);
+        }
+
+        /**
+         * weight (overloaded method)
+         *
+         * This returns the weight of the adjacency pointed by `it`.
+         */
+        const weight_t& weight(const iterator it) {
+            return weights[adjacencies.rank(it) - 1];
+        }
+
+        /**
+         * weight (overloaded method)
+         *
+         * This returns the weight of `adjacency`, throwing InvalidArgument if it does not exist.
+         */
+        const weight_t& weight(const adjacency_t adjacency) {
+            const auto it = adjacencies.find(adjacency);
+            if (it == adjacencies.end())
+                throw InvalidArgument(context_info("the adjacency does not exist"));
+            return weight(it);
+        }
+
+        /**
+         * set_weight (method)
+         *
+         * This changes the weight of `adjacency`, throwing InvalidArgument if it does not exist.
+         */
+        void set_weight(const adjacency_t adjacency, const weight_t& weight) {
+            const auto it = adjacencies.find(adjacency);
+            if (it == adjacencies.end())
+                throw InvalidArgument(context_info("the adjacency does not exist"));
+            weights[adjacencies.rank(it) - 1] = weight;
+        }
+
+        /**
+         * weights_data (method)
+         *
+         * This returns the weights array, sorted like the adjacencies.
+         */
+        const std::vector<weight_t>& weights_data() const noexcept {
+            return weights;
+        }
+
+        /**
+         * to_csr (method)
+         *
+         * This returns a WeightedCompressedSparseRow snapshot with at least `vertices_no` vertices: since CSR positions
+         * follow the order of the adjacencies, the weights array is copied as it is.
+         */
+        WeightedCompressedSparseRow<weight_t> to_csr(const size_t vertices_no = 0) const {
+            return WeightedCompressedSparseRow<weight_t>(adjacencies.to_csr(vertices_no), weights);
+        }
     };
 
-};
+}
 
-#endif //KONIG_EDGEMANAGER_HPP
+#endif //KONIG_STRUCTUREMANAGER_HPP
@@ -1,13 +1,316 @@
 #ifndef KONIG_UNDIRECTEDGRAPH_HPP
 #define KONIG_UNDIRECTEDGRAPH_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <vector>
 #include "Graph.hpp"
+#include "AdjacencyRanks.hpp"
 
 namespace konig {
 
-    template<typename vertex_t, typename weight_t>
-    class UndirectedGraph : public Graph {
+    /**
+     * UndirectedGraph (type)
+     *
+     * This is an undirected graph without self loops nor multiple edges (see Graph for the policies). Each edge {u, v}
+     * is stored once, as the canonical adjacency (max(u, v), min(u, v)), which is also what is written to the output.
+     *
+     * The neighbourhood of a vertex u spans both the adjacencies (u, v) and (w, u): it is computed lazily, by
+     * neighbourhoods(), together with the ones of all the other vertices, with a linear pass over the storage.
+     */
+    template<typename labeler_t = IdentityLabeler, typename weighter_t = NoWeighter,
+            typename storage_t = AdjacencyManager>
+    class UndirectedGraph : public Graph<UndirectedGraph<labeler_t, weighter_t, storage_t>, labeler_t, weighter_t,
+            storage_t> {
+        typedef Graph<UndirectedGraph, labeler_t, weighter_t, storage_t> base_t;
+        friend base_t;
 
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        using base_t::vertices_no;
+        using base_t::storage;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    private:
+        static adjacency_t canonical(const vid_t tail, const vid_t head) noexcept {
+            return {std::max(tail, head), std::min(tail, head)};
+        }
+
+        UndirectedRanks edge_ranks() const noexcept {
+            return UndirectedRanks(vertices_no);
+        }
+
+        /**
+         * build_neighbourhoods (method)
+         *
+         * This builds the symmetric closure of the stored adjacencies. Visiting the canonical adjacencies (u, v) in
+         * order, the smaller neighbours of u are appended all together when u is visited, and the bigger ones later,
+         * in increasing order: every neighbourhood comes out sorted without any sorting.
+         */
+        CompressedSparseRow build_neighbourhoods() const {
+            std::vector<size_t> offsets(vertices_no + 1, 0);
+            for (auto it = storage.begin(); it != storage.end(); ++it) {
+                ++offsets[it->first + 1];
+                ++offsets[it->second + 1];
+            }
+            for (size_t v = 1; v <= vertices_no; v++)
+                offsets[v] += offsets[v - 1];
+
+            std::vector<vid_t> targets(offsets.back());
+            std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+            for (auto it = storage.begin(); it != storage.end(); ++it) {
+                targets[cursors[it->first]++] = it->second;
+                targets[cursors[it->second]++] = it->first;
+            }
+
+            return CompressedSparseRow(std::move(offsets), std::move(targets));
+        }
+
+        /**
+         * chung_lu_blocks (method)
+         *
+         * This splits the rows [0, vertices_no) of build_chung_lu into blocks of roughly the same expected number of
+         * edges (the row of u, with weights sorted in decreasing order, expects about w_u * (w_{u+1} + ...) / S of
+         * them), returning the first row of each block followed by vertices_no. The blocks only depend on the weights.
+         */
+        std::vector<vid_t> chung_lu_blocks(const std::vector<double>& sorted_weights, const double total) const {
+            const double edges_per_block = 1 << 16;
+            const size_t max_blocks = 1024;
+
+            std::vector<double> costs(vertices_no);
+            double suffix = 0, expected = 0;
+            for (size_t u = vertices_no; u-- > 0;) {
+                costs[u] = 1 + sorted_weights[u] * suffix / total;
+                suffix += sorted_weights[u];
+                expected += costs[u];
+            }
+
+            const size_t blocks_no = std::max<size_t>(1, std::min(max_blocks, size_t(expected / edges_per_block)));
+            std::vector<vid_t> blocks(1, 0);
+            double cost = 0;
+            for (size_t u = 0; u < vertices_no; u++) {
+                cost += costs[u];
+                if (blocks.size() < blocks_no && cost >= expected * double(blocks.size()) / double(blocks_no))
+                    blocks.push_back(static_cast<vid_t>(u + 1));
+            }
+            blocks.push_back(static_cast<vid_t>(vertices_no));
+            return blocks;
+        }
+
+    public:
+        using base_t::base_t;
+
+        /**
+         * build_chung_lu (method)
+         *
+         * This adds random edges following the Chung-Lu model: each edge {u, v} is drawn independently with
+         * probability min(w_u * w_v / S, 1), where w are the given `weights` (one per vertex) and S is their sum, so
+         * that the expected degree of u is about w_u.
+         *
+         * It runs in O(vertices_no + edges) expected time, with the geometric skips of Miller and Hagberg (``Efficient
+         * generation of networks with given expected degrees'', 2011): with the vertices sorted by decreasing weight,
+         * the probabilities along a row can only decrease, so the gap to the next candidate is drawn from the geometric
+         * distribution of the current probability, and the candidate is accepted with the ratio of the actual one. The
+         * rows are split into blocks of similar expected size, sampled by `threads` threads (0 means one per hardware
+         * thread) with independent streams: the result only depends on `engine`, not on the number of threads.
+         */
+        template<typename engine_type>
+        void build_chung_lu(const std::vector<double>& weights, engine_type& engine, unsigned threads = 1) {
+            if (weights.size() != vertices_no)
+                throw InvalidArgument(context_info("there must be a weight for each vertex"));
+            for (const double weight : weights)
+                if (!(weight >= 0) || std::isinf(weight))
+                    throw InvalidArgument(context_info("the weights must be finite and non-negative"));
+
+            std::vector<vid_t> order(vertices_no);
+            std::iota(order.begin(), order.end(), vid_t(0));
+            std::sort(order.begin(), order.end(), [&](const vid_t a, const vid_t b) {
+                return weights[a] > weights[b];
+            });
+            std::vector<double> sorted_weights(vertices_no);
+            for (size_t i = 0; i < vertices_no; i++)
+                sorted_weights[i] = weights[order[i]];
+            const double total = std::accumulate(sorted_weights.begin(), sorted_weights.end(), 0.0);
+            if (!(total > 0))
+                return;
+
+            const std::vector<vid_t> blocks = chung_lu_blocks(sorted_weights, total);
+            const size_t blocks_no = blocks.size() - 1;
+            std::vector<random::engine_t> engines;
+            random::engine_t block_engine(engine());
+            for (size_t i = 0; i < blocks_no; i++) {
+                engines.push_back(block_engine);
+                block_engine.jump();
+            }
+
+            std::vector<std::vector<adjacency_t>> edges(blocks_no);
+            auto sample_block = [&](const size_t block) {
+                random::engine_t& stream = engines[block];
+                std::vector<adjacency_t>& block_edges = edges[block];
+                for (size_t u = blocks[block]; u < blocks[block + 1]; u++) {
+                    const double row_weight = sorted_weights[u] / total;
+                    size_t v = u + 1;
+                    double p = v < vertices_no ? std::min(row_weight * sorted_weights[v], 1.0) : 0;
+                    while (v < vertices_no && p > 0) {
+                        if (p < 1) {
+                            const double skip = std::floor(std::log(1.0 - random::canonical(stream)) /
+                                                           std::log1p(-p));
+                            if (skip >= double(vertices_no - v))
+                                break;
+                            v += static_cast<size_t>(skip);
+                        }
+                        const double q = std::min(row_weight * sorted_weights[v], 1.0);
+                        if (random::canonical(stream) * p < q)
+                            block_edges.push_back(canonical(order[u], order[v]));
+                        p = q;
+                        ++v;
+                    }
+                }
+            };
+
+            if (!threads)
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            threads = static_cast<unsigned>(std::min<size_t>(threads, blocks_no));
+            std::atomic<size_t> next_block(0);
+            auto worker = [&]() {
+                for (size_t block = next_block++; block < blocks_no; block = next_block++)
+                    sample_block(block);
+            };
+            std::vector<std::thread> pool;
+            for (unsigned thread = 1; thread < threads; thread++)
+                pool.emplace_back(worker);
+            worker();
+            for (auto& thread : pool)
+                thread.join();
+
+            std::vector<adjacency_t> all_edges;
+            size_t edges_no = 0;
+            for (const auto& block_edges : edges)
+                edges_no += block_edges.size();
+            all_edges.reserve(edges_no);
+            for (auto& block_edges : edges) {
+                all_edges.insert(all_edges.end(), block_edges.begin(), block_edges.end());
+                std::vector<adjacency_t>().swap(block_edges);
+            }
+            this->add_edges(all_edges.begin(), all_edges.end());
+        }
+
+        void build_chung_lu(const std::vector<double>& weights) {
+            build_chung_lu(weights, random::engine());
+        }
+
+        /**
+         * build_power_law (method)
+         *
+         * This adds the edges of a Chung-Lu graph (see build_chung_lu) whose expected degrees follow a power law with
+         * the given `exponent` (the fraction of vertices of degree d is proportional to d^-exponent) and average
+         * `average_degree`: the i-th vertex gets a weight proportional to (i + 1)^(-1 / (exponent - 1)).
+         */
+        template<typename engine_type>
+        void build_power_law(const double exponent, const double average_degree, engine_type& engine,
+                             const unsigned threads = 1) {
+            if (!(exponent > 1))
+                throw InvalidArgument(context_info("the exponent of a power law must be bigger than 1"));
+            if (!(average_degree >= 0) || average_degree >= double(vertices_no))
+                throw InvalidArgument(context_info("the average degree must be in [0, vertices_no)"));
+
+            std::vector<double> weights(vertices_no);
+            double total = 0;
+            for (size_t i = 0; i < vertices_no; i++)
+                total += weights[i] = std::pow(double(i + 1), -1.0 / (exponent - 1));
+            for (double& weight : weights)
+                weight *= average_degree * double(vertices_no) / total;
+
+            build_chung_lu(weights, engine, threads);
+        }
+
+        void build_power_law(const double exponent, const double average_degree) {
+            build_power_law(exponent, average_degree, random::engine());
+        }
+
+        /**
+         * build_configuration (method)
+         *
+         * This adds the edges of the erased configuration model for the given `degrees` (one per vertex, summing to
+         * an even number): each vertex gets as many stubs as its degree, the stubs are randomly paired, and the self
+         * loops and the multiple edges are dropped. The degree of each vertex is at most the requested one, and almost
+         * always equal to it for sparse sequences. It takes O(vertices_no + sum of the degrees) time.
+         */
+        template<typename engine_type>
+        void build_configuration(const std::vector<size_t>& degrees, engine_type& engine) {
+            if (degrees.size() != vertices_no)
+                throw InvalidArgument(context_info("there must be a degree for each vertex"));
+            const size_t stubs_no = std::accumulate(degrees.begin(), degrees.end(), size_t(0));
+            if (stubs_no % 2)
+                throw InvalidArgument(context_info("the degrees must sum to an even number"));
+
+            std::vector<vid_t> stubs;
+            stubs.reserve(stubs_no);
+            for (vid_t vertex = 0; vertex < vertices_no; vertex++)
+                stubs.insert(stubs.end(), degrees[vertex], vertex);
+            std::shuffle(stubs.begin(), stubs.end(), engine);
+
+            std::vector<adjacency_t> edges;
+            edges.reserve(stubs_no / 2);
+            for (size_t i = 0; i < stubs_no; i += 2)
+                if (stubs[i] != stubs[i + 1])
+                    edges.push_back(canonical(stubs[i], stubs[i + 1]));
+            this->add_edges(edges.begin(), edges.end());
+        }
+
+        void build_configuration(const std::vector<size_t>& degrees) {
+            build_configuration(degrees, random::engine());
+        }
+
+        /**
+         * connect (method)
+         *
+         * This makes the graph connected, with as few new edges as possible: it picks a uniformly random representative
+         * for each connected component, and adds the edges of a random tree spanning the representatives. The
+         * components are found with a DisjointSet in a single pass over the edges, split among `threads` threads (0
+         * means one per hardware thread), and the representatives with a single pass over the vertices.
+         */
+        template<typename engine_type>
+        void connect(engine_type& engine, const unsigned threads = 1) {
+            DisjointSet components(vertices_no);
+            this->merge_endpoints(components, threads);
+            if (components.sets() <= 1)
+                return;
+
+            // Reservoir sampling: the i-th vertex met in a component replaces its representative with probability 1/i
+            std::vector<vid_t> seen(vertices_no, 0);
+            std::vector<vid_t> representative(vertices_no);
+            for (vid_t vertex = 0; vertex < vertices_no; vertex++) {
+                const vid_t root = components.find(vertex);
+                if (random::bounded(engine, ++seen[root]) == 0)
+                    representative[root] = vertex;
+            }
+
+            std::vector<vid_t> representatives;
+            representatives.reserve(components.sets());
+            for (vid_t vertex = 0; vertex < vertices_no; vertex++)
+                if (seen[vertex])
+                    representatives.push_back(representative[vertex]);
+            std::shuffle(representatives.begin(), representatives.end(), engine);
+
+            std::vector<adjacency_t> edges;
+            edges.reserve(representatives.size() - 1);
+            for (size_t i = 1; i < representatives.size(); i++)
+                edges.push_back({representatives[i], representatives[random::bounded(engine, i)]});
+            this->add_edges(edges.begin(), edges.end());
+        }
+
+        void connect() {
+            connect(random::engine());
+        }
     };
 
 }
@@ -0,0 +1,217 @@
+#ifndef KONIG_VERTEXINDEX_HPP
+#define KONIG_VERTEXINDEX_HPP
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include "util.hpp"
+
+namespace konig {
+
+    /**
+     * VertexRange (type)
+     *
+     * This stores, for a given vertex, the iterators to the first and the last adjacency having it as first endpoint,
+     * together with the number of such adjacencies (i.e. the out-degree of the vertex).
+     */
+    template<typename iterator_t>
+    struct VertexRange {
+        iterator_t first;
+        iterator_t last;
+        size_t degree = 0;
+    };
+
+    /**
+     * HashedVertexIndex (type)
+     *
+     * This is a vertex index backed by a hash table, which only uses memory for the vertices having at least one
+     * adjacency. It is meant for structures whose vertices are sparse in the vid_t range.
+     */
+    template<typename iterator_t>
+    class HashedVertexIndex {
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        std::unordered_map<vid_t, VertexRange<iterator_t>> ranges;
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    public:
+        /**
+         * reserve (method)
+         *
+         * This preallocates room for `vertices_no` vertices.
+         */
+        void reserve(const size_t vertices_no) {
+            ranges.reserve(vertices_no);
+        }
+
+        /**
+         * find (overloaded method)
+         *
+         * This returns a pointer to the range of `vertex`, or NULL if `vertex` has no adjacencies.
+         */
+        VertexRange<iterator_t>* find(const vid_t vertex) noexcept {
+            auto it = ranges.find(vertex);
+            return (it != ranges.end() && it->second.degree) ? &it->second : NULL;
+        }
+
+        /**
+         * find (overloaded method)
+         *
+         * This returns a pointer to the range of `vertex`, or NULL if `vertex` has no adjacencies.
+         */
+        const VertexRange<iterator_t>* find(const vid_t vertex) const noexcept {
+            auto it = ranges.find(vertex);
+            return (it != ranges.end() && it->second.degree) ? &it->second : NULL;
+        }
+
+        /**
+         * get (method)
+         *
+         * This returns the range of `vertex`, creating an empty one (with degree 0) if needed.
+         */
+        VertexRange<iterator_t>& get(const vid_t vertex) {
+            return ranges[vertex];
+        }
+
+        /**
+         * erase (method)
+         *
+         * This forgets the range of `vertex`.
+         */
+        void erase(const vid_t vertex) noexcept {
+            ranges.erase(vertex);
+        }
+
+        /**
+         * clear (method)
+         *
+         * This forgets all the ranges.
+         */
+        void clear() noexcept {
+            ranges.clear();
+        }
+
+        /**
+         * dense_vertices (method)
+         *
+         * This returns the number of vertices indexed densely, i.e. 0.
+         */
+        size_t dense_vertices() const noexcept {
+            return 0;
+        }
+    };
+
+    /**
+     * DenseVertexIndex (type)
+     *
+     * This is a vertex index backed by a vector indexed by vid_t, preallocated by reserve(): lookups of the vertices in
+     * [0, vertices_no) are a single array access, which is the right choice for the graphs generated by Konig, whose
+     * vertices are exactly those. The vector never grows past what was reserved, so that a single adjacency on a huge
+     * vertex does not allocate a slot for every vid_t below it: the vertices outside the reserved range are kept in a
+     * HashedVertexIndex instead.
+     */
+    template<typename iterator_t>
+    class DenseVertexIndex {
+
+        //////////////////////////
+        // Members              //
+        //////////////////////////
+    private:
+        std::vector<VertexRange<iterator_t>> ranges;
+        HashedVertexIndex<iterator_t> outside;  // the vertices in [ranges.size(), +inf)
+
+
+        //////////////////////////
+        // Methods              //
+        //////////////////////////
+    public:
+        /**
+         * reserve (method)
+         *
+         * This preallocates room for the vertices in [0, vertices_no), which are indexed densely from now on.
+         */
+        void reserve(const size_t vertices_no) {
+            if (ranges.size() >= vertices_no)
+                return;
+            const size_t old_size = ranges.size();
+            ranges.resize(vertices_no);
+            for (size_t vertex = old_size; vertex < vertices_no; vertex++) {
+                if (const auto range = outside.find(vid_t(vertex))) {
+                    ranges[vertex] = *range;
+                    outside.erase(vid_t(vertex));
+                }
+            }
+        }
+
+        /**
+         * find (overloaded method)
+         *
+         * This returns a pointer to the range of `vertex`, or NULL if `vertex` has no adjacencies.
+         */
+        VertexRange<iterator_t>* find(const vid_t vertex) noexcept {
+            if (vertex >= ranges.size())
+                return outside.find(vertex);
+            return ranges[vertex].degree ? &ranges[vertex] : NULL;
+        }
+
+        /**
+         * find (overloaded method)
+         *
+         * This returns a pointer to the range of `vertex`, or NULL if `vertex` has no adjacencies.
+         */
+        const VertexRange<iterator_t>* find(const vid_t vertex) const noexcept {
+            if (vertex >= ranges.size())
+                return outside.find(vertex);
+            return ranges[vertex].degree ? &ranges[vertex] : NULL;
+        }
+
+        /**
+         * get (method)
+         *
+         * This returns the range of `vertex`, creating an empty one (with degree 0) if needed.
+         */
+        VertexRange<iterator_t>& get(const vid_t vertex) {
+            return vertex < ranges.size() ? ranges[vertex] : outside.get(vertex);
+        }
+
+        /**
+         * erase (method)
+         *
+         * This forgets the range of `vertex`.
+         */
+        void erase(const vid_t vertex) noexcept {
+            if (vertex < ranges.size())
+                ranges[vertex] = VertexRange<iterator_t>();
+            else
+                outside.erase(vertex);
+        }
+
+        /**
+         * clear (method)
+         *
+         * This forgets all the ranges, keeping the reserved room.
+         */
+        void clear() noexcept {
+            std::fill(ranges.begin(), ranges.end(), VertexRange<iterator_t>());
+            outside.clear();
+        }
+
+        /**
+         * dense_vertices (method)
+         *
+         * This returns the number of vertices indexed densely: the ones in [0, dense_vertices()).
+         */
+        size_t dense_vertices() const noexcept {
+            return ranges.size();
+        }
+    };
+
+}
+
+#endif //KONIG_VERTEXINDEX_HPP
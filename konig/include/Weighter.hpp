@@ -0,0 +1,69 @@
+#ifndef KONIG_WEIGHTER_HPP
+#define KONIG_WEIGHTER_HPP
+
+#include "util.hpp"
+#include "AdjacencyTree.hpp"
+
+namespace konig {
+
+    /*
+     * Weighters are the policies used by the Graph classes to assign weights to the edges. A weighter defines the
+     * constant `weighted`; if it is true, it also defines the type `weight_t` and a const, deterministic
+     * `operator()(adjacency_t adjacency)`. Unweighted graphs use NoWeighter, which makes all the weight handling
+     * disappear at compile time.
+     */
+
+    /**
+     * NoWeighter (type)
+     *
+     * This is the weighter of unweighted graphs.
+     */
+    struct NoWeighter {
+        static const bool weighted = false;
+    };
+
+    /**
+     * RandomWeighter (type)
+     *
+     * This assigns to each edge a random weight in [min, max] (or [min, max) for floating point weights). The weight
+     * of an edge is drawn from an engine seeded with the edge and the seed of the weighter, so it does not change
+     * between calls and the same seed always gives the same weights.
+     */
+    template<typename T>
+    class RandomWeighter {
+    private:
+        T min, max;
+        uint64_t seed;
+
+    public:
+        static const bool weighted = true;
+        typedef T weight_t;
+
+        RandomWeighter(const T min, const T max, const uint64_t seed = random::engine()())
+                : min(min), max(max), seed(seed) { }
+
+        T operator()(const adjacency_t adjacency) const {
+            random::engine_t engine(seed ^ ((uint64_t(adjacency.first) << 32) | adjacency.second));
+            return random::randrange(engine, min, max);
+        }
+    };
+
+    namespace detail {
+
+        /**
+         * put_weight (overloaded function)
+         *
+         * This appends to `buffer` a space followed by the weight of `adjacency`, for weighted graphs only.
+         */
+        template<typename buffer_t, typename weighter_t>
+        void put_weight(buffer_t& buffer, const weighter_t& weighter, const adjacency_t adjacency, std::true_type) {
+            buffer.put(' ').put(weighter(adjacency));
+        }
+
+        template<typename buffer_t, typename weighter_t>
+        void put_weight(buffer_t&, const weighter_t&, const adjacency_t, std::false_type) noexcept { }
+    }
+
+}
+
+#endif //KONIG_WEIGHTER_HPP
@@ -1,30 +1,346 @@
 #ifndef KONIG_UTIL_HPP
 #define KONIG_UTIL_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <exception>
+#include <limits>
 #include <random>
 #include <cstdint>
+#include <type_traits>
 
 namespace konig {
 
     typedef uint32_t vid_t;
 
     namespace random {
-        std::random_device random_device;
-        std::mt19937_64 random_generator(random_device());
 
-        template<typename T1, typename T2>
-        auto randrange(T1 bottom, T2 top)
+        /**
+         * splitmix64 (function)
+         *
+         * This advances `state` and returns the next output of the SplitMix64 generator. It is only used to expand a
+         * single 64-bit seed into the state of the bigger engines.
+         */
+        inline uint64_t splitmix64(uint64_t& state) noexcept {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        /**
+         * Xoshiro256StarStar (type)
+         *
+         * This is the xoshiro256** engine by Blackman and Vigna: a fast, small-state generator of 64-bit numbers with
+         * period 2^256 - 1. It satisfies the UniformRandomBitGenerator requirements, so it can also be used with the
+         * standard distributions.
+         *
+         * jump() advances the engine by 2^128 steps: calling it k times on copies of the same engine gives k
+         * non-overlapping streams, which is how Konig hands out independent, reproducible generators to threads.
+         */
+        class Xoshiro256StarStar {
+
+            //////////////////////////
+            // Members              //
+            //////////////////////////
+        private:
+            uint64_t state[4];
+
+
+            //////////////////////////
+            // Methods              //
+            //////////////////////////
+        private:
+            static uint64_t rotl(const uint64_t x, const int k) noexcept {
+                return (x << k) | (x >> (64 - k));
+            }
+
+        public:
+            typedef uint64_t result_type;
+
+            explicit Xoshiro256StarStar(const uint64_t seed_value = 0) noexcept {
+                seed(seed_value);
+            }
+
+            static constexpr result_type min() noexcept {
+                return 0;
+            }
+
+            static constexpr result_type max() noexcept {
+                return std::numeric_limits<result_type>::max();
+            }
+
+            /**
+             * seed (method)
+             *
+             * This reinitializes the state of the engine from a single 64-bit seed.
+             */
+            void seed(uint64_t seed_value) noexcept {
+                for (auto& word : state)
+                    word = splitmix64(seed_value);
+            }
+
+            result_type operator()() noexcept {
+                const uint64_t result = rotl(state[1] * 5, 7) * 9;
+                const uint64_t t = state[1] << 17;
+
+                state[2] ^= state[0];
+                state[3] ^= state[1];
+                state[1] ^= state[2];
+                state[0] ^= state[3];
+                state[2] ^= t;
+                state[3] = rotl(state[3], 45);
+
+                return result;
+            }
+
+            /**
+             * jump (method)
+             *
+             * This is equivalent to 2^128 calls to operator().
+             */
+            void jump() noexcept {
+                static const uint64_t JUMP[] = {
+                        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+                };
+
+                uint64_t jumped[4] = {0, 0, 0, 0};
+                for (const uint64_t polynomial : JUMP) {
+                    for (int bit = 0; bit < 64; bit++) {
+                        if (polynomial & (uint64_t(1) << bit))
+                            for (int i = 0; i < 4; i++)
+                                jumped[i] ^= state[i];
+                        (*this)();
+                    }
+                }
+
+                for (int i = 0; i < 4; i++)
+                    state[i] = jumped[i];
+            }
+
+            bool operator==(const Xoshiro256StarStar& other) const noexcept {
+                return std::equal(state, state + 4, other.state);
+            }
+
+            bool operator!=(const Xoshiro256StarStar& other) const noexcept {
+                return !(*this == other);
+            }
+        };
+
+        /**
+         * engine_t (type)
+         *
+         * This is the engine used by Konig whenever the caller does not provide one.
+         */
+        typedef Xoshiro256StarStar engine_t;
+
+        /**
+         * stream (function)
+         *
+         * This returns the `index`-th stream of the given seed, i.e. an engine seeded with `seed_value` and then jumped
+         * `index` times. Distinct indices give non-overlapping sequences. It costs O(index) jumps.
+         */
+        inline engine_t stream(const uint64_t seed_value, const uint64_t index) noexcept {
+            engine_t engine(seed_value);
+            for (uint64_t i = 0; i < index; i++)
+                engine.jump();
+            return engine;
+        }
+
+        namespace detail {
+            inline std::atomic<uint64_t>& master_seed() noexcept {
+                static std::atomic<uint64_t> seed_value(std::random_device{}());
+                return seed_value;
+            }
+
+            inline std::atomic<uint64_t>& next_thread_stream() noexcept {
+                static std::atomic<uint64_t> next(0);
+                return next;
+            }
+
+            inline engine_t& thread_engine_storage() {
+                thread_local engine_t engine(stream(master_seed().load(), next_thread_stream()++));
+                return engine;
+            }
+
+            /**
+             * mul_high (function)
+             *
+             * This returns the high and the low 64 bits of the 128-bit product a * b.
+             */
+            inline uint64_t mul_high(const uint64_t a, const uint64_t b, uint64_t& low) noexcept {
+#ifdef __SIZEOF_INT128__
+                const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+                low = static_cast<uint64_t>(product);
+                return static_cast<uint64_t>(product >> 64);
+#else
+                const uint64_t a_lo = a & 0xffffffffULL, a_hi = a >> 32;
+                const uint64_t b_lo = b & 0xffffffffULL, b_hi = b >> 32;
+                const uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+                const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffffULL) + lo_hi;
+
+                low = (cross << 32) | (lo_lo & 0xffffffffULL);
+                return hi_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+            }
+
+            template<typename engine_type>
+            struct is_full_64_bit : std::integral_constant<bool,
+                    engine_type::min() == 0 && engine_type::max() == std::numeric_limits<uint64_t>::max()> { };
+
+            template<typename engine_type>
+            uint64_t bounded(engine_type& engine, const uint64_t range, std::true_type) {
+                uint64_t low;
+                uint64_t high = mul_high(engine(), range, low);
+
+                if (low < range) {
+                    const uint64_t threshold = (0 - range) % range;
+                    while (low < threshold)
+                        high = mul_high(engine(), range, low);
+                }
+                return high;
+            }
+
+            template<typename engine_type>
+            uint64_t bounded(engine_type& engine, const uint64_t range, std::false_type) {
+                return std::uniform_int_distribution<uint64_t>(0, range - 1)(engine);
+            }
+        }
+
+        /**
+         * engine (function)
+         *
+         * This returns the engine of the calling thread. Each thread gets its own stream of the master seed (see
+         * seed()), in order of first use.
+         */
+        inline engine_t& engine() {
+            return detail::thread_engine_storage();
+        }
+
+        /**
+         * seed (function)
+         *
+         * This sets the master seed: the engine of the calling thread is reset to stream 0 of `seed_value`, and the
+         * threads which haven't used their engine yet will get the following streams. Unless this is called, the
+         * master seed comes from std::random_device.
+         */
+        inline void seed(const uint64_t seed_value) {
+            auto& current_engine = engine();
+
+            detail::master_seed() = seed_value;
+            detail::next_thread_stream() = 1;
+            current_engine = stream(seed_value, 0);
+        }
+
+        /**
+         * bounded (function)
+         *
+         * This returns a uniformly distributed integer in [0, range), using Lemire's multiply-and-shift method: the
+         * (rare) rejection step is the only one needing a division.
+         *
+         * @pre `range` > 0
+         */
+        template<typename engine_type>
+        uint64_t bounded(engine_type& engine, const uint64_t range) {
+            return detail::bounded(engine, range, detail::is_full_64_bit<engine_type>());
+        }
+
+        /**
+         * canonical (function)
+         *
+         * This returns a uniformly distributed double in [0, 1), with 53 random bits.
+         */
+        template<typename engine_type>
+        double canonical(engine_type& engine) {
+            static_assert(detail::is_full_64_bit<engine_type>::value, "canonical() needs a 64-bit engine");
+            return (engine() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        /**
+         * randrange (overloaded function)
+         *
+         * This returns a random floating point number in [bottom, top), drawn from `engine`.
+         */
+        template<typename engine_type, typename T1, typename T2>
+        auto randrange(engine_type& engine, T1 bottom, T2 top)
                 -> typename std::enable_if<!std::is_integral<decltype(bottom + top)>::value, decltype(bottom + top)>::type
         {
-            return std::uniform_real_distribution<decltype(bottom + top)>(bottom, top)();
+            typedef decltype(bottom + top) result_t;
+            return bottom + static_cast<result_t>(top - bottom) * static_cast<result_t>(canonical(engine));
         }
 
-        template<typename T1, typename T2>
-        auto randrange(T1 bottom, T2 top)
+        /**
+         * randrange (overloaded function)
+         *
+         * This returns a random integer in [bottom, top] (both ends included), drawn from `engine`.
+         */
+        template<typename engine_type, typename T1, typename T2>
+        auto randrange(engine_type& engine, T1 bottom, T2 top)
                 -> typename std::enable_if<std::is_integral<decltype(bottom + top)>::value, decltype(bottom + top)>::type
         {
-            return std::uniform_int_distribution<decltype(bottom + top)>(bottom, top)();
+            typedef decltype(bottom + top) result_t;
+            typedef typename std::make_unsigned<result_t>::type unsigned_t;
+
+            const uint64_t range = uint64_t(unsigned_t(unsigned_t(top) - unsigned_t(bottom))) + 1;
+            const uint64_t offset = range ? bounded(engine, range) : engine();
+            return static_cast<result_t>(unsigned_t(bottom) + unsigned_t(offset));
+        }
+
+        /**
+         * randrange (overloaded function)
+         *
+         * This is the same as randrange(engine(), bottom, top), i.e. it draws from the engine of the calling thread.
+         */
+        template<typename T1, typename T2>
+        auto randrange(T1 bottom, T2 top) -> decltype(bottom + top) {
+            return randrange(engine(), bottom, top);
+        }
+
+        /**
+         * fill (overloaded function)
+         *
+         * This assigns to each element of [first, last) randrange(engine, bottom, top). The bounds are processed once
+         * for the whole batch, so this is faster than calling randrange in a loop.
+         */
+        template<typename engine_type, typename OutputIt, typename T1, typename T2>
+        auto fill(engine_type& engine, OutputIt first, OutputIt last, T1 bottom, T2 top)
+                -> typename std::enable_if<std::is_integral<decltype(bottom + top)>::value>::type
+        {
+            typedef decltype(bottom + top) result_t;
+            typedef typename std::make_unsigned<result_t>::type unsigned_t;
+
+            const uint64_t range = uint64_t(unsigned_t(unsigned_t(top) - unsigned_t(bottom))) + 1;
+            for (; first != last; ++first) {
+                const uint64_t offset = range ? bounded(engine, range) : engine();
+                *first = static_cast<result_t>(unsigned_t(bottom) + unsigned_t(offset));
+            }
+        }
+
+        /**
+         * fill (overloaded function)
+         *
+         * This assigns to each element of [first, last) randrange(engine, bottom, top), for floating point bounds.
+         */
+        template<typename engine_type, typename OutputIt, typename T1, typename T2>
+        auto fill(engine_type& engine, OutputIt first, OutputIt last, T1 bottom, T2 top)
+                -> typename std::enable_if<!std::is_integral<decltype(bottom + top)>::value>::type
+        {
+            typedef decltype(bottom + top) result_t;
+
+            const result_t width = static_cast<result_t>(top - bottom);
+            for (; first != last; ++first)
+                *first = bottom + width * static_cast<result_t>(canonical(engine));
+        }
+
+        /**
+         * fill (overloaded function)
+         *
+         * This is the same as fill(engine(), first, last, bottom, top), i.e. it draws from the engine of the calling
+         * thread.
+         */
+        template<typename OutputIt, typename T1, typename T2>
+        void fill(OutputIt first, OutputIt last, T1 bottom, T2 top) {
+            fill(engine(), first, last, bottom, top);
         }
     }
 }
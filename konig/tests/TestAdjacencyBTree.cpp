@@ -0,0 +1,114 @@
+#include "Catch/single_include/catch.hpp"
+#include <random>
+#include <set>
+#include "../include/AdjacencyBTree.hpp"
+#include "../include/AdjacencyManager.hpp"
+
+namespace TestAdjacencyBTree {
+    using konig::adjacency_t;
+
+    TEST_CASE("AdjacencyBTree with many nodes", "[ABT]") {
+        konig::AdjacencyBTree ABT;
+        std::set<adjacency_t> reference;
+        std::mt19937 generator(7);
+
+        SECTION("Random operations") {
+            // enough adjacencies for three levels of inner nodes, then most of them are erased again
+            for (int round = 0; round < 2; round++) {
+                for (int i = 0; i < 100000; i++) {
+                    const adjacency_t adjacency(generator() % 1000, generator() % 1000);
+                    CHECK(ABT.insert(adjacency).second == reference.insert(adjacency).second);
+                }
+                for (int i = 0; i < 150000; i++) {
+                    const adjacency_t adjacency(generator() % 1000, generator() % 1000);
+                    ABT.erase(ABT.find(adjacency));
+                    reference.erase(adjacency);
+                }
+                REQUIRE(ABT.size() == reference.size());
+            }
+
+            CHECK(std::vector<adjacency_t>(ABT.begin(), ABT.end()) ==
+                  std::vector<adjacency_t>(reference.begin(), reference.end()));
+
+            size_t rank = 1;
+            bool ranks_match = true;
+            for (const auto& adjacency : reference) {
+                ranks_match = ranks_match && ABT.rank(ABT.find(adjacency)) == rank;
+                ranks_match = ranks_match && *ABT.select(rank) == adjacency;
+                ++rank;
+            }
+            CHECK(ranks_match);
+
+            while (ABT.size())
+                ABT.erase(ABT.begin());
+            CHECK(ABT.begin() == ABT.end());
+            ABT.insert({1, 1});
+            CHECK(std::vector<adjacency_t>(ABT.begin(), ABT.end()) == std::vector<adjacency_t>({{1, 1}}));
+        }
+
+        SECTION("Iterators are relocated") {
+            for (konig::vid_t i = 0; i < 10000; i += 2)
+                ABT.insert({i, 0});
+            const auto it = ABT.find({5000, 0});
+            auto next = it;
+            ++next;
+
+            // splits move {5000, 0} to other leaves
+            for (konig::vid_t i = 1; i < 10000; i += 2)
+                ABT.insert({i, 0});
+
+            CHECK(*it == adjacency_t(5000, 0));
+            CHECK(*(it + 1) == adjacency_t(5001, 0));
+            CHECK(*(it - 1) == adjacency_t(4999, 0));
+            CHECK(*next == adjacency_t(5002, 0));
+            CHECK(next - it == 2);
+            CHECK(ABT.rank(it) == 5001);
+
+            ABT.erase(ABT.find({4999, 0}));
+            auto previous = it;
+            --previous;
+            CHECK(*previous == adjacency_t(4998, 0));
+            CHECK(ABT.end() - it == 5000);
+        }
+
+        SECTION("Reverse iteration") {
+            std::vector<adjacency_t> batch;
+            for (konig::vid_t i = 0; i < 5000; i++)
+                batch.push_back({i / 10, i % 10});
+            ABT.insert(batch.begin(), batch.end());
+
+            std::vector<adjacency_t> reversed;
+            for (auto it = ABT.end(); it != ABT.begin(); )
+                reversed.push_back(*(--it));
+            CHECK(std::vector<adjacency_t>(reversed.rbegin(), reversed.rend()) == batch);
+        }
+    }
+
+    TEST_CASE("BTreeAdjacencyManager neighbourhoods", "[ABT]") {
+        konig::BTreeAdjacencyManager AM(100);
+        std::set<adjacency_t> reference;
+        std::mt19937 generator(11);
+
+        for (int i = 0; i < 20000; i++) {
+            const adjacency_t adjacency(generator() % 100, generator() % 500);
+            if (generator() % 4) {
+                AM.insert(adjacency);
+                reference.insert(adjacency);
+            } else {
+                AM.erase(adjacency);
+                reference.erase(adjacency);
+            }
+        }
+        AM.freeze();
+
+        bool neighbourhoods_match = true;
+        for (konig::vid_t u = 0; u < 100; u++) {
+            const std::vector<adjacency_t> expected(reference.lower_bound({u, 0}), reference.lower_bound({u + 1, 0}));
+            neighbourhoods_match = neighbourhoods_match && AM.degree(u) == expected.size();
+            neighbourhoods_match = neighbourhoods_match &&
+                                   std::vector<adjacency_t>(AM.begin(u), AM.end(u)) == expected;
+        }
+        CHECK(neighbourhoods_match);
+        CHECK(AM.to_csr().size() == reference.size());
+    }
+}
@@ -3,8 +3,9 @@
 
 namespace TestAdjacencyManager {
 
-    TEST_CASE("AjacencyManager structural updates", "[AM]") {
-        konig::AdjacencyManager AM;
+    template<typename manager_t>
+    void check_structural_updates() {
+        manager_t AM;
 
         SECTION("Duplicates") {
             AM.insert({0, 1});
@@ -19,5 +20,188 @@ namespace TestAdjacencyManager {
               {0, 1}
             }));
         }
+
+        SECTION("Neighbourhoods") {
+            CHECK(AM.insert({1, 5}).second);
+            CHECK(AM.insert({1, 3}).second);
+            CHECK(AM.insert({1, 9}).second);
+            CHECK(!AM.insert({1, 3}).second);
+            AM.insert({0, 4});
+            AM.insert({2, 4});
+
+            CHECK(std::vector<konig::adjacency_t>(AM.begin(1), AM.end(1)) == std::vector<konig::adjacency_t>({
+              {1, 3}, {1, 5}, {1, 9}
+            }));
+
+            AM.erase({1, 3});
+            AM.erase({1, 9});
+            CHECK(std::vector<konig::adjacency_t>(AM.begin(1), AM.end(1)) == std::vector<konig::adjacency_t>({
+              {1, 5}
+            }));
+
+            AM.erase({1, 5});
+            CHECK(AM.begin(1) == AM.end(1));
+            CHECK(AM.size() == 2);
+        }
+
+        SECTION("Degrees") {
+            AM.insert({1, 5});
+            AM.insert({1, 3});
+            AM.insert({4, 1});
+            CHECK(AM.degree(1) == 2);
+            CHECK(AM.degree(4) == 1);
+            CHECK(AM.degree(0) == 0);
+            CHECK(AM.degree(1000) == 0);
+
+            std::vector<konig::adjacency_t> batch = {{1, 7}, {1, 3}, {2, 0}};
+            AM.insert(batch.begin(), batch.end());
+            CHECK(AM.degree(1) == 3);
+            CHECK(AM.degree(2) == 1);
+
+            AM.erase({1, 3});
+            CHECK(AM.degree(1) == 2);
+        }
+
+        SECTION("Bulk insert") {
+            AM.insert({1, 5});
+            AM.insert({3, 0});
+
+            std::vector<konig::adjacency_t> batch = {{1, 2}, {0, 1}, {1, 7}, {0, 1}, {2, 3}};
+            AM.insert(batch.begin(), batch.end());
+
+            CHECK(AM.size() == 6);
+            CHECK(std::vector<konig::adjacency_t>(AM.begin(1), AM.end(1)) == std::vector<konig::adjacency_t>({
+              {1, 2}, {1, 5}, {1, 7}
+            }));
+            CHECK(std::vector<konig::adjacency_t>(AM.begin(0), AM.end(0)) == std::vector<konig::adjacency_t>({
+              {0, 1}
+            }));
+            CHECK(std::vector<konig::adjacency_t>(AM.begin(3), AM.end(3)) == std::vector<konig::adjacency_t>({
+              {3, 0}
+            }));
+        }
+
+        SECTION("Assign") {
+            AM.insert({1, 5});
+            AM.insert({4, 0});
+
+            std::vector<konig::adjacency_t> batch = {{2, 3}, {0, 1}, {2, 1}, {0, 1}};
+            AM.assign(batch.begin(), batch.end());
+
+            CHECK(AM.size() == 3);
+            CHECK(!AM.has({1, 5}));
+            CHECK(AM.degree(1) == 0);
+            CHECK(AM.degree(4) == 0);
+            CHECK(AM.degree(2) == 2);
+            CHECK(std::vector<konig::adjacency_t>(AM.begin(2), AM.end(2)) == std::vector<konig::adjacency_t>({
+              {2, 1}, {2, 3}
+            }));
+
+            AM.erase({2, 1});
+            AM.insert({2, 7});
+            CHECK(std::vector<konig::adjacency_t>(AM.begin(2), AM.end(2)) == std::vector<konig::adjacency_t>({
+              {2, 3}, {2, 7}
+            }));
+
+            AM.assign(batch.end(), batch.end());
+            CHECK(AM.size() == 0);
+            CHECK(AM.begin(0) == AM.end(0));
+        }
+
+        SECTION("Remove vertex") {
+            for (konig::vid_t u = 0; u < 10; u++)
+                for (konig::vid_t v = 0; v < u; v++)
+                    AM.insert({u, v});
+
+            CHECK(AM.remove_vertex(5) == 5);
+            CHECK(AM.remove_vertex(5) == 0);
+            CHECK(AM.remove_vertex(0) == 0);
+            CHECK(AM.size() == 40);
+            CHECK(AM.degree(5) == 0);
+            CHECK(AM.begin(5) == AM.end(5));
+            CHECK(!AM.has({5, 0}));
+
+            CHECK(AM.degree(4) == 4);
+            CHECK(AM.degree(6) == 6);
+            CHECK(*AM.begin(6) == konig::adjacency_t(6, 0));
+            CHECK(std::vector<konig::adjacency_t>(AM.begin(4), AM.end(4)) == std::vector<konig::adjacency_t>({
+              {4, 0}, {4, 1}, {4, 2}, {4, 3}
+            }));
+
+            CHECK(AM.remove_vertex(9) == 9);
+            CHECK(AM.remove_vertex(1) == 1);
+            AM.erase({2, 0});
+            AM.insert({5, 8});
+            CHECK(AM.size() == 30);
+            CHECK(*AM.begin(2) == konig::adjacency_t(2, 1));
+            CHECK(std::vector<konig::adjacency_t>(AM.begin(5), AM.end(5)) == std::vector<konig::adjacency_t>({
+              {5, 8}
+            }));
+            CHECK(std::vector<konig::adjacency_t>(AM.begin(8), AM.end(8)).size() == 8);
+
+            AM.freeze();
+            CHECK_THROWS_AS(AM.remove_vertex(8), konig::StructureViolation);
+            AM.thaw();
+        }
+    }
+
+    TEST_CASE("AjacencyManager structural updates", "[AM]") {
+        check_structural_updates<konig::AdjacencyManager>();
+    }
+
+    TEST_CASE("CompactAdjacencyManager structural updates", "[AM]") {
+        check_structural_updates<konig::CompactAdjacencyManager>();
+    }
+
+    TEST_CASE("BTreeAdjacencyManager structural updates", "[AM]") {
+        check_structural_updates<konig::BTreeAdjacencyManager>();
+    }
+
+    TEST_CASE("AjacencyManager with a hashed vertex index", "[AM]") {
+        konig::BasicAdjacencyManager<konig::HashedVertexIndex> AM;
+
+        AM.insert({1 << 30, 2});
+        AM.insert({1 << 30, 1});
+        AM.insert({3, 1});
+
+        CHECK(AM.degree(1 << 30) == 2);
+        CHECK(std::vector<konig::adjacency_t>(AM.begin(1 << 30), AM.end(1 << 30)) == std::vector<konig::adjacency_t>({
+          {1 << 30, 1}, {1 << 30, 2}
+        }));
+
+        AM.erase({3, 1});
+        CHECK(AM.degree(3) == 0);
+        CHECK(AM.begin(3) == AM.end(3));
+    }
+
+    TEST_CASE("AdjacencyManager with vertices outside the dense index", "[AM]") {
+        konig::AdjacencyManager AM(10);
+
+        AM.insert({4000000000u, 0});
+        AM.insert({4000000000u, 7});
+        AM.insert({3, 1});
+        AM.insert({12, 5});
+
+        CHECK(AM.degree(4000000000u) == 2);
+        CHECK(AM.degree(12) == 1);
+        CHECK(std::vector<konig::adjacency_t>(AM.begin(4000000000u), AM.end(4000000000u)) ==
+              std::vector<konig::adjacency_t>({{4000000000u, 0}, {4000000000u, 7}}));
+
+        const std::vector<konig::adjacency_t> adjacencies(AM.begin(), AM.end());
+        AM.assign(adjacencies.begin(), adjacencies.end());
+        CHECK(AM.degree(4000000000u) == 2);
+        CHECK(AM.degree(3) == 1);
+
+        CHECK(AM.dense_vertices() == 10);
+        AM.reserve(20);
+        CHECK(AM.dense_vertices() == 20);
+        CHECK(AM.degree(12) == 1);
+        CHECK(*AM.begin(12) == konig::adjacency_t(12, 5));
+
+        AM.erase({4000000000u, 0});
+        AM.erase({4000000000u, 7});
+        CHECK(AM.degree(4000000000u) == 0);
+        CHECK(AM.begin(4000000000u) == AM.end(4000000000u));
+        CHECK(AM.size() == 2);
     }
-}
\ No newline at end of file
+}
@@ -1,10 +1,14 @@
 #include "Catch/single_include/catch.hpp"
+#include <set>
 #include "../include/AdjacencyTree.hpp"
+#include "../include/AdjacencyBTree.hpp"
 
 namespace TestAdjacencyTree {
 
-    TEST_CASE("AjacencyTree structural updates", "[AT]") {
-        konig::AdjacencyTree AT;
+    // The same tests are run on all the backends of AdjacencyManager
+    template<typename tree_t>
+    void check_structural_updates() {
+        tree_t AT;
 
         SECTION("Duplicates") {
             AT.insert({0, 1});
@@ -15,6 +19,40 @@ namespace TestAdjacencyTree {
             CHECK(AT.size() == 1);
         }
 
+        SECTION("Insertion result") {
+            auto first = AT.insert({0, 1});
+            CHECK(first.second);
+            CHECK(*first.first == konig::adjacency_t(0, 1));
+
+            auto second = AT.insert({0, 1});
+            CHECK(!second.second);
+            CHECK(second.first == first.first);
+        }
+
+        SECTION("Random operations") {
+            std::set<konig::adjacency_t> reference;
+            std::mt19937 generator(42);
+
+            for (int i = 0; i < 5000; i++) {
+                konig::adjacency_t adjacency(generator() % 50, generator() % 50);
+
+                if (generator() % 3) {
+                    CHECK(AT.insert(adjacency).second == reference.insert(adjacency).second);
+                } else if (AT.has(adjacency)) {
+                    AT.erase(AT.find(adjacency));
+                    reference.erase(adjacency);
+                }
+            }
+
+            CHECK(AT.size() == reference.size());
+            CHECK(std::vector<konig::adjacency_t>(AT.begin(), AT.end()) ==
+                  std::vector<konig::adjacency_t>(reference.begin(), reference.end()));
+
+            size_t rank = 1;
+            for (const auto& adjacency : reference)
+                CHECK(AT.rank(AT.find(adjacency)) == rank++);
+        }
+
         SECTION("Mixed insert") {
             AT.insert({0, 1});
             AT.insert({1, 2});
@@ -43,6 +81,193 @@ namespace TestAdjacencyTree {
             CHECK(AT.size() == 2);
         }
 
+        SECTION("Clear") {
+            for (konig::vid_t i = 0; i < 1000; i++)
+                AT.insert({i, i + 1});
+            AT.erase(AT.find({10, 11}));
+            CHECK(AT.size() == 999);
+
+            AT.clear();
+            CHECK(AT.size() == 0);
+            CHECK(AT.begin() == AT.end());
+
+            AT.insert({0, 1});
+            CHECK(AT.size() == 1);
+        }
+
+        SECTION("Erase everything") {
+            AT.insert({0, 1});
+            AT.insert({0, 2});
+
+            AT.erase(AT.find({0, 1}));
+            AT.erase(AT.find({0, 2}));
+            CHECK(AT.size() == 0);
+            CHECK(AT.begin() == AT.end());
+        }
+
+        SECTION("Iteration") {
+            std::vector<konig::adjacency_t> expected;
+            for (konig::vid_t i = 0; i < 100; i++) {
+                AT.insert({(i * 37) % 100, 0});
+                expected.push_back({i, 0});
+            }
+
+            CHECK(std::vector<konig::adjacency_t>(AT.begin(), AT.end()) == expected);
+
+            std::vector<konig::adjacency_t> reversed;
+            for (auto it = AT.end(); it != AT.begin(); )
+                reversed.push_back(*(--it));
+            CHECK(std::vector<konig::adjacency_t>(reversed.rbegin(), reversed.rend()) == expected);
+
+            auto it = AT.begin();
+            ++it;
+            CHECK(*it == konig::adjacency_t(1, 0));
+            it += 10;
+            CHECK(*it == konig::adjacency_t(11, 0));
+            --it;
+            CHECK(*it == konig::adjacency_t(10, 0));
+            CHECK(AT.end() - it == 90);
+        }
+
+        SECTION("Bulk build") {
+            std::vector<konig::adjacency_t> batch;
+            for (konig::vid_t i = 0; i < 1000; i++)
+                batch.push_back({(i * 7) % 500, 0});
+
+            tree_t built(batch.begin(), batch.end());
+            CHECK(built.size() == 500);
+
+            for (size_t rank = 1; rank <= 500; rank++)
+                CHECK(*built.select(rank) == konig::adjacency_t(rank - 1, 0));
+            CHECK(built.rank(built.find({123, 0})) == 124);
+
+            AT.insert({1000, 0});
+            AT.assign(batch.begin(), batch.end());
+            CHECK(AT.size() == 500);
+            CHECK(!AT.has({1000, 0}));
+        }
+
+        SECTION("Merge insert") {
+            for (konig::vid_t i = 0; i < 100; i += 2)
+                AT.insert({i, 0});
+            const auto kept = AT.find({50, 0});
+
+            std::vector<konig::adjacency_t> big_batch;
+            for (konig::vid_t i = 0; i < 100; i += 3)
+                big_batch.push_back({i, 0});
+            AT.insert(big_batch.begin(), big_batch.end());
+
+            std::vector<konig::adjacency_t> small_batch = {{1, 0}, {1000, 0}};
+            AT.insert(small_batch.begin(), small_batch.end());
+
+            std::vector<konig::adjacency_t> expected;
+            for (konig::vid_t i = 0; i < 100; i++)
+                if (i % 2 == 0 || i % 3 == 0 || i == 1)
+                    expected.push_back({i, 0});
+            expected.push_back({1000, 0});
+
+            CHECK(std::vector<konig::adjacency_t>(AT.begin(), AT.end()) == expected);
+            CHECK(AT.size() == expected.size());
+            CHECK(*kept == konig::adjacency_t(50, 0));
+            CHECK(AT.rank(kept) == 1 + size_t(std::distance(expected.begin(),
+                                                            std::find(expected.begin(), expected.end(), *kept))));
+        }
+
+        SECTION("Range erase") {
+            std::set<konig::adjacency_t> reference;
+            for (konig::vid_t i = 0; i < 1000; i++) {
+                AT.insert({i, i % 7});
+                reference.insert({i, i % 7});
+            }
+            const auto kept = AT.find({900, 900 % 7});
+
+            const std::vector<std::pair<size_t, size_t>> ranges = {{10, 20}, {0, 5}, {500, 500}, {100, 800}, {0, 1},
+                                                                   {150, 175}};
+            for (const auto& range : ranges) {
+                AT.erase(AT.select(range.first + 1), AT.select(range.second + 1));
+                auto first = reference.begin(), last = reference.begin();
+                std::advance(first, range.first);
+                std::advance(last, range.second);
+                reference.erase(first, last);
+
+                CHECK(AT.size() == reference.size());
+                CHECK(std::vector<konig::adjacency_t>(AT.begin(), AT.end()) ==
+                      std::vector<konig::adjacency_t>(reference.begin(), reference.end()));
+            }
+            CHECK(*kept == konig::adjacency_t(900, 900 % 7));
+            CHECK(AT.rank(kept) == 1 + size_t(std::distance(reference.begin(), reference.find(*kept))));
+
+            AT.erase(AT.find({900, 900 % 7}), AT.end());
+            CHECK(AT.size() + 100 == reference.size());
+            CHECK(*AT.select(AT.size()) == konig::adjacency_t(899, 899 % 7));
+            AT.erase(AT.begin(), AT.end());
+            CHECK(AT.size() == 0);
+            CHECK(AT.begin() == AT.end());
+            AT.insert({1, 1});
+            CHECK(AT.size() == 1);
+        }
+
+        SECTION("Split and merge") {
+            for (konig::vid_t i = 0; i < 300; i++)
+                AT.insert({i, 0});
+
+            tree_t other;
+            other.insert({1000, 0});
+            AT.split_at(AT.find({200, 0}), other);
+            CHECK(AT.size() == 200);
+            CHECK(other.size() == 100);
+            CHECK(*AT.select(200) == konig::adjacency_t(199, 0));
+            CHECK(*other.begin() == konig::adjacency_t(200, 0));
+            CHECK(!other.has({1000, 0}));
+            CHECK_THROWS_AS(AT.split_at(AT.begin(), AT), konig::InvalidArgument);
+
+            AT.merge(other);
+            CHECK(other.size() == 0);
+            CHECK(AT.size() == 300);
+            for (size_t rank = 1; rank <= 300; rank++)
+                CHECK(*AT.select(rank) == konig::adjacency_t(rank - 1, 0));
+
+            // Interleaved keys fall back to a batch insertion
+            other.insert({150, 1});
+            other.insert({400, 0});
+            AT.merge(other);
+            CHECK(AT.size() == 302);
+            CHECK(AT.rank(AT.find({150, 1})) == 152);
+            CHECK(*AT.select(302) == konig::adjacency_t(400, 0));
+
+            AT.split_at(AT.begin(), other);
+            CHECK(AT.size() == 0);
+            CHECK(other.size() == 302);
+            AT.merge(other);
+            CHECK(AT.size() == 302);
+        }
+
+        SECTION("Frozen queries") {
+            for (konig::vid_t i = 0; i < 100; i++)
+                AT.insert({i, i});
+            AT.freeze();
+            CHECK(AT.is_frozen());
+
+            const tree_t& CAT = AT;
+            CHECK(CAT.has({42, 42}));
+            CHECK(!CAT.has({42, 43}));
+            CHECK(CAT.rank(CAT.find({42, 42})) == 43);
+            CHECK(*CAT.select(43) == konig::adjacency_t(42, 42));
+            CHECK(*CAT.lower_bound({42, 43}) == konig::adjacency_t(43, 43));
+            CHECK(*CAT.upper_bound({42, 42}) == konig::adjacency_t(43, 43));
+            CHECK(AT.rank(AT.find({99, 99})) == 100);
+            CHECK(AT.end() - AT.begin() == 100);
+
+            CHECK_THROWS_AS(AT.insert({100, 100}), konig::StructureViolation);
+            CHECK_THROWS_AS(AT.erase(AT.begin()), konig::StructureViolation);
+            CHECK_THROWS_AS(AT.erase(AT.begin(), AT.end()), konig::StructureViolation);
+            CHECK(AT.size() == 100);
+
+            AT.thaw();
+            AT.insert({100, 100});
+            CHECK(AT.size() == 101);
+        }
+
         SECTION("Value") {
             AT.insert({1, 2});
             AT.insert({1 << 30, 1 << 29});
@@ -50,4 +275,16 @@ namespace TestAdjacencyTree {
         }
     }
 
+    TEST_CASE("AjacencyTree structural updates", "[AT]") {
+        check_structural_updates<konig::AdjacencyTree>();
+    }
+
+    TEST_CASE("CompactAdjacencyTree structural updates", "[AT]") {
+        check_structural_updates<konig::CompactAdjacencyTree>();
+    }
+
+    TEST_CASE("AdjacencyBTree structural updates", "[AT]") {
+        check_structural_updates<konig::AdjacencyBTree>();
+    }
+
 }
\ No newline at end of file
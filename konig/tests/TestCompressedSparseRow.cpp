@@ -0,0 +1,53 @@
+#include "Catch/single_include/catch.hpp"
+#include "../include/AdjacencyManager.hpp"
+#include "../include/CompressedSparseRow.hpp"
+
+namespace TestCompressedSparseRow {
+
+    TEST_CASE("CompressedSparseRow snapshots", "[CSR]") {
+        konig::AdjacencyManager AM;
+
+        SECTION("Empty") {
+            auto csr = AM.to_csr();
+            CHECK(csr.vertices() == 0);
+            CHECK(csr.size() == 0);
+
+            auto padded = AM.to_csr(5);
+            CHECK(padded.vertices() == 5);
+            CHECK(padded.degree(4) == 0);
+        }
+
+        SECTION("Export") {
+            AM.insert({3, 1});
+            AM.insert({0, 2});
+            AM.insert({0, 1});
+            AM.insert({3, 7});
+
+            auto csr = AM.to_csr();
+            CHECK(csr.vertices() == 8);
+            CHECK(csr.size() == 4);
+            CHECK(csr.offsets_data() == std::vector<size_t>({0, 2, 2, 2, 4, 4, 4, 4, 4}));
+            CHECK(csr.targets_data() == std::vector<konig::vid_t>({1, 2, 1, 7}));
+
+            CHECK(csr.degree(0) == 2);
+            CHECK(csr.degree(1) == 0);
+            CHECK(std::vector<konig::vid_t>(csr.neighbours(3).begin(), csr.neighbours(3).end()) ==
+                  std::vector<konig::vid_t>({1, 7}));
+
+            CHECK(csr.has({3, 7}));
+            CHECK(!csr.has({3, 6}));
+            CHECK(!csr.has({10, 0}));
+            CHECK(csr.position({3, 1}) == 2);
+        }
+
+        SECTION("Weights") {
+            AM.insert({0, 1});
+            AM.insert({1, 0});
+
+            konig::WeightedCompressedSparseRow<int> weighted(AM.to_csr(), {10, 20});
+            CHECK(weighted.weight(weighted.position({1, 0})) == 20);
+
+            CHECK_THROWS_AS(konig::WeightedCompressedSparseRow<int>(AM.to_csr(), {10}), konig::InvalidArgument);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#include "Catch/single_include/catch.hpp"
+#include <thread>
+#include <vector>
+#include "../include/DisjointSet.hpp"
+
+namespace TestDisjointSet {
+
+    TEST_CASE("DisjointSet", "[DS]") {
+        konig::DisjointSet DS(10);
+
+        SECTION("Merge") {
+            CHECK(DS.size() == 10);
+            CHECK(DS.sets() == 10);
+
+            CHECK(DS.merge(0, 1));
+            CHECK(DS.merge(2, 3));
+            CHECK(DS.merge(1, 3));
+            CHECK(!DS.merge(0, 2));
+            CHECK(DS.concurrent_merge(9, 0));
+            CHECK(!DS.concurrent_merge(3, 9));
+
+            CHECK(DS.sets() == 6);
+            CHECK(DS.same(0, 3));
+            CHECK(DS.same(9, 2));
+            CHECK(!DS.same(4, 5));
+            CHECK(DS.find(4) == 4);
+        }
+
+        SECTION("Long paths") {
+            const konig::vid_t size = 1 << 21;
+            konig::DisjointSet path(size);
+
+            // Linking by index chains the roots one below the other, and the first find walks the whole path
+            for (konig::vid_t i = size - 1; i > 0; i--)
+                path.concurrent_merge(i - 1, i);
+            CHECK(path.sets() == 1);
+            CHECK(path.find(size - 1) == 0);
+            CHECK(path.same(0, size / 2));
+        }
+    }
+
+    TEST_CASE("DisjointSet concurrent merges", "[DS]") {
+        const konig::vid_t size = 100000;
+        konig::random::engine_t engine(5);
+        std::vector<std::pair<konig::vid_t, konig::vid_t>> pairs(size);
+        for (auto& pair : pairs) {
+            pair.first = static_cast<konig::vid_t>(konig::random::bounded(engine, size));
+            pair.second = static_cast<konig::vid_t>(konig::random::bounded(engine, size));
+        }
+
+        konig::DisjointSet sequential(size), concurrent(size);
+        for (const auto& pair : pairs)
+            sequential.merge(pair.first, pair.second);
+
+        std::vector<std::thread> threads;
+        for (unsigned thread = 0; thread < 4; thread++)
+            threads.emplace_back([&, thread]() {
+                for (size_t i = thread; i < pairs.size(); i += 4)
+                    concurrent.concurrent_merge(pairs[i].first, pairs[i].second);
+            });
+        for (auto& thread : threads)
+            thread.join();
+
+        CHECK(concurrent.sets() == sequential.sets());
+        bool same_partition = true;
+        for (konig::vid_t v = 1; v < size; v++)
+            same_partition = same_partition && sequential.same(v - 1, v) == concurrent.same(v - 1, v);
+        CHECK(same_partition);
+    }
+}
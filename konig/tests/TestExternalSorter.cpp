@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "Catch/single_include/catch.hpp"
+#include "../include/ExternalSorter.hpp"
+#include "../include/AdjacencyRanks.hpp"
+
+namespace TestExternalSorter {
+
+    std::vector<konig::adjacency_t> visited(const konig::ExternalSorter& sorter) {
+        std::vector<konig::adjacency_t> result;
+        sorter.visit([&](const konig::vid_t tail, const konig::vid_t head) { result.push_back({tail, head}); });
+        return result;
+    }
+
+    TEST_CASE("ExternalSorter", "[ExternalSorter]") {
+        konig::random::engine_t engine(17);
+
+        SECTION("Spilled runs") {
+            konig::ExternalSorter sorter(1 << 12);
+            std::set<konig::adjacency_t> reference;
+            for (size_t i = 0; i < 20000; i++) {
+                const konig::adjacency_t adjacency(konig::random::bounded(engine, 300),
+                                                   konig::random::bounded(engine, 300));
+                sorter.push(adjacency);
+                reference.insert(adjacency);
+            }
+            CHECK_THROWS_AS(visited(sorter), konig::StructureViolation);
+            sorter.finish();
+
+            CHECK(sorter.spilled_runs() > 1);
+            CHECK(sorter.pushed() == 20000);
+            CHECK(sorter.size() == reference.size());
+            CHECK(visited(sorter) == std::vector<konig::adjacency_t>(reference.begin(), reference.end()));
+            CHECK(visited(sorter) == std::vector<konig::adjacency_t>(reference.begin(), reference.end()));
+            CHECK_THROWS_AS(sorter.push({0, 0}), konig::StructureViolation);
+        }
+
+        SECTION("In memory") {
+            konig::ExternalSorter sorter(1 << 20);
+            const std::vector<konig::adjacency_t> batch = {{3, 1}, {0, 2}, {3, 1}, {1, 1}};
+            sorter.push(batch.begin(), batch.end());
+            sorter.finish();
+
+            CHECK(sorter.spilled_runs() == 0);
+            CHECK(sorter.size() == 3);
+            CHECK(visited(sorter) == std::vector<konig::adjacency_t>({{0, 2}, {1, 1}, {3, 1}}));
+        }
+
+        SECTION("Empty") {
+            konig::ExternalSorter sorter(1 << 12);
+            sorter.finish();
+            CHECK(sorter.size() == 0);
+            CHECK(visited(sorter).empty());
+        }
+
+        SECTION("Invalid arguments") {
+            CHECK_THROWS_AS(konig::ExternalSorter(16), konig::InvalidArgument);
+            CHECK_THROWS_AS(konig::ExternalSorter(1 << 12, "/nonexistent/directory"), konig::InvalidArgument);
+        }
+    }
+
+    TEST_CASE("Out-of-core generation", "[ExternalSorter]") {
+        const uint64_t vertices_no = 2000, edges_no = 100000, seed = 5;
+
+        SECTION("Same samples as in memory") {
+            const konig::DirectedRanks ranks(vertices_no);
+            konig::ExternalSorter sorter(1 << 14);
+            konig::sample_adjacencies(ranks, edges_no, seed, sorter);
+
+            CHECK(sorter.spilled_runs() > 1);
+            CHECK(visited(sorter) == konig::sample_adjacencies(ranks, edges_no, seed));
+
+            std::string output, expected = std::to_string(vertices_no) + " " + std::to_string(edges_no) + "\n";
+            for (const auto& adjacency : konig::sample_adjacencies(ranks, edges_no, seed))
+                expected += std::to_string(adjacency.first) + " " + std::to_string(adjacency.second) + "\n";
+            {
+                konig::GraphWriter writer(output);
+                konig::write_edges(writer, sorter, vertices_no);
+            }
+            CHECK(output == expected);
+        }
+
+        SECTION("Symmetric binary file") {
+            const konig::UndirectedRanks ranks(vertices_no);
+            konig::ExternalSorter sorter(1 << 14);
+            konig::sample_adjacencies(ranks, edges_no, seed, sorter, true);
+            CHECK(sorter.size() == 2 * edges_no);
+
+            std::vector<konig::adjacency_t> adjacencies = konig::sample_adjacencies(ranks, edges_no, seed);
+            for (size_t i = 0; i < edges_no; i++)
+                adjacencies.push_back({adjacencies[i].second, adjacencies[i].first});
+            std::sort(adjacencies.begin(), adjacencies.end());
+            const konig::CompressedSparseRow csr(adjacencies.begin(), adjacencies.end(), vertices_no);
+
+            for (const bool compressed : {false, true}) {
+                char name[] = "/tmp/konig-test-XXXXXX";
+                const int fd = mkstemp(name);
+                REQUIRE(fd >= 0);
+                {
+                    konig::GraphWriter writer(fd);
+                    konig::write_graph(writer, sorter, vertices_no, compressed);
+                }
+
+                const konig::CompressedSparseRow mapped = konig::MappedGraph(name).to_csr();
+                CHECK(mapped.offsets_data() == csr.offsets_data());
+                CHECK(mapped.targets_data() == csr.targets_data());
+                ::close(fd);
+                ::unlink(name);
+            }
+        }
+    }
+}
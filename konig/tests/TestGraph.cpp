@@ -0,0 +1,589 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "Catch/single_include/catch.hpp"
+#include "../include/UndirectedGraph.hpp"
+#include "../include/DirectedGraph.hpp"
+
+namespace TestGraph {
+
+    /**
+     * parse (function)
+     *
+     * This splits the output of a graph into its header and the lines of its edges.
+     */
+    void parse(const std::string& output, size_t& vertices_no, size_t& edges_no, std::vector<std::string>& lines) {
+        std::istringstream stream(output);
+        stream >> vertices_no >> edges_no;
+        stream.ignore();
+
+        std::string line;
+        lines.clear();
+        while (std::getline(stream, line))
+            lines.push_back(line);
+    }
+
+    std::string write(const konig::UndirectedGraph<>& graph) {
+        std::string output;
+        konig::GraphWriter writer(output);
+        graph.write(writer);
+        writer.flush();
+        return output;
+    }
+
+    /**
+     * SelectCountingManager (type)
+     *
+     * This is an AdjacencyManager which counts the select queries of all its instances, i.e. the exclusions read by
+     * the samplers.
+     */
+    struct SelectCountingManager : konig::AdjacencyManager {
+        static size_t selects;
+
+        using konig::AdjacencyManager::AdjacencyManager;
+        using konig::AdjacencyManager::select;
+
+        iterator select(const size_t rank) noexcept {
+            ++selects;
+            return konig::AdjacencyManager::select(rank);
+        }
+    };
+
+    size_t SelectCountingManager::selects = 0;
+
+    TEST_CASE("UndirectedGraph", "[Graph]") {
+        konig::random::engine_t engine(17);
+
+        SECTION("Edges") {
+            konig::UndirectedGraph<> graph(5);
+            graph.add_edge(1, 3);
+            graph.add_edge(3, 1);
+            graph.add_edge(0, 4);
+
+            CHECK(graph.vertices() == 5);
+            CHECK(graph.edges() == 2);
+            CHECK(graph.has_edge(1, 3));
+            CHECK(graph.has_edge(3, 1));
+            CHECK(!graph.has_edge(1, 2));
+            CHECK(graph.adjacencies().size() == 2);
+            CHECK(graph.degree(3) == 1);
+            CHECK(graph.degree(2) == 0);
+
+            CHECK_THROWS_AS(graph.add_edge(2, 2), konig::InvalidArgument);
+            CHECK_THROWS_AS(graph.add_edge(2, 5), konig::InvalidArgument);
+
+            CHECK(write(graph) == "5 2\n3 1\n4 0\n");
+        }
+
+        SECTION("Neighbourhoods") {
+            konig::UndirectedGraph<> graph(6);
+            graph.add_edge(2, 0);
+            graph.add_edge(2, 5);
+            graph.add_edge(4, 2);
+
+            auto neighbours = graph.neighbours(2);
+            CHECK(std::vector<konig::vid_t>(neighbours.begin(), neighbours.end()) ==
+                  std::vector<konig::vid_t>({0, 4, 5}));
+            CHECK(graph.degree(5) == 1);
+
+            // The neighbourhoods are rebuilt after a change
+            graph.add_edge(1, 2);
+            CHECK(graph.degree(2) == 4);
+            CHECK(graph.neighbourhoods().size() == 2 * graph.edges());
+            CHECK_THROWS_AS(graph.degree(6), konig::InvalidArgument);
+        }
+
+        SECTION("Random edges") {
+            konig::UndirectedGraph<> graph(100);
+            graph.build_path();
+            graph.add_edges(1000, engine);
+            CHECK(graph.edges() == 1099);
+            for (konig::vid_t i = 0; i + 1 < 100; i++)
+                CHECK(graph.has_edge(i, i + 1));
+
+            graph.add_edges(100 * 99 / 2 - 1099, engine);
+            CHECK(graph.edges() == 100 * 99 / 2);
+            CHECK_THROWS_AS(graph.add_edges(1, engine), konig::InvalidArgument);
+
+            // Dense requests are sampled through their complement
+            konig::UndirectedGraph<> dense(300);
+            dense.build_path();
+            dense.add_edges(300 * 299 / 2 * 9 / 10, engine);
+            CHECK(dense.edges() == 299 + 300 * 299 / 2 * 9 / 10);
+            for (konig::vid_t i = 0; i + 1 < 300; i++)
+                CHECK(dense.has_edge(i, i + 1));
+
+            // A few edges missing from a nearly complete graph are sampled without walking the rank space
+            typedef konig::UndirectedGraph<konig::IdentityLabeler, konig::NoWeighter, SelectCountingManager> counting_t;
+            counting_t nearly_complete(300);
+            nearly_complete.add_edges(300 * 299 / 2 - 5, engine);
+            SelectCountingManager::selects = 0;
+            nearly_complete.add_edges(3, engine);
+            CHECK(nearly_complete.edges() == 300 * 299 / 2 - 2);
+            CHECK(SelectCountingManager::selects < 300);
+        }
+
+        SECTION("Shapes") {
+            konig::UndirectedGraph<> clique(30), star(30), wheel(30), cycle(30), tree(30);
+            clique.build_clique();
+            star.build_star();
+            wheel.build_wheel();
+            cycle.build_cycle();
+            tree.build_tree(engine);
+
+            CHECK(clique.edges() == 30 * 29 / 2);
+            CHECK(star.edges() == 29);
+            CHECK(wheel.edges() == 58);
+            CHECK(cycle.edges() == 30);
+            CHECK(cycle.has_edge(29, 0));
+            CHECK(tree.edges() == 29);
+            for (konig::vid_t v = 1; v < 30; v++) {
+                CHECK(star.degree(v) == 1);
+                CHECK(wheel.degree(v) == 3);
+                CHECK(cycle.degree(v) == 2);
+                CHECK(tree.degree(v) >= 1);
+            }
+
+            konig::UndirectedGraph<> forest(30);
+            forest.build_forest(10, engine);
+            CHECK(forest.edges() == 10);
+            CHECK_THROWS_AS(forest.build_forest(30, engine), konig::InvalidArgument);
+        }
+
+        SECTION("Connect") {
+            konig::UndirectedGraph<> forest(30);
+            forest.build_forest(10, engine);
+            forest.connect(engine);
+            CHECK(forest.edges() == 29);
+
+            konig::DisjointSet components(30);
+            for (auto it = forest.adjacencies().begin(); it != forest.adjacencies().end(); ++it)
+                CHECK(components.merge(it->first, it->second));
+            CHECK(components.sets() == 1);
+
+            forest.connect(engine);
+            CHECK(forest.edges() == 29);
+
+            konig::UndirectedGraph<> sparse(20000);
+            sparse.add_edges(8000, engine);
+            konig::DisjointSet before(20000);
+            for (auto it = sparse.adjacencies().begin(); it != sparse.adjacencies().end(); ++it)
+                before.merge(it->first, it->second);
+
+            sparse.connect(engine, 4);
+            CHECK(sparse.edges() == 8000 + before.sets() - 1);
+            konig::DisjointSet after(20000);
+            for (auto it = sparse.adjacencies().begin(); it != sparse.adjacencies().end(); ++it)
+                after.merge(it->first, it->second);
+            CHECK(after.sets() == 1);
+        }
+
+        SECTION("Degree distributions") {
+            // Weights big enough make every probability 1
+            konig::UndirectedGraph<> clique(40);
+            clique.build_chung_lu(std::vector<double>(40, 40), engine);
+            CHECK(clique.edges() == 40 * 39 / 2);
+
+            const size_t n = 200000;
+            std::vector<double> weights(n, 6);
+            for (size_t i = 0; i < 100; i++)
+                weights[i * 997] = 600;
+            konig::UndirectedGraph<> chung_lu(n);
+            chung_lu.build_chung_lu(weights, engine, 4);
+            const double expected = 0.5 * std::accumulate(weights.begin(), weights.end(), 0.0);
+            CHECK(std::abs(double(chung_lu.edges()) - expected) < 0.02 * expected);
+            size_t hub_degrees = 0;
+            for (size_t i = 0; i < 100; i++)
+                hub_degrees += chung_lu.degree(static_cast<konig::vid_t>(i * 997));
+            CHECK(hub_degrees > 100 * 560);
+            CHECK(hub_degrees < 100 * 640);
+
+            // The blocks have independent streams: the result doesn't depend on the threads
+            konig::random::engine_t first(3), second(3);
+            konig::UndirectedGraph<> serial(n), parallel(n);
+            serial.build_power_law(2.5, 8, first, 1);
+            parallel.build_power_law(2.5, 8, second, 4);
+            CHECK(serial.edges() == parallel.edges());
+            CHECK(std::equal(serial.adjacencies().begin(), serial.adjacencies().end(), parallel.adjacencies().begin()));
+            CHECK(std::abs(double(serial.edges()) - 4.0 * n) < 0.05 * 4.0 * n);
+            CHECK(serial.degree(0) > 100 * serial.degree(n - 1));
+
+            CHECK_THROWS_AS(serial.build_chung_lu(std::vector<double>(3, 1.0), engine), konig::InvalidArgument);
+            CHECK_THROWS_AS(serial.build_power_law(1, 8, engine), konig::InvalidArgument);
+
+            std::vector<size_t> degrees(1000, 3);
+            degrees[0] = 2;
+            konig::UndirectedGraph<> configuration(1000);
+            CHECK_THROWS_AS(configuration.build_configuration(degrees, engine), konig::InvalidArgument);
+            degrees[1] = 2;
+            configuration.build_configuration(degrees, engine);
+            CHECK(configuration.edges() <= 1499);
+            CHECK(configuration.edges() > 1480);
+            bool bounded = true;
+            for (konig::vid_t v = 0; v < 1000; v++)
+                bounded = bounded && configuration.degree(v) <= degrees[v];
+            CHECK(bounded);
+        }
+
+        SECTION("Set operations") {
+            konig::UndirectedGraph<> a(6), b(8);
+            const std::vector<konig::adjacency_t> a_edges = {{0, 1}, {1, 2}, {2, 3}, {4, 5}};
+            const std::vector<konig::adjacency_t> b_edges = {{2, 1}, {3, 4}, {5, 4}, {6, 7}};
+            a.add_edges(a_edges.begin(), a_edges.end());
+            b.add_edges(b_edges.begin(), b_edges.end());
+
+            konig::UndirectedGraph<> united(6);
+            united.unite(a);
+            united.unite(b);
+            CHECK(united.vertices() == 8);
+            CHECK(united.adjacencies().dense_vertices() == 8);
+            CHECK(united.edges() == 6);
+            CHECK(united.degree(4) == 2);
+
+            konig::UndirectedGraph<> common(6);
+            common.unite(a);
+            common.intersect(b);
+            CHECK(std::vector<konig::adjacency_t>(common.adjacencies().begin(), common.adjacencies().end()) ==
+                  std::vector<konig::adjacency_t>({{2, 1}, {5, 4}}));
+
+            united.subtract(a);
+            CHECK(std::vector<konig::adjacency_t>(united.adjacencies().begin(), united.adjacencies().end()) ==
+                  std::vector<konig::adjacency_t>({{4, 3}, {7, 6}}));
+            CHECK(united.degree(1) == 0);
+
+            united.complement();
+            CHECK(united.edges() == 8 * 7 / 2 - 2);
+            CHECK(!united.has_edge(3, 4));
+            CHECK(united.has_edge(0, 7));
+
+            konig::UndirectedGraph<> disjoint(6);
+            disjoint.unite(a);
+            disjoint.add_disjoint(b);
+            CHECK(disjoint.vertices() == 14);
+            CHECK(disjoint.adjacencies().dense_vertices() == 14);
+            CHECK(disjoint.edges() == 8);
+            CHECK(disjoint.has_edge(12, 13));
+            CHECK(disjoint.has_edge(0, 1));
+            CHECK(!disjoint.has_edge(6, 7));
+
+            // Relabelling a path along a random permutation gives a Hamiltonian path through it
+            konig::UndirectedGraph<> path(1000);
+            path.build_path();
+            std::vector<konig::vid_t> permutation(1000);
+            std::iota(permutation.begin(), permutation.end(), konig::vid_t(0));
+            std::shuffle(permutation.begin(), permutation.end(), engine);
+            path.relabel(permutation);
+            CHECK(path.edges() == 999);
+            for (konig::vid_t i = 0; i + 1 < 1000; i++)
+                CHECK(path.has_edge(permutation[i], permutation[i + 1]));
+            CHECK(path.degree(permutation[0]) == 1);
+            permutation[0] = permutation[1];
+            CHECK_THROWS_AS(path.relabel(permutation), konig::InvalidArgument);
+
+            // The grid is the product of two paths, and the product is the same as the one built edge by edge
+            konig::UndirectedGraph<> grid(7), column(5);
+            grid.build_path();
+            column.build_cycle();
+            grid.cartesian_product(column);
+            CHECK(grid.vertices() == 35);
+            CHECK(grid.adjacencies().dense_vertices() == 35);
+            CHECK(grid.edges() == 6 * 5 + 7 * 5);
+
+            konig::UndirectedGraph<> expected(35);
+            std::vector<konig::adjacency_t> expected_edges;
+            for (konig::vid_t j = 0; j < 5; j++)
+                for (konig::vid_t i = 0; i < 7; i++) {
+                    if (i + 1 < 7)
+                        expected_edges.push_back({j * 7 + i, j * 7 + i + 1});
+                    expected_edges.push_back({j * 7 + i, (j + 1) % 5 * 7 + i});
+                }
+            expected.add_edges(expected_edges.begin(), expected_edges.end());
+            CHECK(std::equal(grid.adjacencies().begin(), grid.adjacencies().end(), expected.adjacencies().begin()));
+        }
+
+        SECTION("Shuffled output") {
+            konig::UndirectedGraph<> graph(1000);
+            graph.add_edges(5000, engine);
+
+            std::string sorted = write(graph), shuffled, parallel;
+            {
+                konig::GraphWriter writer(shuffled);
+                graph.write_shuffled(writer, 3);
+            }
+            {
+                konig::GraphWriter writer(parallel);
+                graph.write_shuffled(writer, 3, 4);
+            }
+            CHECK(shuffled == parallel);
+            CHECK(shuffled != sorted);
+
+            size_t vertices_no, edges_no;
+            std::vector<std::string> sorted_lines, shuffled_lines;
+            parse(sorted, vertices_no, edges_no, sorted_lines);
+            parse(shuffled, vertices_no, edges_no, shuffled_lines);
+            CHECK(vertices_no == 1000);
+            CHECK(edges_no == 5000);
+            CHECK(shuffled_lines.size() == 5000);
+            std::sort(shuffled_lines.begin(), shuffled_lines.end());
+            std::sort(sorted_lines.begin(), sorted_lines.end());
+            CHECK(shuffled_lines == sorted_lines);
+
+            std::ostringstream stream;
+            stream << graph;
+            CHECK(stream.str().size() == sorted.size());
+        }
+
+        SECTION("Labels and weights") {
+            typedef konig::UndirectedGraph<konig::PermutationLabeler, konig::RandomWeighter<int>> graph_t;
+            graph_t graph(50, konig::PermutationLabeler(1000, 1000000000, 5), konig::RandomWeighter<int>(1, 10, 6));
+            graph.build_clique();
+
+            std::string output;
+            {
+                konig::GraphWriter writer(output);
+                graph.write(writer);
+            }
+
+            size_t vertices_no, edges_no;
+            std::vector<std::string> lines;
+            parse(output, vertices_no, edges_no, lines);
+            REQUIRE(lines.size() == 50 * 49 / 2);
+
+            std::set<int64_t> labels;
+            for (const auto& line : lines) {
+                std::istringstream stream(line);
+                int64_t u, v;
+                int weight;
+                REQUIRE(stream >> u >> v >> weight);
+                CHECK(u >= 1000);
+                CHECK(v < 1000000000);
+                CHECK(weight >= 1);
+                CHECK(weight <= 10);
+                labels.insert(u);
+                labels.insert(v);
+            }
+            CHECK(labels.size() == 50);
+
+            std::string again;
+            {
+                konig::GraphWriter writer(again);
+                graph.write(writer);
+            }
+            CHECK(again == output);
+        }
+
+        SECTION("Weighted snapshot") {
+            const konig::RandomWeighter<int> weighter(1, 10, 6);
+            konig::DirectedGraph<konig::IdentityLabeler, konig::RandomWeighter<int>> graph(30, {}, weighter);
+            graph.add_edges(200);
+
+            const konig::WeightedCompressedSparseRow<int> csr = graph.to_weighted_csr();
+            REQUIRE(csr.size() == 200);
+            CHECK(csr.targets_data() == graph.to_csr().targets_data());
+            for (konig::vid_t tail = 0; tail < 30; tail++)
+                for (size_t position = csr.offsets_data()[tail]; position < csr.offsets_data()[tail + 1]; position++)
+                    CHECK(csr.weight(position) == weighter({tail, csr.targets_data()[position]}));
+
+            char name[] = "/tmp/konig-test-XXXXXX";
+            const int fd = mkstemp(name);
+            REQUIRE(fd >= 0);
+            {
+                konig::GraphWriter writer(fd);
+                graph.write_graph(writer, true);
+            }
+            const konig::MappedGraph mapped(name);
+            CHECK(mapped.is_weighted());
+            CHECK(mapped.to_csr().targets_data() == csr.targets_data());
+            CHECK(std::vector<int>(mapped.weights_data<int>(), mapped.weights_data<int>() + mapped.size()) ==
+                  csr.weights_data());
+            ::close(fd);
+            ::unlink(name);
+
+            konig::UndirectedGraph<> unweighted(10);
+            unweighted.build_path();
+            std::string output;
+            {
+                konig::GraphWriter writer(output);
+                unweighted.write_graph(writer);
+            }
+            CHECK(!output.empty());
+        }
+
+        SECTION("Too few labels") {
+            typedef konig::UndirectedGraph<konig::PermutationLabeler> graph_t;
+            CHECK_THROWS_AS(graph_t(4, konig::PermutationLabeler(0, 3, 7)), konig::InvalidArgument);
+            CHECK_NOTHROW(graph_t(3, konig::PermutationLabeler(0, 3, 7)));
+            CHECK_THROWS_AS(konig::PermutationLabeler(5, 5, 7), konig::InvalidArgument);
+            CHECK_THROWS_AS(konig::PermutationLabeler(5, 4, 7), konig::InvalidArgument);
+
+            typedef konig::UndirectedGraph<konig::StaticLabeler<int>> static_graph_t;
+            CHECK_THROWS_AS(static_graph_t(3, konig::StaticLabeler<int>({1, 2})), konig::InvalidArgument);
+        }
+
+        SECTION("Static labels") {
+            konig::UndirectedGraph<konig::StaticLabeler<std::string>> graph(3, konig::StaticLabeler<std::string>(
+                    {"a", "b", "c"}));
+            graph.build_path();
+
+            std::string output;
+            {
+                konig::GraphWriter writer(output);
+                graph.write(writer);
+            }
+            CHECK(output == "3 2\nb a\nc b\n");
+        }
+    }
+
+    TEST_CASE("DirectedGraph", "[Graph]") {
+        konig::random::engine_t engine(23);
+
+        SECTION("Edges") {
+            konig::DirectedGraph<konig::IotaLabeler> graph(4, konig::IotaLabeler(1));
+            graph.add_edge(0, 1);
+            graph.add_edge(1, 0);
+            graph.add_edge(2, 1);
+
+            CHECK(graph.edges() == 3);
+            CHECK(graph.has_edge(1, 0));
+            CHECK(graph.degree(1) == 1);
+            CHECK(graph.degree(3) == 0);
+            CHECK(!graph.has_edge(1, 2));
+
+            std::string output;
+            {
+                konig::GraphWriter writer(output);
+                graph.write(writer);
+            }
+            CHECK(output == "4 3\n1 2\n2 1\n3 2\n");
+        }
+
+        SECTION("Random edges") {
+            konig::DirectedGraph<> graph(50);
+            graph.build_cycle();
+            graph.add_edges(2000, engine);
+            CHECK(graph.edges() == 2050);
+            CHECK_THROWS_AS(graph.add_edges(50 * 49 - 2049, engine), konig::InvalidArgument);
+            graph.add_edges(50 * 49 - 2050, engine);
+            CHECK(graph.edges() == 50 * 49);
+        }
+
+        SECTION("DAG") {
+            konig::DirectedGraph<> graph(100);
+            graph.build_dag(2000, engine);
+            CHECK(graph.edges() == 2000);
+            for (auto it = graph.adjacencies().begin(); it != graph.adjacencies().end(); ++it)
+                CHECK(it->first > it->second);
+        }
+
+        SECTION("Set operations") {
+            konig::DirectedGraph<> cycle(4), reversed(4);
+            cycle.build_cycle();
+            const std::vector<konig::adjacency_t> edges = {{1, 0}, {2, 1}, {3, 2}, {0, 3}, {0, 1}};
+            reversed.add_edges(edges.begin(), edges.end());
+
+            konig::DirectedGraph<> both(4);
+            both.unite(cycle);
+            both.intersect(reversed);
+            CHECK(both.edges() == 1);
+            CHECK(both.has_edge(0, 1));
+
+            both.complement();
+            CHECK(both.edges() == 11);
+            CHECK(!both.has_edge(0, 1));
+            CHECK(both.has_edge(1, 0));
+
+            // The product of two directed cycles is a directed torus
+            konig::DirectedGraph<> torus(3), other(4);
+            torus.build_cycle();
+            other.build_cycle();
+            torus.cartesian_product(other);
+            CHECK(torus.edges() == 3 * 4 + 4 * 3);
+            std::vector<konig::vid_t> component;
+            CHECK(torus.strong_components(component) == 1);
+            for (konig::vid_t v = 0; v < 12; v++) {
+                CHECK(torus.has_edge(v, v / 3 * 3 + (v % 3 + 1) % 3));
+                CHECK(torus.has_edge(v, (v + 3) % 12));
+            }
+
+            torus.add_disjoint(other);
+            CHECK(torus.vertices() == 16);
+            CHECK(torus.has_edge(15, 12));
+            CHECK(torus.strong_components(component) == 2);
+        }
+
+        SECTION("Strong components") {
+            konig::DirectedGraph<> graph(6);
+            const std::vector<konig::adjacency_t> edges = {{0, 1}, {1, 0}, {1, 2}, {2, 3}, {3, 2}, {4, 5}};
+            graph.add_edges(edges.begin(), edges.end());
+            std::vector<konig::vid_t> component;
+            CHECK(graph.strong_components(component) == 4);
+            CHECK(component[0] == component[1]);
+            CHECK(component[2] == component[3]);
+            CHECK(component[4] != component[5]);
+            // Components are numbered in reverse topological order
+            CHECK(component[0] > component[2]);
+            CHECK(component[4] > component[5]);
+
+            konig::DirectedGraph<> dag(10000);
+            dag.build_dag(30000, engine);
+            CHECK(dag.strong_components(component) == 10000);
+        }
+
+        SECTION("Connect") {
+            konig::DirectedGraph<> empty(20);
+            empty.connect(engine);
+            CHECK(empty.edges() == 20);
+
+            konig::DirectedGraph<> path(5);
+            const std::vector<konig::adjacency_t> edges = {{0, 1}, {1, 2}, {2, 3}, {3, 4}};
+            path.add_edges(edges.begin(), edges.end());
+            path.connect(engine);
+            CHECK(path.edges() == 5);
+            CHECK(path.has_edge(4, 0));
+            path.connect(engine);
+            CHECK(path.edges() == 5);
+
+            // Eswaran-Tarjan: a DAG with sources, sinks and isolated vertices needs max(sources, sinks) + isolated
+            konig::DirectedGraph<> dag(5000);
+            dag.build_dag(3000, engine);
+            std::vector<size_t> in_degree(5000, 0), out_degree(5000, 0);
+            for (auto it = dag.adjacencies().begin(); it != dag.adjacencies().end(); ++it) {
+                ++out_degree[it->first];
+                ++in_degree[it->second];
+            }
+            size_t sources = 0, sinks = 0, isolated = 0;
+            for (size_t v = 0; v < 5000; v++) {
+                if (!in_degree[v] && !out_degree[v])
+                    ++isolated;
+                else if (!in_degree[v])
+                    ++sources;
+                else if (!out_degree[v])
+                    ++sinks;
+            }
+
+            dag.connect(engine);
+            CHECK(dag.edges() == 3000 + std::max(sources, sinks) + isolated);
+            std::vector<konig::vid_t> component;
+            CHECK(dag.strong_components(component) == 1);
+        }
+    }
+
+    TEST_CASE("Graphs backed by an AdjacencyBTree", "[Graph]") {
+        konig::random::engine_t engine(11);
+        konig::UndirectedGraph<konig::IdentityLabeler, konig::NoWeighter, konig::BTreeAdjacencyManager> graph(200);
+        konig::UndirectedGraph<> reference(200);
+
+        graph.build_tree(engine);
+        graph.add_edges(3000, engine);
+        reference.add_edges(graph.adjacencies().begin(), graph.adjacencies().end());
+
+        CHECK(graph.edges() == 3199);
+        CHECK(graph.to_csr().targets_data() == reference.to_csr().targets_data());
+        CHECK(graph.neighbourhoods().targets_data() == reference.neighbourhoods().targets_data());
+    }
+}
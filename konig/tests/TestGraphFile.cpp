@@ -0,0 +1,145 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "Catch/single_include/catch.hpp"
+#include "../include/GraphFile.hpp"
+#include "../include/RangeSampler.hpp"
+#include "../include/AdjacencyRanks.hpp"
+
+namespace TestGraphFile {
+
+    /**
+     * TemporaryFile (type)
+     *
+     * This creates an empty temporary file, deleted on destruction.
+     */
+    class TemporaryFile {
+    public:
+        std::string path;
+        int fd;
+
+        TemporaryFile() {
+            char name[] = "/tmp/konig-test-XXXXXX";
+            fd = mkstemp(name);
+            REQUIRE(fd >= 0);
+            path = name;
+        }
+
+        ~TemporaryFile() {
+            ::close(fd);
+            ::unlink(path.c_str());
+        }
+    };
+
+    void check_same_graph(const konig::MappedGraph& mapped, const konig::CompressedSparseRow& csr) {
+        REQUIRE(mapped.vertices() == csr.vertices());
+        REQUIRE(mapped.size() == csr.size());
+
+        for (konig::vid_t v = 0; v < csr.vertices(); v++) {
+            REQUIRE(mapped.degree(v) == csr.degree(v));
+            REQUIRE(std::vector<konig::vid_t>(mapped.neighbours(v).begin(), mapped.neighbours(v).end()) ==
+                    std::vector<konig::vid_t>(csr.neighbours(v).begin(), csr.neighbours(v).end()));
+        }
+
+        const auto decoded = mapped.to_csr();
+        CHECK(decoded.offsets_data() == csr.offsets_data());
+        CHECK(decoded.targets_data() == csr.targets_data());
+    }
+
+    TEST_CASE("Binary graph files", "[GraphFile]") {
+        auto adjacencies = konig::sample_adjacencies(konig::DirectedRanks(3000), 50000, 3);
+        konig::CompressedSparseRow csr(adjacencies.begin(), adjacencies.end(), 3005);
+
+        SECTION("Plain and compressed") {
+            for (const bool compressed : {false, true}) {
+                TemporaryFile file;
+                {
+                    konig::GraphWriter writer(file.fd);
+                    konig::write_graph(writer, csr, compressed);
+                }
+
+                konig::MappedGraph mapped(file.path);
+                CHECK(mapped.is_compressed() == compressed);
+                CHECK(!mapped.is_weighted());
+                check_same_graph(mapped, csr);
+
+                for (size_t i = 0; i < adjacencies.size(); i += 97) {
+                    CHECK(mapped.position(adjacencies[i]) == i);
+                    CHECK(mapped.has(adjacencies[i]));
+                }
+                CHECK(!mapped.has({3004, 0}));
+                CHECK(mapped.position({5000, 1}) == mapped.size());
+            }
+        }
+
+        SECTION("Compression") {
+            TemporaryFile plain, compressed;
+            {
+                konig::GraphWriter writer(plain.fd);
+                konig::write_graph(writer, csr);
+            }
+            {
+                konig::GraphWriter writer(compressed.fd);
+                konig::write_graph(writer, csr, true);
+            }
+            CHECK(lseek(compressed.fd, 0, SEEK_END) < lseek(plain.fd, 0, SEEK_END));
+        }
+
+        SECTION("Weights") {
+            std::vector<double> weights(csr.size());
+            for (size_t i = 0; i < weights.size(); i++)
+                weights[i] = i * 0.5;
+            konig::WeightedCompressedSparseRow<double> weighted(csr, weights);
+
+            TemporaryFile file;
+            {
+                konig::GraphWriter writer(file.fd);
+                konig::write_graph(writer, weighted, true);
+            }
+
+            konig::MappedGraph mapped(file.path);
+            CHECK(mapped.is_weighted());
+            const double* mapped_weights = mapped.weights_data<double>();
+            CHECK(std::vector<double>(mapped_weights, mapped_weights + mapped.size()) == weights);
+            CHECK(mapped_weights[mapped.position(adjacencies[1234])] == 1234 * 0.5);
+            CHECK_THROWS_AS(mapped.weights_data<float>(), konig::InvalidArgument);
+        }
+
+        SECTION("AdjacencyManager") {
+            konig::AdjacencyManager AM;
+            AM.insert(adjacencies.begin(), adjacencies.end());
+
+            TemporaryFile file;
+            {
+                konig::GraphWriter writer(file.fd);
+                konig::write_graph(writer, AM, 3005, true);
+            }
+            check_same_graph(konig::MappedGraph(file.path), csr);
+        }
+
+        SECTION("Invalid files") {
+            CHECK_THROWS_AS(konig::MappedGraph("/nonexistent/graph"), konig::InvalidArgument);
+
+            TemporaryFile empty;
+            CHECK_THROWS_AS(konig::MappedGraph(empty.path), konig::InvalidArgument);
+
+            TemporaryFile text;
+            {
+                konig::GraphWriter writer(text.fd);
+                writer.put("this is an edge list, not a binary graph file\n");
+                writer.put("0 1\n0 2\n1 2\n");
+            }
+            CHECK_THROWS_AS(konig::MappedGraph(text.path), konig::InvalidArgument);
+
+            TemporaryFile truncated;
+            {
+                konig::GraphWriter writer(truncated.fd);
+                konig::write_graph(writer, csr);
+            }
+            REQUIRE(ftruncate(truncated.fd, 1000) == 0);
+            CHECK_THROWS_AS(konig::MappedGraph(truncated.path), konig::InvalidArgument);
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Catch/single_include/catch.hpp"
+#include "../include/GraphWriter.hpp"
+#include "../include/RangeSampler.hpp"
+#include "../include/AdjacencyRanks.hpp"
+
+namespace TestGraphWriter {
+
+    TEST_CASE("GraphWriter", "[GraphWriter]") {
+        SECTION("Integer formatting") {
+            const std::vector<int64_t> values = {
+                    0, 7, 10, 99, 100, 12345, -1, -100, 4294967295LL,
+                    std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()
+            };
+            for (const int64_t value : values) {
+                char out[32];
+                CHECK(std::string(out, konig::format::format_int(value, out)) == std::to_string(value));
+            }
+
+            char out[32];
+            const uint64_t biggest = std::numeric_limits<uint64_t>::max();
+            CHECK(std::string(out, konig::format::format_uint(biggest, out)) == std::to_string(biggest));
+        }
+
+        SECTION("TextBuffer") {
+            konig::TextBuffer buffer;
+            buffer.put(uint32_t(42)).put(' ').put(-3).put(' ').put(1.5).put(" x").put(std::string("yz"));
+            CHECK(std::string(buffer.data(), buffer.size()) == "42 -3 1.5 xyz");
+
+            buffer.clear();
+            CHECK(buffer.size() == 0);
+        }
+
+        SECTION("String sink") {
+            std::string output;
+            {
+                konig::GraphWriter writer(output, 16);
+                for (int i = 0; i < 100; i++)
+                    writer.put(i).put('\n');
+            }
+
+            std::string expected;
+            for (int i = 0; i < 100; i++)
+                expected += std::to_string(i) + "\n";
+            CHECK(output == expected);
+        }
+
+        SECTION("FILE* and file descriptor sinks") {
+            std::FILE* file = std::tmpfile();
+            REQUIRE(file);
+            {
+                konig::GraphWriter writer(file);
+                writer.put("3 2\n");
+            }
+            {
+                konig::GraphWriter writer(fileno(file));
+                writer.put(0).put(' ').put(1).put('\n');
+            }
+
+            std::rewind(file);
+            char content[64];
+            const size_t length = std::fread(content, 1, sizeof(content), file);
+            std::fclose(file);
+            CHECK(std::string(content, length) == "3 2\n0 1\n");
+        }
+
+        SECTION("Parallel formatting") {
+            const size_t count = 200000;
+            auto formatter = [](konig::TextBuffer& buffer, size_t first, const size_t last) {
+                for (; first < last; first++)
+                    buffer.put(first).put('\n');
+            };
+
+            std::string sequential, parallel;
+            {
+                konig::GraphWriter writer(sequential);
+                writer.write_items(count, formatter, 1);
+            }
+            {
+                konig::GraphWriter writer(parallel, 1000);
+                writer.write_items(count, formatter, 3);
+            }
+            CHECK(sequential == parallel);
+            CHECK(sequential.substr(0, 6) == "0\n1\n2\n");
+
+            // Blocks which format to nothing, and fewer blocks than threads
+            std::string sparse;
+            {
+                konig::GraphWriter writer(sparse);
+                writer.write_items(count, [](konig::TextBuffer& buffer, const size_t first, const size_t) {
+                    if (first == 0)
+                        buffer.put("first\n");
+                }, 8);
+                writer.write_items(10, formatter, 8);
+            }
+            CHECK(sparse == "first\n0\n1\n2\n3\n4\n5\n6\n7\n8\n9\n");
+
+            std::string aborted;
+            konig::GraphWriter writer(aborted);
+            CHECK_THROWS_AS(writer.write_items(count, [](konig::TextBuffer&, const size_t first, const size_t) {
+                if (first >= 100000)
+                    throw konig::Exception(context_info("formatting failed"));
+            }, 3), konig::Exception);
+        }
+
+        SECTION("Adjacencies") {
+            auto adjacencies = konig::sample_adjacencies(konig::DirectedRanks(1000), 100000, 11);
+            konig::CompressedSparseRow csr(adjacencies.begin(), adjacencies.end());
+
+            std::string expected;
+            for (const auto& adjacency : adjacencies)
+                expected += std::to_string(adjacency.first) + " " + std::to_string(adjacency.second) + "\n";
+
+            for (unsigned threads = 1; threads <= 4; threads++) {
+                std::string output;
+                {
+                    konig::GraphWriter writer(output);
+                    konig::write_adjacencies(writer, csr, threads);
+                }
+                CHECK(output == expected);
+            }
+        }
+    }
+}
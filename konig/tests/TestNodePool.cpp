@@ -0,0 +1,120 @@
+#include "Catch/single_include/catch.hpp"
+#include <set>
+#include <vector>
+#include "../include/NodePool.hpp"
+
+namespace TestNodePool {
+
+    struct Node {
+        int value;
+        Node(int value) : value(value) { }
+    };
+
+    TEST_CASE("NodePool allocation", "[NP]") {
+        konig::NodePool<Node> NP;
+
+        SECTION("Creation") {
+            auto a = NP.create(1);
+            auto b = NP.create(2);
+
+            CHECK(a->value == 1);
+            CHECK(b->value == 2);
+            CHECK(NP.size() == 2);
+        }
+
+        SECTION("Reuse") {
+            auto a = NP.create(1);
+            NP.create(2);
+            const auto capacity = NP.capacity();
+
+            NP.destroy(a);
+            CHECK(NP.size() == 1);
+
+            auto c = NP.create(3);
+            CHECK(c == a);
+            CHECK(c->value == 3);
+            CHECK(NP.capacity() == capacity);
+        }
+
+        SECTION("Reserve") {
+            NP.reserve(1000);
+            const auto capacity = NP.capacity();
+            CHECK(capacity >= 1000);
+
+            for (int i = 0; i < 1000; i++)
+                NP.create(i);
+            CHECK(NP.capacity() == capacity);
+            CHECK(NP.size() == 1000);
+        }
+
+        SECTION("Clear") {
+            for (int i = 0; i < 1000; i++)
+                NP.create(i);
+            NP.clear();
+
+            CHECK(NP.size() == 0);
+            CHECK(NP.capacity() == 0);
+        }
+    }
+
+    TEST_CASE("IndexedNodePool allocation", "[NP]") {
+        konig::IndexedNodePool<Node> NP;
+
+        SECTION("Creation") {
+            auto a = NP.create(1);
+            auto b = NP.create(2);
+
+            CHECK(a != 0);
+            CHECK(a != b);
+            CHECK(NP[a].value == 1);
+            CHECK(NP[b].value == 2);
+            CHECK(NP.size() == 2);
+        }
+
+        SECTION("Growth") {
+            std::vector<uint32_t> indices;
+            for (int i = 0; i < 10000; i++)
+                indices.push_back(NP.create(i));
+
+            bool kept = true;
+            for (int i = 0; i < 10000; i++)
+                kept = kept && NP[indices[i]].value == i;
+            CHECK(kept);
+            CHECK(std::set<uint32_t>(indices.begin(), indices.end()).size() == indices.size());
+        }
+
+        SECTION("Reuse") {
+            auto a = NP.create(1);
+            NP.create(2);
+            const auto capacity = NP.capacity();
+
+            NP.destroy(a);
+            CHECK(NP.size() == 1);
+
+            auto c = NP.create(3);
+            CHECK(c == a);
+            CHECK(NP[c].value == 3);
+            CHECK(NP.capacity() == capacity);
+        }
+
+        SECTION("Reserve") {
+            NP.reserve(1000);
+            const auto capacity = NP.capacity();
+            CHECK(capacity >= 1000);
+
+            for (int i = 0; i < 1000; i++)
+                NP.create(i);
+            CHECK(NP.capacity() == capacity);
+            CHECK(NP.size() == 1000);
+        }
+
+        SECTION("Clear") {
+            for (int i = 0; i < 1000; i++)
+                NP.create(i);
+            NP.clear();
+
+            CHECK(NP.size() == 0);
+            CHECK(NP.capacity() == 0);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Catch/single_include/catch.hpp"
+#include "../include/Permutation.hpp"
+#include "../include/GraphWriter.hpp"
+
+namespace TestPermutation {
+
+    TEST_CASE("FeistelPermutation", "[Permutation]") {
+        SECTION("Bijection") {
+            for (const uint64_t size : {1, 2, 3, 7, 64, 1000, 65539}) {
+                konig::FeistelPermutation permutation(size, size * 31);
+                std::vector<bool> seen(size, false);
+                for (uint64_t i = 0; i < size; i++) {
+                    const uint64_t image = permutation(i);
+                    REQUIRE(image < size);
+                    REQUIRE(!seen[image]);
+                    seen[image] = true;
+                    REQUIRE(permutation.inverse(image) == i);
+                }
+            }
+        }
+
+        SECTION("Seeds") {
+            konig::FeistelPermutation first(100000, 1), same(100000, 1), other(100000, 2);
+            size_t fixed_points = 0, differences = 0;
+            for (uint64_t i = 0; i < 100000; i++) {
+                CHECK(first(i) == same(i));
+                fixed_points += first(i) == i;
+                differences += first(i) != other(i);
+            }
+            CHECK(fixed_points < 20);
+            CHECK(differences > 99900);
+        }
+
+        SECTION("Uniformity") {
+            // Over many seeds, the image of a given value should be roughly uniform
+            const uint64_t size = 10;
+            const int trials = 20000;
+            std::vector<int> counts(size, 0);
+            for (int seed = 0; seed < trials; seed++)
+                counts[konig::FeistelPermutation(size, seed)(3)]++;
+            for (const int count : counts)
+                CHECK(std::abs(count - trials / int(size)) < 200);
+        }
+
+        SECTION("Huge domains") {
+            konig::FeistelPermutation permutation(uint64_t(1) << 40, 5);
+            for (uint64_t i = 0; i < 1000; i++)
+                CHECK(permutation.inverse(permutation(i * 1000003)) == i * 1000003);
+            CHECK_THROWS_AS(konig::FeistelPermutation((uint64_t(1) << 62) + 1, 0), konig::InvalidArgument);
+        }
+
+        SECTION("Shuffled output") {
+            std::vector<konig::adjacency_t> adjacencies;
+            for (konig::vid_t u = 0; u < 100; u++)
+                for (konig::vid_t v = 0; v < u % 7; v++)
+                    adjacencies.push_back({u, v});
+            konig::CompressedSparseRow csr(adjacencies.begin(), adjacencies.end());
+            konig::FeistelPermutation order(csr.size(), 42);
+
+            std::string sequential, parallel;
+            {
+                konig::GraphWriter writer(sequential);
+                konig::write_adjacencies(writer, csr, order);
+            }
+            {
+                konig::GraphWriter writer(parallel);
+                konig::write_adjacencies(writer, csr, order, 3);
+            }
+            CHECK(sequential == parallel);
+
+            std::istringstream lines(sequential);
+            std::vector<konig::adjacency_t> written;
+            konig::vid_t u, v;
+            while (lines >> u >> v)
+                written.push_back({u, v});
+            CHECK(written != adjacencies);
+            CHECK(written.front() == adjacencies[order(0)]);
+            std::sort(written.begin(), written.end());
+            CHECK(written == adjacencies);
+
+            konig::GraphWriter writer(sequential);
+            CHECK_THROWS_AS(konig::write_adjacencies(writer, csr, konig::FeistelPermutation(1, 0)),
+                            konig::InvalidArgument);
+        }
+    }
+}
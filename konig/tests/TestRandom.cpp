@@ -0,0 +1,84 @@
+#include <set>
+#include <thread>
+#include "Catch/single_include/catch.hpp"
+#include "../include/util.hpp"
+
+namespace TestRandom {
+
+    TEST_CASE("Random number generation", "[RNG]") {
+        namespace random = konig::random;
+
+        SECTION("Reproducibility") {
+            random::seed(1234);
+            std::vector<uint64_t> first_run;
+            for (int i = 0; i < 100; i++)
+                first_run.push_back(random::randrange(0, 1000000));
+
+            random::seed(1234);
+            std::vector<uint64_t> second_run;
+            for (int i = 0; i < 100; i++)
+                second_run.push_back(random::randrange(0, 1000000));
+
+            CHECK(first_run == second_run);
+        }
+
+        SECTION("Thread streams") {
+            random::seed(42);
+            const uint64_t main_value = random::engine()();
+
+            uint64_t thread_value = 0;
+            std::thread([&thread_value]() { thread_value = random::engine()(); }).join();
+
+            CHECK(main_value == random::stream(42, 0)());
+            CHECK(thread_value == random::stream(42, 1)());
+        }
+
+        SECTION("Jump") {
+            random::engine_t engine(7), jumped(7);
+            jumped.jump();
+            CHECK(engine != jumped);
+            CHECK(random::stream(7, 1) == jumped);
+        }
+
+        SECTION("Integer bounds") {
+            random::engine_t engine(1);
+            std::set<int> seen;
+            for (int i = 0; i < 10000; i++) {
+                const int value = random::randrange(engine, -3, 3);
+                CHECK(value >= -3);
+                CHECK(value <= 3);
+                seen.insert(value);
+            }
+            CHECK(seen.size() == 7);
+
+            CHECK(random::randrange(engine, 5, 5) == 5);
+            random::randrange(engine, uint64_t(0), std::numeric_limits<uint64_t>::max());
+
+            for (int i = 0; i < 1000; i++)
+                CHECK(random::bounded(engine, 3) < 3);
+        }
+
+        SECTION("Real bounds") {
+            random::engine_t engine(1);
+            for (int i = 0; i < 10000; i++) {
+                const double value = random::randrange(engine, 1.5, 2.5);
+                CHECK(value >= 1.5);
+                CHECK(value < 2.5);
+            }
+        }
+
+        SECTION("Batched fill") {
+            random::engine_t engine(3), reference(3);
+            std::vector<uint32_t> values(1000);
+            random::fill(engine, values.begin(), values.end(), 10u, 20u);
+
+            for (const auto value : values)
+                CHECK(value == random::randrange(reference, 10u, 20u));
+
+            std::vector<double> reals(1000);
+            random::fill(reals.begin(), reals.end(), 0.0, 1.0);
+            CHECK(*std::min_element(reals.begin(), reals.end()) >= 0.0);
+            CHECK(*std::max_element(reals.begin(), reals.end()) < 1.0);
+        }
+    }
+}
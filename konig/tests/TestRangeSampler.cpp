@@ -0,0 +1,165 @@
+#include "Catch/single_include/catch.hpp"
+#include <cmath>
+#include <iterator>
+#include <vector>
+#include "../include/AdjacencyRanks.hpp"
+#include "../include/AdjacencyTree.hpp"
+#include "../include/RangeSampler.hpp"
+
+namespace TestRangeSampler {
+
+    bool is_strictly_increasing(const std::vector<uint64_t>& values) {
+        return std::adjacent_find(values.begin(), values.end(), std::greater_equal<uint64_t>()) == values.end();
+    }
+
+    TEST_CASE("Adjacency ranks", "[RS]") {
+        SECTION("Directed") {
+            konig::DirectedRanks ranks(7);
+            CHECK(ranks.size() == 42);
+            for (uint64_t rank = 0; rank < ranks.size(); rank++) {
+                CHECK(ranks.is_valid(ranks.adjacency(rank)));
+                CHECK(ranks.rank(ranks.adjacency(rank)) == rank);
+                if (rank)
+                    CHECK(ranks.adjacency(rank - 1) < ranks.adjacency(rank));
+            }
+        }
+
+        SECTION("Undirected") {
+            konig::UndirectedRanks ranks(50);
+            CHECK(ranks.size() == 1225);
+            for (uint64_t rank = 0; rank < ranks.size(); rank++) {
+                CHECK(ranks.is_valid(ranks.adjacency(rank)));
+                CHECK(ranks.rank(ranks.adjacency(rank)) == rank);
+                if (rank)
+                    CHECK(ranks.adjacency(rank - 1) < ranks.adjacency(rank));
+            }
+        }
+
+        SECTION("Big ranks") {
+            // Rounding the square root of 2 * rank in double precision gets these wrong
+            konig::UndirectedRanks ranks(uint64_t(1) << 32);
+            for (uint64_t tail : {uint64_t(94906267), uint64_t(3037000500), (uint64_t(1) << 32) - 1}) {
+                const uint64_t first = tail * (tail - 1) / 2;
+                CHECK(konig::UndirectedRanks::tail_of(first) == tail);
+                CHECK(konig::UndirectedRanks::tail_of(first - 1) == tail - 1);
+                CHECK(konig::UndirectedRanks::tail_of(first + tail - 1) == tail);
+                CHECK(ranks.adjacency(first + 5) == konig::adjacency_t(tail, 5));
+            }
+            CHECK(ranks.adjacency(ranks.size() - 1) == konig::adjacency_t(0xFFFFFFFFu, 0xFFFFFFFEu));
+            CHECK(konig::detail::isqrt(~uint64_t(0)) == 0xFFFFFFFFu);
+            CHECK(konig::detail::isqrt((uint64_t(1) << 52) + 1) == uint64_t(1) << 26);
+
+            konig::DirectedRanks directed(uint64_t(1) << 32);
+            CHECK(directed.adjacency(directed.size() - 1) == konig::adjacency_t(0xFFFFFFFFu, 0xFFFFFFFEu));
+        }
+
+        SECTION("Batch decoding") {
+            konig::random::engine_t engine(5);
+            konig::UndirectedRanks undirected(3000);
+            konig::DirectedRanks directed(3000);
+            for (uint64_t gap : {1, 5, 700, 100000}) {
+                std::vector<uint64_t> sorted;
+                uint64_t rank = konig::random::bounded(engine, gap);
+                for (; rank < undirected.size(); rank += 1 + konig::random::bounded(engine, gap))
+                    sorted.push_back(rank);
+
+                std::vector<konig::adjacency_t> batch(sorted.size()), expected;
+                CHECK(undirected.decode(sorted.begin(), sorted.end(), batch.begin()) == batch.end());
+                for (auto rank : sorted)
+                    expected.push_back(undirected.adjacency(rank));
+                CHECK(batch == expected);
+
+                directed.decode(sorted.begin(), sorted.end(), batch.begin());
+                expected.clear();
+                for (auto rank : sorted)
+                    expected.push_back(directed.adjacency(rank));
+                CHECK(batch == expected);
+            }
+
+            // Unsorted ranks are decoded correctly as well
+            std::vector<uint64_t> unsorted = {400, 3, 2999 * 3000 / 2 - 1, 0, 401, 4};
+            std::vector<konig::adjacency_t> batch;
+            undirected.decode(unsorted.begin(), unsorted.end(), std::back_inserter(batch));
+            for (size_t i = 0; i < unsorted.size(); i++)
+                CHECK(batch[i] == undirected.adjacency(unsorted[i]));
+        }
+    }
+
+    TEST_CASE("RangeSampler sampling", "[RS]") {
+        SECTION("Sparse") {
+            konig::RangeSampler sampler(200000, 1000000000, 1);
+            CHECK(sampler.chunks() > 1);
+
+            auto samples = sampler.samples(1);
+            CHECK(samples.size() == 200000);
+            CHECK(is_strictly_increasing(samples));
+            CHECK(samples.back() < 1000000000);
+        }
+
+        SECTION("Dense") {
+            konig::RangeSampler sampler(900, 1000, 2);
+            auto samples = sampler.samples();
+            CHECK(samples.size() == 900);
+            CHECK(is_strictly_increasing(samples));
+            CHECK(samples.back() < 1000);
+
+            CHECK(konig::RangeSampler(1000, 1000, 2).samples() == std::vector<uint64_t>(
+                    konig::RangeSampler(1000, 1000, 3).samples()));
+            CHECK(konig::RangeSampler(0, 0, 2).samples().empty());
+        }
+
+        SECTION("Thread independence") {
+            konig::RangeSampler sampler(300000, uint64_t(1) << 40, 5);
+            CHECK(sampler.samples(1) == sampler.samples(3));
+            CHECK(konig::RangeSampler(300000, uint64_t(1) << 40, 5).samples(2) == sampler.samples(1));
+            CHECK(konig::RangeSampler(300000, uint64_t(1) << 40, 6).samples(2) != sampler.samples(1));
+        }
+
+        SECTION("Too many samples") {
+            CHECK_THROWS_AS(konig::RangeSampler(11, 10, 0), konig::InvalidArgument);
+        }
+
+        SECTION("Hypergeometric") {
+            konig::random::engine_t engine(9);
+            uint64_t total = 0;
+            for (int i = 0; i < 1000; i++) {
+                const uint64_t hits = konig::sampling::hypergeometric(engine, 1000, 300, 100);
+                CHECK(hits <= 100);
+                total += hits;
+            }
+            CHECK(total > 28000);
+            CHECK(total < 32000);
+
+            CHECK(konig::sampling::hypergeometric(engine, 10, 10, 5) == 5);
+            CHECK(konig::sampling::hypergeometric(engine, 10, 0, 5) == 0);
+            CHECK(konig::sampling::hypergeometric(engine, 100, 60, 50) >= 10);
+
+            // A population as big as the ranks of a G(n, m) on 10^7 vertices
+            const uint64_t population = 50000000000000, successes = 15000000000000, draws = 1000000, samples = 20000;
+            double sum = 0, squares = 0;
+            for (uint64_t i = 0; i < samples; i++) {
+                const double hits = double(konig::sampling::hypergeometric(engine, population, successes, draws));
+                sum += hits;
+                squares += hits * hits;
+            }
+            const double mean = sum / samples, variance = squares / samples - mean * mean;
+            const double expected_mean = 300000, expected_variance = 210000;  // n p (1 - p), (N - n) / (N - 1) ~ 1
+            CHECK(std::fabs(mean - expected_mean) < 20);  // about 6 standard errors
+            CHECK(std::fabs(variance / expected_variance - 1) < 0.06);  // about 6 standard errors
+        }
+    }
+
+    TEST_CASE("Parallel adjacency sampling", "[RS]") {
+        konig::UndirectedRanks ranks(2000);
+
+        auto adjacencies = konig::sample_adjacencies(ranks, 100000, 11, 4);
+        CHECK(adjacencies == konig::sample_adjacencies(ranks, 100000, 11, 1));
+        CHECK(std::is_sorted(adjacencies.begin(), adjacencies.end()));
+
+        for (const auto& adjacency : adjacencies)
+            CHECK(ranks.is_valid(adjacency));
+
+        konig::AdjacencyTree AT(adjacencies.begin(), adjacencies.end());
+        CHECK(AT.size() == 100000);
+    }
+}
@@ -0,0 +1,144 @@
+#include "Catch/single_include/catch.hpp"
+#include "../include/AdjacencyManager.hpp"
+#include "../include/AdjacencyRanks.hpp"
+#include "../include/SequentialSampler.hpp"
+
+namespace TestSequentialSampler {
+
+    template<typename sampler_t>
+    std::vector<uint64_t> drain(sampler_t& sampler) {
+        std::vector<uint64_t> samples;
+        uint64_t value;
+        while (sampler.next(value))
+            samples.push_back(value);
+        return samples;
+    }
+
+    TEST_CASE("SequentialSampler sampling", "[SS]") {
+        konig::random::engine_t engine(17);
+
+        SECTION("Sparse") {
+            konig::SequentialSampler<> sampler(1000, uint64_t(1) << 50, engine);
+            std::vector<uint64_t> samples(sampler.begin(), sampler.end());
+
+            CHECK(samples.size() == 1000);
+            CHECK(std::adjacent_find(samples.begin(), samples.end(), std::greater_equal<uint64_t>()) == samples.end());
+            CHECK(samples.back() < (uint64_t(1) << 50));
+        }
+
+        SECTION("Dense") {
+            konig::SequentialSampler<> sampler(95, 100, engine);
+            auto samples = drain(sampler);
+
+            CHECK(samples.size() == 95);
+            CHECK(std::adjacent_find(samples.begin(), samples.end(), std::greater_equal<uint64_t>()) == samples.end());
+            CHECK(samples.back() < 100);
+
+            konig::SequentialSampler<> everything(10, 10, engine);
+            CHECK(drain(everything) == std::vector<uint64_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+            konig::SequentialSampler<> nothing(0, 10, engine);
+            CHECK(drain(nothing).empty());
+        }
+
+        SECTION("Uniformity") {
+            std::vector<int> hits(20, 0);
+            for (int i = 0; i < 20000; i++) {
+                konig::SequentialSampler<> sampler(2, 20, engine);
+                for (auto value : drain(sampler))
+                    hits[value]++;
+            }
+            for (auto count : hits) {
+                CHECK(count > 1700);
+                CHECK(count < 2300);
+            }
+
+            std::vector<int> sparse_hits(4, 0);
+            for (int i = 0; i < 20000; i++) {
+                konig::SequentialSampler<> sampler(3, 4000, engine);
+                for (auto value : drain(sampler))
+                    sparse_hits[value / 1000]++;
+            }
+            for (auto count : sparse_hits) {
+                CHECK(count > 14000);
+                CHECK(count < 16000);
+            }
+        }
+
+        SECTION("Exclusions") {
+            std::vector<uint64_t> exclusions = {0, 1, 2, 5, 7, 8, 9};
+            konig::ExcludingSampler<std::vector<uint64_t>> sampler(3, 10, exclusions, engine);
+            CHECK(drain(sampler) == std::vector<uint64_t>({3, 4, 6}));
+
+            std::vector<uint64_t> many_exclusions;
+            for (uint64_t i = 0; i < 100000; i += 2)
+                many_exclusions.push_back(i);
+            konig::ExcludingSampler<std::vector<uint64_t>> odd_sampler(1000, 100000, many_exclusions, engine);
+            auto samples = drain(odd_sampler);
+            CHECK(samples.size() == 1000);
+            for (auto value : samples)
+                CHECK(value % 2 == 1);
+        }
+
+        SECTION("Complement") {
+            std::vector<uint64_t> exclusions = {0, 1, 2, 5, 7, 8, 9};
+            konig::ComplementSampler<std::vector<uint64_t>> sampler(3, 10, exclusions, engine);
+            CHECK(drain(sampler) == std::vector<uint64_t>({3, 4, 6}));
+            konig::ComplementSampler<std::vector<uint64_t>> partial(2, 10, exclusions, engine);
+            auto samples = drain(partial);
+            CHECK(samples.size() == 2);
+            for (auto value : samples)
+                CHECK((value == 3 || value == 4 || value == 6));
+            CHECK_THROWS_AS((konig::ComplementSampler<std::vector<uint64_t>>(4, 10, exclusions, engine)),
+                            konig::InvalidArgument);
+
+            std::vector<uint64_t> many_exclusions;
+            for (uint64_t i = 0; i < 100000; i += 2)
+                many_exclusions.push_back(i);
+            konig::ComplementSampler<std::vector<uint64_t>> odd_sampler(45000, 100000, many_exclusions, engine);
+            samples = drain(odd_sampler);
+            CHECK(samples.size() == 45000);
+            CHECK(std::adjacent_find(samples.begin(), samples.end(), std::greater_equal<uint64_t>()) == samples.end());
+            for (auto value : samples)
+                CHECK(value % 2 == 1);
+
+            typedef konig::ComplementSampler<std::vector<uint64_t>> sampler_t;
+            CHECK(sampler_t::pays_off(45000, 100000, 50000));
+            CHECK(sampler_t::pays_off(18, 20, 0));
+            CHECK(!sampler_t::pays_off(5, 100000, 99990));
+            CHECK(!sampler_t::pays_off(1000, 100000000, 99998000));
+
+            std::vector<int> hits(20, 0);
+            const std::vector<uint64_t> none;
+            for (int i = 0; i < 20000; i++) {
+                konig::ComplementSampler<std::vector<uint64_t>> dense(18, 20, none, engine);
+                for (auto value : drain(dense))
+                    hits[value]++;
+            }
+            for (auto count : hits) {
+                CHECK(count > 17700);
+                CHECK(count < 18300);
+            }
+        }
+
+        SECTION("Exclusions from a structure") {
+            konig::AdjacencyManager AM;
+            konig::UndirectedRanks ranks(10);
+            for (konig::vid_t u = 1; u < 10; u++)
+                for (konig::vid_t v = 0; v < u; v++)
+                    if ((u + v) % 3)
+                        AM.insert({u, v});
+
+            konig::RankedExclusions<konig::AdjacencyManager, konig::UndirectedRanks> exclusions(AM, ranks);
+            const uint64_t missing = ranks.size() - AM.size();
+
+            konig::ExcludingSampler<decltype(exclusions)> sampler(missing, ranks.size(), exclusions, engine);
+            auto samples = drain(sampler);
+            CHECK(samples.size() == missing);
+            for (auto rank : samples) {
+                const auto adjacency = ranks.adjacency(rank);
+                CHECK((adjacency.first + adjacency.second) % 3 == 0);
+            }
+        }
+    }
+}
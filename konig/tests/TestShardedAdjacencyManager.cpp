@@ -0,0 +1,100 @@
+#include "Catch/single_include/catch.hpp"
+#include <random>
+#include <set>
+#include <thread>
+#include "../include/ShardedAdjacencyManager.hpp"
+
+namespace TestShardedAdjacencyManager {
+    using konig::adjacency_t;
+
+    TEST_CASE("ShardedAdjacencyManager", "[SAM]") {
+        konig::ShardedAdjacencyManager<> SAM(100, 7);
+        std::set<adjacency_t> reference;
+
+        SECTION("Shards") {
+            CHECK(SAM.shards_no() == 7);
+            CHECK(SAM.shard_of(0) == 0);
+            CHECK(SAM.shard_of(14) == 0);
+            CHECK(SAM.shard_of(15) == 1);
+            CHECK(SAM.shard_of(99) == 6);
+            CHECK(SAM.shard_of(1000) == 6);
+
+            CHECK(SAM.insert({20, 3}));
+            CHECK(!SAM.insert({20, 3}));
+            CHECK(SAM.shard(1).has({5, 3}));
+            CHECK(SAM.shard_begin(1) == 15);
+            CHECK_THROWS_AS(konig::ShardedAdjacencyManager<>(10, 0), konig::InvalidArgument);
+        }
+
+        SECTION("Order, rank and select") {
+            std::mt19937 generator(3);
+            std::vector<adjacency_t> batch;
+            for (int i = 0; i < 3000; i++)
+                batch.push_back({generator() % 120, generator() % 100});
+            SAM.insert(batch.begin(), batch.end(), 3);
+            reference.insert(batch.begin(), batch.end());
+
+            for (int i = 0; i < 500; i++) {
+                const adjacency_t adjacency(generator() % 100, generator() % 100);
+                SAM.erase(adjacency);
+                reference.erase(adjacency);
+            }
+
+            CHECK(SAM.size() == reference.size());
+            CHECK(std::vector<adjacency_t>(SAM.begin(), SAM.end()) ==
+                  std::vector<adjacency_t>(reference.begin(), reference.end()));
+
+            bool ranks_match = true;
+            size_t rank = 1;
+            for (const auto& adjacency : reference) {
+                ranks_match = ranks_match && *SAM.select(rank) == adjacency && SAM.rank(SAM.select(rank)) == rank;
+                ++rank;
+            }
+            CHECK(ranks_match);
+            CHECK(SAM.select(0) == SAM.end());
+            CHECK(SAM.select(reference.size() + 1) == SAM.end());
+            CHECK(SAM.rank(SAM.end()) == reference.size() + 1);
+
+            for (konig::vid_t u = 0; u < 120; u++)
+                CHECK(SAM.degree(u) == static_cast<size_t>(std::distance(reference.lower_bound({u, 0}),
+                                                                         reference.lower_bound({u + 1, 0}))));
+
+            const auto csr = SAM.to_csr(120);
+            CHECK(csr.vertices() == 120);
+            CHECK(csr.size() == reference.size());
+        }
+
+        SECTION("Empty shards") {
+            SAM.insert({99, 1});
+            SAM.insert({0, 1});
+            CHECK(std::vector<adjacency_t>(SAM.begin(), SAM.end()) == std::vector<adjacency_t>({{0, 1}, {99, 1}}));
+            SAM.erase({0, 1});
+            SAM.erase({99, 1});
+            CHECK(SAM.begin() == SAM.end());
+        }
+
+        SECTION("Concurrent insertions") {
+            std::vector<std::vector<adjacency_t>> work(4);
+            std::mt19937 generator(5);
+            for (auto& adjacencies : work)
+                for (int i = 0; i < 5000; i++) {
+                    adjacencies.push_back({generator() % 100, generator() % 100});
+                    reference.insert(adjacencies.back());
+                }
+
+            std::vector<std::thread> threads;
+            for (const auto& adjacencies : work)
+                threads.emplace_back([&SAM, &adjacencies]() {
+                    for (const auto& adjacency : adjacencies)
+                        SAM.insert(adjacency);
+                });
+            for (auto& thread : threads)
+                thread.join();
+
+            SAM.freeze();
+            CHECK(SAM.size() == reference.size());
+            CHECK(std::vector<adjacency_t>(SAM.begin(), SAM.end()) ==
+                  std::vector<adjacency_t>(reference.begin(), reference.end()));
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#include <sstream>
+#include <vector>
+#include "Catch/single_include/catch.hpp"
+#include "../include/AdjacencyTree.hpp"
+#include "../include/AdjacencyManager.hpp"
+
+namespace TestStatistics {
+    using namespace konig;
+
+    TEST_CASE("Tree statistics", "[TS]") {
+        AdjacencyTree AT;
+
+        SECTION("Sorted insertions") {
+            for (vid_t i = 0; i < 1000; i++)
+                AT.insert({i, i});
+
+            const auto& statistics = AT.statistics();
+            CHECK(statistics.calls[TreeStatistics::INSERT] == 1000);
+            CHECK(statistics.splays[TreeStatistics::INSERT] == 1000);
+            CHECK(statistics.allocations[TreeStatistics::INSERT] == 1000);
+            // every new maximum is attached to the right of the root, and then brought to the root with a single zig
+            CHECK(statistics.max_depth[TreeStatistics::INSERT] == 1);
+            CHECK(statistics.rotations[TreeStatistics::INSERT] == 999);
+
+            AT.insert({0, 0});
+            CHECK(statistics.calls[TreeStatistics::INSERT] == 1001);
+            CHECK(statistics.allocations[TreeStatistics::INSERT] == 1000);
+            CHECK(statistics.max_depth[TreeStatistics::INSERT] == 999);
+        }
+
+        SECTION("Attribution") {
+            std::vector<adjacency_t> batch;
+            for (vid_t i = 0; i < 100; i++)
+                batch.push_back({i, 0});
+            AT.insert(batch.begin(), batch.end());
+
+            const auto& statistics = AT.statistics();
+            CHECK(statistics.calls[TreeStatistics::BATCH_INSERT] == 1);
+            CHECK(statistics.allocations[TreeStatistics::BATCH_INSERT] == 100);
+            CHECK(statistics.splays[TreeStatistics::BATCH_INSERT] == 0);
+
+            CHECK(AT.has({5, 0}));
+            CHECK(!AT.has({5, 1}));
+            CHECK(statistics.calls[TreeStatistics::FIND] == 2);
+            CHECK(statistics.splays[TreeStatistics::FIND] == 2);
+
+            AT.erase(AT.find({7, 0}));
+            CHECK(statistics.calls[TreeStatistics::ERASE] == 1);
+            CHECK(statistics.splays[TreeStatistics::ERASE] >= 1);
+
+            auto it = AT.begin();
+            ++it;
+            CHECK(statistics.calls[TreeStatistics::ITERATE] == 0);
+            it += 10;
+            CHECK(statistics.calls[TreeStatistics::ITERATE] == 1);
+            CHECK(AT.rank(it) == 12);
+            CHECK(statistics.calls[TreeStatistics::RANK] == 1);
+            CHECK(statistics.calls[TreeStatistics::OTHER] == 0);
+
+            std::ostringstream dump;
+            dump << statistics;
+            CHECK(dump.str().find("batch_insert 1 0 0 0 0 100\n") != std::string::npos);
+            CHECK(dump.str().find("rank 1 ") != std::string::npos);
+
+            AT.reset_statistics();
+            CHECK(statistics.calls[TreeStatistics::FIND] == 0);
+            CHECK(statistics.allocations[TreeStatistics::BATCH_INSERT] == 0);
+        }
+
+        SECTION("Frozen queries") {
+            for (vid_t i = 0; i < 100; i++)
+                AT.insert({i, i});
+            AT.freeze();
+            AT.reset_statistics();
+
+            CHECK(AT.has({3, 3}));
+            CHECK(AT.rank(AT.select(5)) == 5);
+            CHECK(AT.end() - AT.begin() == 100);
+            auto it = AT.begin();
+            it += 10;
+            for (const auto calls : AT.statistics().calls)
+                CHECK(calls == 0);
+            CHECK(AT.statistics().splays[TreeStatistics::FIND] == 0);
+        }
+    }
+
+    TEST_CASE("Manager statistics", "[TS]") {
+        AdjacencyManager AM(10);
+        AM.insert({1, 2});
+        AM.insert({1, 3});
+
+        CHECK(AM.statistics().calls[TreeStatistics::INSERT] == 2);
+        CHECK(AM.statistics().allocations[TreeStatistics::INSERT] == 2);
+        AM.reset_statistics();
+        CHECK(AM.statistics().calls[TreeStatistics::INSERT] == 0);
+    }
+}
@@ -0,0 +1,89 @@
+#include <map>
+#include <vector>
+#include "Catch/single_include/catch.hpp"
+#include "../include/StructureManager.hpp"
+
+namespace TestStructureManager {
+
+    void check_aligned(konig::StructureManager<int>& SM, const std::map<konig::adjacency_t, int>& expected) {
+        REQUIRE(SM.size() == expected.size());
+        REQUIRE(SM.weights_data().size() == expected.size());
+
+        auto it = SM.begin();
+        size_t index = 0;
+        for (const auto& element : expected) {
+            REQUIRE(*it == element.first);
+            REQUIRE(SM.weights_data()[index] == element.second);
+            ++it;
+            ++index;
+        }
+    }
+
+    TEST_CASE("StructureManager", "[StructureManager]") {
+        konig::StructureManager<int> SM;
+        std::map<konig::adjacency_t, int> expected;
+
+        SECTION("Single operations") {
+            CHECK(SM.insert({2, 1}, 21).second);
+            CHECK(SM.insert({0, 5}, 5).second);
+            CHECK(SM.insert({2, 0}, 20).second);
+            CHECK(!SM.insert({2, 0}, 99).second);
+            expected = {{{0, 5}, 5}, {{2, 0}, 20}, {{2, 1}, 21}};
+            check_aligned(SM, expected);
+
+            CHECK(SM.weight({2, 1}) == 21);
+            CHECK(SM.weight(SM.find({0, 5})) == 5);
+            CHECK_THROWS_AS(SM.weight({1, 1}), konig::InvalidArgument);
+
+            SM.set_weight({2, 0}, 7);
+            SM.erase({0, 5});
+            SM.erase({3, 3});
+            expected = {{{2, 0}, 7}, {{2, 1}, 21}};
+            check_aligned(SM, expected);
+            CHECK(SM.degree(2) == 2);
+        }
+
+        SECTION("Batches") {
+            SM.insert({5, 5}, 55);
+            SM.insert({1, 1}, 11);
+
+            const std::vector<konig::adjacency_t> batch = {{3, 0}, {1, 1}, {0, 2}, {9, 9}, {3, 0}};
+            const std::vector<int> batch_weights = {30, -1, 2, 99, -2};
+            SM.insert(batch.begin(), batch.end(), batch_weights.begin());
+
+            expected = {{{0, 2}, 2}, {{1, 1}, 11}, {{3, 0}, 30}, {{5, 5}, 55}, {{9, 9}, 99}};
+            check_aligned(SM, expected);
+        }
+
+        SECTION("Random weights") {
+            konig::random::engine_t engine(4);
+            std::vector<konig::adjacency_t> batch;
+            for (konig::vid_t u = 0; u < 200; u++)
+                for (konig::vid_t v = 0; v < 20; v += 3)
+                    batch.push_back({u, v});
+
+            SM.insert(batch.begin(), batch.end(), engine, -5, 5);
+            REQUIRE(SM.size() == batch.size());
+            for (const int weight : SM.weights_data()) {
+                CHECK(weight >= -5);
+                CHECK(weight <= 5);
+            }
+
+            // Mixed single and batch operations keep the weights aligned
+            for (size_t i = 0; i < batch.size(); i++)
+                expected[batch[i]] = SM.weights_data()[i];
+            for (konig::vid_t u = 0; u < 200; u += 7) {
+                SM.insert({u, 1}, int(u));
+                expected[{u, 1}] = int(u);
+                SM.erase({u, 3});
+                expected.erase({u, 3});
+            }
+            check_aligned(SM, expected);
+
+            const auto csr = SM.to_csr(300);
+            CHECK(csr.vertices() == 300);
+            CHECK(csr.weight(csr.position({14, 1})) == 14);
+            CHECK(csr.weights_data() == SM.weights_data());
+        }
+    }
+}
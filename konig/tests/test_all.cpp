@@ -2,5 +2,22 @@
 #define KONIG_DEBUG
 
 #include "Catch/single_include/catch.hpp"
+#include "TestRandom.cpp"
+#include "TestPermutation.cpp"
+#include "TestNodePool.cpp"
 #include "TestAdjacencyTree.cpp"
-#include "TestAdjacencyManager.cpp"
\ No newline at end of file
+#include "TestAdjacencyBTree.cpp"
+#ifdef KONIG_STATISTICS
+#include "TestStatistics.cpp"
+#endif
+#include "TestAdjacencyManager.cpp"
+#include "TestShardedAdjacencyManager.cpp"
+#include "TestStructureManager.cpp"
+#include "TestDisjointSet.cpp"
+#include "TestCompressedSparseRow.cpp"
+#include "TestGraphWriter.cpp"
+#include "TestGraphFile.cpp"
+#include "TestExternalSorter.cpp"
+#include "TestGraph.cpp"
+#include "TestRangeSampler.cpp"
+#include "TestSequentialSampler.cpp"
\ No newline at end of file
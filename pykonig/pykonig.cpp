@@ -0,0 +1,969 @@
+#define PY_SSIZE_T_CLEAN
+#include "Python.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../konig/include/AdjacencyManager.hpp"
+#include "../konig/include/CompressedSparseRow.hpp"
+#include "../konig/include/DirectedGraph.hpp"
+#include "../konig/include/GraphWriter.hpp"
+#include "../konig/include/UndirectedGraph.hpp"
+
+/*
+ * Python bindings for the konig core.
+ *
+ * Edges cross the Python boundary in batches: they are read from any object exporting a C-contiguous buffer of
+ * uint32 (a NumPy array of shape (m, 2), an array.array('I'), a memoryview...) and exported as read-only buffers,
+ * viewed through memoryview without copies. Every call which may take long runs without the GIL, so that different
+ * objects can be worked on from parallel Python threads; an object used by a call that released the GIL refuses any
+ * other call until it is done.
+ */
+
+namespace {
+
+    //////////////////////////
+    // Error handling       //
+    //////////////////////////
+
+    /**
+     * set_python_error (function)
+     *
+     * This translates the exception being handled into a Python exception.
+     */
+    void set_python_error() {
+        try {
+            throw;
+        } catch (const konig::InvalidArgument& e) {
+            PyErr_SetString(PyExc_ValueError, e.what());
+        } catch (const konig::Exception& e) {
+            PyErr_SetString(PyExc_RuntimeError, e.what());
+        } catch (const std::bad_alloc&) {
+            PyErr_NoMemory();
+        } catch (const std::exception& e) {
+            PyErr_SetString(PyExc_RuntimeError, e.what());
+        }
+    }
+
+    /**
+     * CallGuard (type)
+     *
+     * This marks an object as busy for the duration of a call which releases the GIL.
+     */
+    class CallGuard {
+    private:
+        bool& busy;
+
+    public:
+        explicit CallGuard(bool& busy) : busy(busy) {
+            busy = true;
+        }
+
+        ~CallGuard() {
+            busy = false;
+        }
+    };
+
+    bool check_initialized(const void* const object) {
+        if (!object)
+            PyErr_SetString(PyExc_RuntimeError, "not initialized");
+        return object != NULL;
+    }
+
+    bool check_idle(const bool busy) {
+        if (busy)
+            PyErr_SetString(PyExc_RuntimeError, "the object is being used by another thread");
+        return !busy;
+    }
+
+    /**
+     * without_gil (function)
+     *
+     * This calls `function` with the GIL released, and translates the exceptions it throws. It returns false, with
+     * the Python exception set, if `function` failed.
+     */
+    template<typename function_t>
+    bool without_gil(bool& busy, function_t function) {
+        if (!check_idle(busy))
+            return false;
+
+        CallGuard guard(busy);
+        std::exception_ptr error;
+        Py_BEGIN_ALLOW_THREADS
+        try {
+            function();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        Py_END_ALLOW_THREADS
+
+        if (error) {
+            try {
+                std::rethrow_exception(error);
+            } catch (...) {
+                set_python_error();
+            }
+            return false;
+        }
+        return true;
+    }
+
+    //////////////////////////
+    // Buffers              //
+    //////////////////////////
+
+    bool is_uint32_format(const char* format) {
+        if (!format)
+            return false;
+        if (*format == '@' || *format == '=' || (*format == '<' && PY_LITTLE_ENDIAN) ||
+            (*format == '>' && !PY_LITTLE_ENDIAN))
+            ++format;
+        return (!std::strcmp(format, "I") && sizeof(unsigned int) == 4) ||
+               (!std::strcmp(format, "L") && sizeof(unsigned long) == 4);
+    }
+
+    /**
+     * read_adjacencies (function)
+     *
+     * This reads the adjacencies stored in `object`, which must export a C-contiguous buffer of uint32, either of
+     * shape (m, 2) or flat, with an even length.
+     */
+    bool read_adjacencies(PyObject* object, std::vector<konig::adjacency_t>& adjacencies) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(object, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0)
+            return false;
+
+        bool valid = is_uint32_format(view.format) && view.itemsize == 4;
+        if (view.ndim == 2)
+            valid = valid && view.shape[1] == 2;
+        else
+            valid = valid && view.ndim == 1 && view.shape[0] % 2 == 0;
+        if (!valid) {
+            PyBuffer_Release(&view);
+            PyErr_SetString(PyExc_ValueError, "expected a contiguous uint32 buffer of shape (m, 2)");
+            return false;
+        }
+
+        const uint32_t* const values = static_cast<const uint32_t*>(view.buf);
+        const size_t count = static_cast<size_t>(view.len / 8);
+        adjacencies.resize(count);
+        for (size_t i = 0; i < count; i++)
+            adjacencies[i] = konig::adjacency_t(values[2 * i], values[2 * i + 1]);
+
+        PyBuffer_Release(&view);
+        return true;
+    }
+
+    /*
+     * ArrayObject is a read-only buffer over memory owned by someone else (`owner`, kept alive by the array) or by the
+     * array itself (`storage`). It is only built by the module, and handed to Python wrapped in a memoryview.
+     */
+    struct ArrayObject {
+        PyObject_HEAD
+        PyObject* owner;
+        std::vector<uint32_t>* storage;
+        const void* data;
+        const char* format;
+        Py_ssize_t itemsize;
+        int ndim;
+        Py_ssize_t shape[2];
+        Py_ssize_t strides[2];
+    };
+
+    PyTypeObject* ArrayType = NULL;
+
+    void Array_dealloc(ArrayObject* self) {
+        Py_XDECREF(self->owner);
+        delete self->storage;
+        PyTypeObject* type = Py_TYPE(self);
+        type->tp_free(reinterpret_cast<PyObject*>(self));
+        Py_DECREF(type);
+    }
+
+    int Array_getbuffer(ArrayObject* self, Py_buffer* view, const int flags) {
+        if (flags & PyBUF_WRITABLE) {
+            PyErr_SetString(PyExc_BufferError, "konig arrays are read-only");
+            view->obj = NULL;
+            return -1;
+        }
+
+        Py_ssize_t items = 1;
+        for (int i = 0; i < self->ndim; i++)
+            items *= self->shape[i];
+
+        view->obj = reinterpret_cast<PyObject*>(self);
+        Py_INCREF(self);
+        view->buf = const_cast<void*>(self->data);
+        view->len = items * self->itemsize;
+        view->readonly = 1;
+        view->itemsize = self->itemsize;
+        view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(self->format) : NULL;
+        view->ndim = self->ndim;
+        view->shape = (flags & PyBUF_ND) ? self->shape : NULL;
+        view->strides = (flags & PyBUF_STRIDES) ? self->strides : NULL;
+        view->suboffsets = NULL;
+        view->internal = NULL;
+        return 0;
+    }
+
+    /**
+     * new_view (function)
+     *
+     * This returns a memoryview over `count` items (or `count` rows of two items, if `pairs` is true) of type `T`
+     * starting from `data`. The data must be owned by `owner` or, if `owner` is NULL, by `storage`.
+     */
+    template<typename T>
+    PyObject* new_view(PyObject* owner, std::vector<uint32_t>* storage, const T* data, const size_t count,
+                       const bool pairs = false) {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8, "unsupported item size");
+
+        ArrayObject* array = PyObject_New(ArrayObject, ArrayType);
+        if (!array) {
+            delete storage;
+            return NULL;
+        }
+
+        Py_XINCREF(owner);
+        array->owner = owner;
+        array->storage = storage;
+        array->data = data;
+        array->format = sizeof(T) == 4 ? "I" : "Q";
+        array->itemsize = sizeof(T);
+        array->ndim = pairs ? 2 : 1;
+        array->shape[0] = static_cast<Py_ssize_t>(count);
+        array->shape[1] = 2;
+        array->strides[0] = static_cast<Py_ssize_t>(sizeof(T) * (pairs ? 2 : 1));
+        array->strides[1] = sizeof(T);
+
+        PyObject* view = PyMemoryView_FromObject(reinterpret_cast<PyObject*>(array));
+        Py_DECREF(array);
+        return view;
+    }
+
+    /**
+     * new_adjacency_view (function)
+     *
+     * This copies the adjacencies in [first, last) into a new (m, 2) uint32 array, and returns a memoryview over it.
+     */
+    template<typename InputIt>
+    PyObject* new_adjacency_view(InputIt first, InputIt last, const size_t count) {
+        std::vector<uint32_t>* storage = new std::vector<uint32_t>();
+        storage->reserve(2 * count);
+        for (; first != last; ++first) {
+            storage->push_back(first->first);
+            storage->push_back(first->second);
+        }
+        return new_view<uint32_t>(NULL, storage, storage->data(), count, true);
+    }
+
+    PyType_Slot ArraySlots[] = {
+            {Py_tp_dealloc, reinterpret_cast<void*>(Array_dealloc)},
+            {Py_tp_doc, const_cast<char*>("Read-only buffer exported by konig.")},
+            {Py_bf_getbuffer, reinterpret_cast<void*>(Array_getbuffer)},
+            {0, NULL}
+    };
+
+    PyType_Spec ArraySpec = {
+            "pykonig.Array", sizeof(ArrayObject), 0, Py_TPFLAGS_DEFAULT, ArraySlots
+    };
+
+    //////////////////////////
+    // CompressedSparseRow  //
+    //////////////////////////
+
+    struct CompressedSparseRowObject {
+        PyObject_HEAD
+        konig::CompressedSparseRow* csr;
+    };
+
+    PyTypeObject* CompressedSparseRowType = NULL;
+
+    PyObject* new_csr(konig::CompressedSparseRow* csr) {
+        CompressedSparseRowObject* self = PyObject_New(CompressedSparseRowObject, CompressedSparseRowType);
+        if (!self) {
+            delete csr;
+            return NULL;
+        }
+        self->csr = csr;
+        return reinterpret_cast<PyObject*>(self);
+    }
+
+    void CompressedSparseRow_dealloc(CompressedSparseRowObject* self) {
+        delete self->csr;
+        PyTypeObject* type = Py_TYPE(self);
+        type->tp_free(reinterpret_cast<PyObject*>(self));
+        Py_DECREF(type);
+    }
+
+    Py_ssize_t CompressedSparseRow_len(CompressedSparseRowObject* self) {
+        return static_cast<Py_ssize_t>(self->csr->size());
+    }
+
+    PyObject* CompressedSparseRow_vertices(CompressedSparseRowObject* self, void*) {
+        return PyLong_FromSize_t(self->csr->vertices());
+    }
+
+    PyObject* CompressedSparseRow_offsets(CompressedSparseRowObject* self, void*) {
+        const auto& offsets = self->csr->offsets_data();
+        return new_view<size_t>(reinterpret_cast<PyObject*>(self), NULL, offsets.data(), offsets.size());
+    }
+
+    PyObject* CompressedSparseRow_targets(CompressedSparseRowObject* self, void*) {
+        const auto& targets = self->csr->targets_data();
+        return new_view<konig::vid_t>(reinterpret_cast<PyObject*>(self), NULL, targets.data(), targets.size());
+    }
+
+    PyObject* CompressedSparseRow_neighbours(CompressedSparseRowObject* self, PyObject* args) {
+        unsigned int vertex;
+        if (!PyArg_ParseTuple(args, "I", &vertex))
+            return NULL;
+        if (vertex >= self->csr->vertices()) {
+            PyErr_SetString(PyExc_IndexError, "the vertex does not belong to the graph");
+            return NULL;
+        }
+
+        const auto neighbours = self->csr->neighbours(vertex);
+        return new_view<konig::vid_t>(reinterpret_cast<PyObject*>(self), NULL, neighbours.begin(), neighbours.size());
+    }
+
+    PyObject* CompressedSparseRow_has(CompressedSparseRowObject* self, PyObject* args) {
+        unsigned int tail, head;
+        if (!PyArg_ParseTuple(args, "II", &tail, &head))
+            return NULL;
+        return PyBool_FromLong(self->csr->has({tail, head}));
+    }
+
+    PyMethodDef CompressedSparseRowMethods[] = {
+            {"neighbours", reinterpret_cast<PyCFunction>(CompressedSparseRow_neighbours), METH_VARARGS,
+                    "Return a memoryview over the neighbours of a vertex."},
+            {"has", reinterpret_cast<PyCFunction>(CompressedSparseRow_has), METH_VARARGS,
+                    "Check whether the snapshot contains the adjacency (tail, head)."},
+            {NULL, NULL, 0, NULL}
+    };
+
+    PyGetSetDef CompressedSparseRowGetSet[] = {
+            {const_cast<char*>("vertices"), reinterpret_cast<getter>(CompressedSparseRow_vertices), NULL,
+                    const_cast<char*>("Number of vertices."), NULL},
+            {const_cast<char*>("offsets"), reinterpret_cast<getter>(CompressedSparseRow_offsets), NULL,
+                    const_cast<char*>("memoryview over the offsets array (uint64)."), NULL},
+            {const_cast<char*>("targets"), reinterpret_cast<getter>(CompressedSparseRow_targets), NULL,
+                    const_cast<char*>("memoryview over the targets array (uint32)."), NULL},
+            {NULL, NULL, NULL, NULL, NULL}
+    };
+
+    PyType_Slot CompressedSparseRowSlots[] = {
+            {Py_tp_dealloc, reinterpret_cast<void*>(CompressedSparseRow_dealloc)},
+            {Py_tp_doc, const_cast<char*>("Read-only compressed sparse row snapshot of a set of adjacencies.")},
+            {Py_tp_methods, CompressedSparseRowMethods},
+            {Py_tp_getset, CompressedSparseRowGetSet},
+            {Py_sq_length, reinterpret_cast<void*>(CompressedSparseRow_len)},
+            {0, NULL}
+    };
+
+    PyType_Spec CompressedSparseRowSpec = {
+            "pykonig.CompressedSparseRow", sizeof(CompressedSparseRowObject), 0, Py_TPFLAGS_DEFAULT,
+            CompressedSparseRowSlots
+    };
+
+    //////////////////////////
+    // AdjacencyManager     //
+    //////////////////////////
+
+    struct AdjacencyManagerObject {
+        PyObject_HEAD
+        konig::AdjacencyManager* manager;
+        bool busy;
+    };
+
+    PyTypeObject* AdjacencyManagerType = NULL;
+
+    PyObject* AdjacencyManager_new(PyTypeObject* type, PyObject*, PyObject*) {
+        AdjacencyManagerObject* self = reinterpret_cast<AdjacencyManagerObject*>(type->tp_alloc(type, 0));
+        if (self) {
+            self->manager = NULL;
+            self->busy = false;
+        }
+        return reinterpret_cast<PyObject*>(self);
+    }
+
+    int AdjacencyManager_init(AdjacencyManagerObject* self, PyObject* args, PyObject*) {
+        Py_ssize_t vertices_no = 0;
+        if (!PyArg_ParseTuple(args, "|n", &vertices_no) || !check_idle(self->busy))
+            return -1;
+
+        try {
+            delete self->manager;
+            self->manager = NULL;
+            self->manager = new konig::AdjacencyManager(static_cast<size_t>(vertices_no));
+        } catch (...) {
+            set_python_error();
+            return -1;
+        }
+        return 0;
+    }
+
+    void AdjacencyManager_dealloc(AdjacencyManagerObject* self) {
+        delete self->manager;
+        PyTypeObject* type = Py_TYPE(self);
+        type->tp_free(reinterpret_cast<PyObject*>(self));
+        Py_DECREF(type);
+    }
+
+    Py_ssize_t AdjacencyManager_len(AdjacencyManagerObject* self) {
+        if (!check_idle(self->busy))
+            return -1;
+        return self->manager ? static_cast<Py_ssize_t>(self->manager->size()) : 0;
+    }
+
+    PyObject* AdjacencyManager_insert(AdjacencyManagerObject* self, PyObject* args) {
+        if (!check_initialized(self->manager))
+            return NULL;
+        PyObject* object;
+        std::vector<konig::adjacency_t> adjacencies;
+        if (!PyArg_ParseTuple(args, "O", &object) || !read_adjacencies(object, adjacencies))
+            return NULL;
+
+        konig::AdjacencyManager* manager = self->manager;
+        if (!without_gil(self->busy, [&]() { manager->insert(adjacencies.begin(), adjacencies.end()); }))
+            return NULL;
+        Py_RETURN_NONE;
+    }
+
+    PyObject* AdjacencyManager_has(AdjacencyManagerObject* self, PyObject* args) {
+        if (!check_initialized(self->manager))
+            return NULL;
+        unsigned int tail, head;
+        if (!PyArg_ParseTuple(args, "II", &tail, &head) || !check_idle(self->busy))
+            return NULL;
+        return PyBool_FromLong(self->manager->has({tail, head}));
+    }
+
+    PyObject* AdjacencyManager_degree(AdjacencyManagerObject* self, PyObject* args) {
+        if (!check_initialized(self->manager))
+            return NULL;
+        unsigned int vertex;
+        if (!PyArg_ParseTuple(args, "I", &vertex) || !check_idle(self->busy))
+            return NULL;
+        return PyLong_FromSize_t(self->manager->degree(vertex));
+    }
+
+    PyObject* AdjacencyManager_to_csr(AdjacencyManagerObject* self, PyObject* args) {
+        if (!check_initialized(self->manager))
+            return NULL;
+        Py_ssize_t vertices_no = 0;
+        if (!PyArg_ParseTuple(args, "|n", &vertices_no))
+            return NULL;
+
+        konig::CompressedSparseRow* csr = NULL;
+        konig::AdjacencyManager* manager = self->manager;
+        if (!without_gil(self->busy, [&]() {
+            csr = new konig::CompressedSparseRow(manager->to_csr(static_cast<size_t>(vertices_no)));
+        }))
+            return NULL;
+        return new_csr(csr);
+    }
+
+    PyObject* AdjacencyManager_adjacencies(AdjacencyManagerObject* self, PyObject*) {
+        if (!check_initialized(self->manager))
+            return NULL;
+        if (!check_idle(self->busy))
+            return NULL;
+        return new_adjacency_view(self->manager->begin(), self->manager->end(), self->manager->size());
+    }
+
+    PyMethodDef AdjacencyManagerMethods[] = {
+            {"insert", reinterpret_cast<PyCFunction>(AdjacencyManager_insert), METH_VARARGS,
+                    "Insert a batch of adjacencies, given as a uint32 buffer of shape (m, 2)."},
+            {"has", reinterpret_cast<PyCFunction>(AdjacencyManager_has), METH_VARARGS,
+                    "Check whether the adjacency (tail, head) is stored."},
+            {"degree", reinterpret_cast<PyCFunction>(AdjacencyManager_degree), METH_VARARGS,
+                    "Return the number of adjacencies having the given vertex as tail."},
+            {"to_csr", reinterpret_cast<PyCFunction>(AdjacencyManager_to_csr), METH_VARARGS,
+                    "Return a CompressedSparseRow snapshot with at least the given number of vertices."},
+            {"adjacencies", reinterpret_cast<PyCFunction>(AdjacencyManager_adjacencies), METH_NOARGS,
+                    "Return the sorted adjacencies as a memoryview of shape (m, 2)."},
+            {NULL, NULL, 0, NULL}
+    };
+
+    PyType_Slot AdjacencyManagerSlots[] = {
+            {Py_tp_new, reinterpret_cast<void*>(AdjacencyManager_new)},
+            {Py_tp_init, reinterpret_cast<void*>(AdjacencyManager_init)},
+            {Py_tp_dealloc, reinterpret_cast<void*>(AdjacencyManager_dealloc)},
+            {Py_tp_doc, const_cast<char*>("AdjacencyManager([vertices_no]): sorted set of adjacencies.")},
+            {Py_tp_methods, AdjacencyManagerMethods},
+            {Py_sq_length, reinterpret_cast<void*>(AdjacencyManager_len)},
+            {0, NULL}
+    };
+
+    PyType_Spec AdjacencyManagerSpec = {
+            "pykonig.AdjacencyManager", sizeof(AdjacencyManagerObject), 0, Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+            AdjacencyManagerSlots
+    };
+
+    //////////////////////////
+    // Graphs               //
+    //////////////////////////
+
+    /*
+     * GraphBinding<graph_t> holds the Python type wrapping the konig graph `graph_t`. The methods shared by all the
+     * graphs are written once as static members.
+     */
+    template<typename graph_t>
+    struct GraphBinding {
+        struct Object {
+            PyObject_HEAD
+            graph_t* graph;
+            bool busy;
+        };
+
+        static PyObject* create(PyTypeObject* type, PyObject*, PyObject*) {
+            Object* self = reinterpret_cast<Object*>(type->tp_alloc(type, 0));
+            if (self) {
+                self->graph = NULL;
+                self->busy = false;
+            }
+            return reinterpret_cast<PyObject*>(self);
+        }
+
+        static int init(Object* self, PyObject* args, PyObject*) {
+            Py_ssize_t vertices_no;
+            if (!PyArg_ParseTuple(args, "n", &vertices_no) || !check_idle(self->busy))
+                return -1;
+            if (vertices_no < 0) {
+                PyErr_SetString(PyExc_ValueError, "the number of vertices must be non-negative");
+                return -1;
+            }
+
+            try {
+                delete self->graph;
+                self->graph = NULL;
+                self->graph = new graph_t(static_cast<size_t>(vertices_no));
+            } catch (...) {
+                set_python_error();
+                return -1;
+            }
+            return 0;
+        }
+
+        static void dealloc(Object* self) {
+            delete self->graph;
+            PyTypeObject* type = Py_TYPE(self);
+            type->tp_free(reinterpret_cast<PyObject*>(self));
+            Py_DECREF(type);
+        }
+
+        static Py_ssize_t length(Object* self) {
+            if (!check_idle(self->busy))
+                return -1;
+            return self->graph ? static_cast<Py_ssize_t>(self->graph->edges()) : 0;
+        }
+
+        static PyObject* vertices(Object* self, void*) {
+            if (!check_idle(self->busy))
+                return NULL;
+            return PyLong_FromSize_t(self->graph ? self->graph->vertices() : 0);
+        }
+
+        /**
+         * with_engine (method)
+         *
+         * This calls `function(engine)` without the GIL, where `engine` is seeded with `seed` or, if it is None, is
+         * the engine of the calling thread.
+         */
+        template<typename function_t>
+        static bool with_engine(Object* self, PyObject* seed, function_t function) {
+            if (seed == Py_None) {
+                return without_gil(self->busy, [&]() { function(konig::random::engine()); });
+            }
+
+            const unsigned long long seed_value = PyLong_AsUnsignedLongLongMask(seed);
+            if (PyErr_Occurred())
+                return false;
+            return without_gil(self->busy, [&]() {
+                konig::random::engine_t engine(seed_value);
+                function(engine);
+            });
+        }
+
+        static PyObject* add_edge(Object* self, PyObject* args) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            unsigned int tail, head;
+            if (!PyArg_ParseTuple(args, "II", &tail, &head) || !check_idle(self->busy))
+                return NULL;
+            try {
+                self->graph->add_edge(tail, head);
+            } catch (...) {
+                set_python_error();
+                return NULL;
+            }
+            Py_RETURN_NONE;
+        }
+
+        static PyObject* add_edges(Object* self, PyObject* args, PyObject* kwds) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            static const char* keywords[] = {"edges", "seed", NULL};
+            PyObject* edges;
+            PyObject* seed = Py_None;
+            if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O", const_cast<char**>(keywords), &edges, &seed))
+                return NULL;
+
+            graph_t* graph = self->graph;
+            if (PyLong_Check(edges)) {
+                const size_t edges_no = PyLong_AsSize_t(edges);
+                if (PyErr_Occurred())
+                    return NULL;
+                if (!with_engine(self, seed, [&](konig::random::engine_t& engine) {
+                    graph->add_edges(edges_no, engine);
+                }))
+                    return NULL;
+                Py_RETURN_NONE;
+            }
+
+            std::vector<konig::adjacency_t> adjacencies;
+            if (!read_adjacencies(edges, adjacencies))
+                return NULL;
+            if (!without_gil(self->busy, [&]() { graph->add_edges(adjacencies.begin(), adjacencies.end()); }))
+                return NULL;
+            Py_RETURN_NONE;
+        }
+
+        static PyObject* build_forest(Object* self, PyObject* args, PyObject* kwds) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            static const char* keywords[] = {"edges", "seed", NULL};
+            Py_ssize_t edges_no;
+            PyObject* seed = Py_None;
+            if (!PyArg_ParseTupleAndKeywords(args, kwds, "n|O", const_cast<char**>(keywords), &edges_no, &seed))
+                return NULL;
+
+            graph_t* graph = self->graph;
+            if (!with_engine(self, seed, [&](konig::random::engine_t& engine) {
+                graph->build_forest(static_cast<size_t>(edges_no), engine);
+            }))
+                return NULL;
+            Py_RETURN_NONE;
+        }
+
+        static PyObject* build_tree(Object* self, PyObject* args, PyObject* kwds) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            static const char* keywords[] = {"seed", NULL};
+            PyObject* seed = Py_None;
+            if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", const_cast<char**>(keywords), &seed))
+                return NULL;
+
+            graph_t* graph = self->graph;
+            if (!with_engine(self, seed, [&](konig::random::engine_t& engine) { graph->build_tree(engine); }))
+                return NULL;
+            Py_RETURN_NONE;
+        }
+
+        static PyObject* connect(Object* self, PyObject* args, PyObject* kwds) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            static const char* keywords[] = {"seed", NULL};
+            PyObject* seed = Py_None;
+            if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", const_cast<char**>(keywords), &seed))
+                return NULL;
+
+            graph_t* graph = self->graph;
+            if (!with_engine(self, seed, [&](konig::random::engine_t& engine) { graph->connect(engine); }))
+                return NULL;
+            Py_RETURN_NONE;
+        }
+
+        template<typename method_t, method_t builder>
+        static PyObject* build(Object* self, PyObject*) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            graph_t* graph = self->graph;
+            if (!without_gil(self->busy, [&]() { (graph->*builder)(); }))
+                return NULL;
+            Py_RETURN_NONE;
+        }
+
+        /**
+         * combine (method)
+         *
+         * This calls the set operation `operation` of the graph with another graph of the same type, which is marked
+         * busy as well while it is read.
+         */
+        template<typename method_t, method_t operation>
+        static PyObject* combine(Object* self, PyObject* args) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            PyObject* argument;
+            if (!PyArg_ParseTuple(args, "O!", type, &argument))
+                return NULL;
+
+            Object* other = reinterpret_cast<Object*>(argument);
+            if (!check_initialized(other->graph))
+                return NULL;
+            graph_t* graph = self->graph;
+            if (other != self) {
+                if (!check_idle(other->busy))
+                    return NULL;
+                CallGuard guard(other->busy);
+                if (!without_gil(self->busy, [&]() { (graph->*operation)(*other->graph); }))
+                    return NULL;
+            } else if (!without_gil(self->busy, [&]() { (graph->*operation)(*graph); })) {
+                return NULL;
+            }
+            Py_RETURN_NONE;
+        }
+
+        static PyObject* has_edge(Object* self, PyObject* args) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            unsigned int tail, head;
+            if (!PyArg_ParseTuple(args, "II", &tail, &head) || !check_idle(self->busy))
+                return NULL;
+            return PyBool_FromLong(self->graph->has_edge(tail, head));
+        }
+
+        static PyObject* degree(Object* self, PyObject* args) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            unsigned int vertex;
+            if (!PyArg_ParseTuple(args, "I", &vertex))
+                return NULL;
+
+            size_t result = 0;
+            graph_t* graph = self->graph;
+            if (!without_gil(self->busy, [&]() { result = graph->degree(vertex); }))
+                return NULL;
+            return PyLong_FromSize_t(result);
+        }
+
+        static PyObject* edge_array(Object* self, PyObject*) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            if (!check_idle(self->busy))
+                return NULL;
+            const auto& storage = self->graph->adjacencies();
+            return new_adjacency_view(storage.begin(), storage.end(), storage.size());
+        }
+
+        static PyObject* to_csr(Object* self, PyObject*) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            konig::CompressedSparseRow* csr = NULL;
+            graph_t* graph = self->graph;
+            if (!without_gil(self->busy, [&]() { csr = new konig::CompressedSparseRow(graph->to_csr()); }))
+                return NULL;
+            return new_csr(csr);
+        }
+
+        static PyObject* neighbourhoods(Object* self, PyObject*) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            konig::CompressedSparseRow* csr = NULL;
+            graph_t* graph = self->graph;
+            if (!without_gil(self->busy, [&]() { csr = new konig::CompressedSparseRow(graph->neighbourhoods()); }))
+                return NULL;
+            return new_csr(csr);
+        }
+
+        static PyObject* write(Object* self, PyObject* args, PyObject* kwds) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            static const char* keywords[] = {"file", "seed", "threads", NULL};
+            PyObject* file;
+            PyObject* seed = Py_None;
+            unsigned int threads = 1;
+            if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OI", const_cast<char**>(keywords), &file, &seed, &threads))
+                return NULL;
+
+            const int fd = PyObject_AsFileDescriptor(file);
+            if (fd < 0)
+                return NULL;
+
+            // Python file objects may buffer data: flush them so that the output is not interleaved
+            if (!PyLong_Check(file)) {
+                PyObject* result = PyObject_CallMethod(file, "flush", NULL);
+                if (!result)
+                    return NULL;
+                Py_DECREF(result);
+            }
+
+            const bool shuffled = seed != Py_None;
+            const unsigned long long seed_value = shuffled ? PyLong_AsUnsignedLongLongMask(seed) : 0;
+            if (PyErr_Occurred())
+                return NULL;
+
+            graph_t* graph = self->graph;
+            if (!without_gil(self->busy, [&]() {
+                konig::GraphWriter writer(fd);
+                if (shuffled)
+                    graph->write_shuffled(writer, seed_value, threads);
+                else
+                    graph->write(writer, threads);
+                writer.flush();
+            }))
+                return NULL;
+            Py_RETURN_NONE;
+        }
+
+        static PyObject* str(Object* self) {
+            if (!check_initialized(self->graph))
+                return NULL;
+            std::string result;
+            graph_t* graph = self->graph;
+            if (!without_gil(self->busy, [&]() { result = graph->to_string(); }))
+                return NULL;
+            return PyUnicode_FromStringAndSize(result.data(), static_cast<Py_ssize_t>(result.size()));
+        }
+
+        static PyMethodDef methods[];
+        static PyGetSetDef getset[];
+        static PyType_Slot slots[];
+        static PyTypeObject* type;
+    };
+
+    // the builders are members of the Graph base class, so their type is not void (graph_t::*)()
+#define PYKONIG_BUILDER(name) build<decltype(&graph_t::name), &graph_t::name>
+#define PYKONIG_COMBINER(name) combine<decltype(&graph_t::name), &graph_t::name>
+
+    template<typename graph_t>
+    PyMethodDef GraphBinding<graph_t>::methods[] = {
+            {"add_edge", reinterpret_cast<PyCFunction>(add_edge), METH_VARARGS, "Add the edge (tail, head)."},
+            {"add_edges", reinterpret_cast<PyCFunction>(add_edges), METH_VARARGS | METH_KEYWORDS,
+                    "add_edges(edges, seed=None): add a batch of edges, given as a uint32 buffer of shape (m, 2), or "
+                    "the given number of random new edges."},
+            {"build_forest", reinterpret_cast<PyCFunction>(build_forest), METH_VARARGS | METH_KEYWORDS,
+                    "build_forest(edges, seed=None): add the edges of a random forest."},
+            {"build_tree", reinterpret_cast<PyCFunction>(build_tree), METH_VARARGS | METH_KEYWORDS,
+                    "build_tree(seed=None): add the edges of a random spanning tree."},
+            {"connect", reinterpret_cast<PyCFunction>(connect), METH_VARARGS | METH_KEYWORDS,
+                    "connect(seed=None): add the fewest random edges making the graph (strongly) connected."},
+            {"build_path", reinterpret_cast<PyCFunction>(PYKONIG_BUILDER(build_path)), METH_NOARGS,
+                    "Add the edges (i, i + 1)."},
+            {"build_cycle", reinterpret_cast<PyCFunction>(PYKONIG_BUILDER(build_cycle)), METH_NOARGS,
+                    "Add the edges (i, i + 1) and (n - 1, 0)."},
+            {"build_star", reinterpret_cast<PyCFunction>(PYKONIG_BUILDER(build_star)), METH_NOARGS,
+                    "Add the edges (0, i)."},
+            {"build_wheel", reinterpret_cast<PyCFunction>(PYKONIG_BUILDER(build_wheel)), METH_NOARGS,
+                    "Add the spokes (0, i) and the rim of a wheel."},
+            {"build_clique", reinterpret_cast<PyCFunction>(PYKONIG_BUILDER(build_clique)), METH_NOARGS,
+                    "Add the edges (i, j) for all i < j."},
+            {"complement", reinterpret_cast<PyCFunction>(PYKONIG_BUILDER(complement)), METH_NOARGS,
+                    "Replace the edges with the missing ones."},
+            {"unite", reinterpret_cast<PyCFunction>(PYKONIG_COMBINER(unite)), METH_VARARGS,
+                    "unite(other): add the edges of another graph of the same type."},
+            {"intersect", reinterpret_cast<PyCFunction>(PYKONIG_COMBINER(intersect)), METH_VARARGS,
+                    "intersect(other): keep only the edges which are also in another graph."},
+            {"subtract", reinterpret_cast<PyCFunction>(PYKONIG_COMBINER(subtract)), METH_VARARGS,
+                    "subtract(other): remove the edges which are in another graph."},
+            {"add_disjoint", reinterpret_cast<PyCFunction>(PYKONIG_COMBINER(add_disjoint)), METH_VARARGS,
+                    "add_disjoint(other): add a copy of another graph on new vertices, shifted by the current ones."},
+            {"cartesian_product", reinterpret_cast<PyCFunction>(PYKONIG_COMBINER(cartesian_product)), METH_VARARGS,
+                    "cartesian_product(other): replace the graph with its Cartesian product with another graph, "
+                    "vertex (i, j) being j * vertices + i."},
+            {"has_edge", reinterpret_cast<PyCFunction>(has_edge), METH_VARARGS,
+                    "Check whether the edge (tail, head) is in the graph."},
+            {"degree", reinterpret_cast<PyCFunction>(degree), METH_VARARGS, "Return the degree of a vertex."},
+            {"edge_array", reinterpret_cast<PyCFunction>(edge_array), METH_NOARGS,
+                    "Return the edges as a sorted memoryview of shape (m, 2)."},
+            {"to_csr", reinterpret_cast<PyCFunction>(to_csr), METH_NOARGS,
+                    "Return a CompressedSparseRow snapshot of the edges."},
+            {"neighbourhoods", reinterpret_cast<PyCFunction>(neighbourhoods), METH_NOARGS,
+                    "Return the neighbourhoods of all the vertices as a CompressedSparseRow."},
+            {"write", reinterpret_cast<PyCFunction>(write), METH_VARARGS | METH_KEYWORDS,
+                    "write(file, seed=None, threads=1): write the graph to a file object or descriptor, shuffling "
+                    "the edges if a seed is given."},
+            {NULL, NULL, 0, NULL}
+    };
+
+#undef PYKONIG_BUILDER
+#undef PYKONIG_COMBINER
+
+    template<typename graph_t>
+    PyGetSetDef GraphBinding<graph_t>::getset[] = {
+            {const_cast<char*>("vertices"), reinterpret_cast<getter>(vertices), NULL,
+                    const_cast<char*>("Number of vertices."), NULL},
+            {NULL, NULL, NULL, NULL, NULL}
+    };
+
+    template<typename graph_t>
+    PyType_Slot GraphBinding<graph_t>::slots[] = {
+            {Py_tp_new, reinterpret_cast<void*>(create)},
+            {Py_tp_init, reinterpret_cast<void*>(init)},
+            {Py_tp_dealloc, reinterpret_cast<void*>(dealloc)},
+            {Py_tp_str, reinterpret_cast<void*>(str)},
+            {Py_tp_methods, methods},
+            {Py_tp_getset, getset},
+            {Py_sq_length, reinterpret_cast<void*>(length)},
+            {0, NULL}
+    };
+
+    template<typename graph_t>
+    PyTypeObject* GraphBinding<graph_t>::type = NULL;
+
+    typedef GraphBinding<konig::UndirectedGraph<>> UndirectedGraphBinding;
+    typedef GraphBinding<konig::DirectedGraph<>> DirectedGraphBinding;
+
+    PyType_Spec UndirectedGraphSpec = {
+            "pykonig.UndirectedGraph", sizeof(UndirectedGraphBinding::Object), 0,
+            Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, UndirectedGraphBinding::slots
+    };
+
+    PyType_Spec DirectedGraphSpec = {
+            "pykonig.DirectedGraph", sizeof(DirectedGraphBinding::Object), 0,
+            Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, DirectedGraphBinding::slots
+    };
+
+    //////////////////////////
+    // Module               //
+    //////////////////////////
+
+    PyObject* pykonig_seed(PyObject*, PyObject* args) {
+        unsigned long long seed;
+        if (!PyArg_ParseTuple(args, "K", &seed))
+            return NULL;
+        konig::random::seed(seed);
+        Py_RETURN_NONE;
+    }
+
+    PyMethodDef pykonig_methods[] = {
+            {"seed", pykonig_seed, METH_VARARGS,
+                    "Set the master seed of the engines used when no seed is given."},
+            {NULL, NULL, 0, NULL}
+    };
+
+    PyModuleDef pykonig_module = {
+            PyModuleDef_HEAD_INIT, "pykonig", "Python bindings for the konig graph generator.", -1, pykonig_methods,
+            NULL, NULL, NULL, NULL
+    };
+
+    bool add_type(PyObject* module, PyType_Spec& spec, PyTypeObject*& type) {
+        type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&spec));
+        if (!type)
+            return false;
+
+        Py_INCREF(type);
+        const char* name = std::strchr(spec.name, '.') + 1;
+        if (PyModule_AddObject(module, name, reinterpret_cast<PyObject*>(type)) < 0) {
+            Py_DECREF(type);
+            return false;
+        }
+        return true;
+    }
+}
+
+PyMODINIT_FUNC PyInit_pykonig(void) {
+    PyObject* module = PyModule_Create(&pykonig_module);
+    if (!module)
+        return NULL;
+
+    if (!add_type(module, ArraySpec, ArrayType) ||
+        !add_type(module, CompressedSparseRowSpec, CompressedSparseRowType) ||
+        !add_type(module, AdjacencyManagerSpec, AdjacencyManagerType) ||
+        !add_type(module, UndirectedGraphSpec, UndirectedGraphBinding::type) ||
+        !add_type(module, DirectedGraphSpec, DirectedGraphBinding::type)) {
+        Py_DECREF(module);
+        return NULL;
+    }
+    return module;
+}
@@ -1,30 +1,178 @@
-#!/usr/bin/env python2
-import graphgen
-
-graphgen.srand(1)
-
-# testing RangeSampler
-print "OK"
-RS = graphgen.RangeSampler(20, 0, 100)
-for i in RS:
-    print i,
-print
-
-# testing DSU
-sets = graphgen.DisjointSet(100)
-last = 0
-for i in RS:
-    sets.merge(last, i)
-    last = i
-print " ".join(map(str, [sets.find(i) for i in xrange(100)]))
+#!/usr/bin/env python3
+import array
+import os
+import tempfile
+import threading
+
+import pykonig
+
+pykonig.seed(1)
+
+
+def pairs(edges):
+    """Return a (m, 2) uint32 buffer with the given edges (any NumPy array of that shape is accepted as well)."""
+    flat = array.array('I', [x for edge in edges for x in edge])
+    return memoryview(flat).cast('B').cast('I', (len(edges), 2))
+
+
+# testing AdjacencyManager
+manager = pykonig.AdjacencyManager(10)
+manager.insert(pairs([(3, 1), (0, 2), (3, 1), (5, 4)]))
+manager.insert(array.array('I', [0, 1, 9, 9]))
+assert len(manager) == 5
+assert manager.has(3, 1) and not manager.has(1, 3)
+assert manager.degree(0) == 2
+assert manager.adjacencies().tolist() == [[0, 1], [0, 2], [3, 1], [5, 4], [9, 9]]
+
+csr = manager.to_csr()
+assert csr.vertices == 10 and len(csr) == 5
+assert csr.offsets.format == 'Q' and csr.targets.format == 'I'
+assert csr.offsets.tolist() == [0, 2, 2, 2, 3, 3, 4, 4, 4, 4, 5]
+assert csr.targets.tolist() == [1, 2, 1, 4, 9]
+assert csr.neighbours(0).tolist() == [1, 2]
+assert csr.has(5, 4)
+
+try:
+    manager.insert(array.array('i', [0, 1]))
+    assert False
+except ValueError:
+    pass
+try:
+    manager.insert(array.array('I', [0, 1, 2]))
+    assert False
+except ValueError:
+    pass
+
+# the views are read-only and keep their owner alive
+targets = csr.targets
+del csr
+assert targets.readonly and targets.tolist() == [1, 2, 1, 4, 9]
 
 # testing UndirectedGraph
-g = graphgen.UndirectedGraph(10)
-g.add_edges(20)
-g.connect()
-print g
+g = pykonig.UndirectedGraph(10)
+g.add_edges(pairs([(0, 1), (2, 1), (1, 2)]))
+g.add_edge(9, 8)
+assert len(g) == 3 and g.vertices == 10
+assert g.has_edge(1, 2) and g.has_edge(2, 1) and not g.has_edge(0, 2)
+assert g.degree(1) == 2
+assert g.edge_array().shape == (3, 2)
+assert g.neighbourhoods().neighbours(1).tolist() == [0, 2]
+try:
+    g.add_edge(3, 3)
+    assert False
+except ValueError:
+    pass
+try:
+    g.add_edge(0, 10)
+    assert False
+except ValueError:
+    pass
+
+g.add_edges(20, seed=42)
+assert len(g) == 23
+
+tree = pykonig.UndirectedGraph(100)
+tree.build_tree(seed=7)
+assert len(tree) == 99
+same = pykonig.UndirectedGraph(100)
+same.build_tree(seed=7)
+assert tree.edge_array().tolist() == same.edge_array().tolist()
+
+lines = str(tree).splitlines()
+assert lines[0] == "100 99" and len(lines) == 100
+
+with tempfile.TemporaryFile('w+') as output:
+    tree.write(output, seed=3)
+    output.seek(0)
+    written = output.read().splitlines()
+assert written[0] == "100 99" and sorted(written[1:]) == sorted(lines[1:])
 
 # testing DirectedGraph
-g = graphgen.DirectedGraph(5)
-g.add_edges(20)
-print g
+d = pykonig.DirectedGraph(5)
+d.build_cycle()
+assert len(d) == 5 and d.has_edge(4, 0) and not d.has_edge(0, 4)
+csr = d.to_csr()
+assert csr.offsets.tolist() == [0, 1, 2, 3, 4, 5]
+
+# connect adds the fewest edges: 2 for the undirected forest, max(sources, sinks) = 3 for the out-star
+forest = pykonig.UndirectedGraph(6)
+forest.add_edges(pairs([(0, 1), (2, 3)]))
+forest.connect(seed=1)
+assert len(forest) == 5
+star = pykonig.DirectedGraph(4)
+star.add_edges(pairs([(0, 1), (0, 2), (0, 3)]))
+star.connect(seed=1)
+assert len(star) == 6
+
+# set operations between graphs of the same type
+a = pykonig.UndirectedGraph(4)
+a.build_path()
+b = pykonig.UndirectedGraph(4)
+b.build_star()
+a.unite(b)
+assert len(a) == 5 and a.has_edge(0, 3)
+a.intersect(b)
+assert len(a) == 3
+a.subtract(b)
+assert len(a) == 0
+a.complement()
+assert len(a) == 6
+grid = pykonig.UndirectedGraph(3)
+grid.build_path()
+grid.cartesian_product(grid)
+assert grid.vertices == 9 and len(grid) == 12
+grid.add_disjoint(b)
+assert grid.vertices == 13 and grid.has_edge(9, 12)
+try:
+    grid.unite(pykonig.DirectedGraph(3))
+    assert False
+except TypeError:
+    pass
+
+# objects whose __init__ was skipped raise instead of crashing
+class Lazy(pykonig.UndirectedGraph):
+    def __init__(self):
+        pass
+
+uninitialized = [pykonig.UndirectedGraph.__new__(pykonig.UndirectedGraph), Lazy(),
+                 pykonig.AdjacencyManager.__new__(pykonig.AdjacencyManager)]
+calls = [lambda g: g.add_edge(0, 1), lambda g: g.add_edges(1), lambda g: g.build_path(), lambda g: g.has_edge(0, 1),
+         lambda g: g.degree(0), lambda g: g.to_csr(), lambda g: str(g), lambda g: g.unite(b),
+         lambda g: b.unite(g)]
+manager_calls = [lambda m: m.has(0, 1), lambda m: m.degree(0), lambda m: m.to_csr(), lambda m: m.adjacencies()]
+for obj in uninitialized:
+    for call in (manager_calls if isinstance(obj, pykonig.AdjacencyManager) else calls):
+        try:
+            call(obj)
+            assert False
+        except RuntimeError:
+            pass
+assert len(uninitialized[0]) == 0
+
+# heavy calls release the GIL: several graphs can be generated from parallel threads
+graphs = [pykonig.UndirectedGraph(2000) for _ in range(4)]
+threads = [threading.Thread(target=graph.add_edges, args=(20000,), kwargs={'seed': i})
+           for i, graph in enumerate(graphs)]
+for thread in threads:
+    thread.start()
+for thread in threads:
+    thread.join()
+assert all(len(graph) == 20000 for graph in graphs)
+
+# while a call runs without the GIL, the other calls on the same object refuse to run
+big = pykonig.UndirectedGraph(100000)
+worker = threading.Thread(target=big.add_edges, args=(300000,), kwargs={'seed': 1})
+worker.start()
+refused = set()
+while worker.is_alive():
+    for name, call in (("len", lambda: len(big)), ("vertices", lambda: big.vertices),
+                       ("has_edge", lambda: big.has_edge(0, 1))):
+        try:
+            call()
+        except RuntimeError:
+            refused.add(name)
+worker.join()
+assert len(big) == 300000 and big.vertices == 100000
+assert refused == {"len", "vertices", "has_edge"}  # add_edges runs long enough for all of them to be refused
+
+print("OK")
@@ -1,4 +1,4 @@
-#!/usr/bin/env python2
+#!/usr/bin/env python3
 # -*- coding: utf-8 -*-
 #
 # graph-gen - https://github.com/olimpiadi-informatica/graph-gen
@@ -19,17 +19,14 @@
 
 import os
 import glob
-from distutils.core import setup, Extension
+from setuptools import setup, Extension
 
 
-module = Extension('graphgen', sources = ['graphgen.cpp'])
-module.extra_compile_args = ['--std=c++11', '-Wall', '-pedantic', '-g'];
+module = Extension('pykonig', sources = [os.path.join('pykonig', 'pykonig.cpp')],
+                   include_dirs = [os.path.join('konig', 'include')])
+module.extra_compile_args = ['--std=c++11', '-Wall', '-pedantic', '-O2']
 
-headers_path = os.path.join("include", "graphgen")
-
-headers = [(headers_path, ["graphgen.hpp"])]
-
-headers += [(os.path.join(headers_path, "cpp-btree"), glob.glob("cpp-btree/*h"))]
+headers = [(os.path.join("include", "konig"), glob.glob(os.path.join("konig", "include", "*.hpp")))]
 
 setup(
     name = 'graph-gen',
@@ -45,7 +42,7 @@ setup(
         "Development Status :: 3 - Alpha",
         "Natural Language :: English",
         "Operating System :: OS Independent",
-        "Programming Language :: Python :: 2",
+        "Programming Language :: Python :: 3",
         "License :: OSI Approved :: Apache Software License",
     ]
 )